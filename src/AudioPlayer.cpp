@@ -21,11 +21,13 @@
 #include <iostream>
 #include <memory>
 #include <thread>
+#include <utility> /* move */
 
 #include "Exception.h"
 #include "JackClient.h"
 #include "JackConfig.h"
 #include "Log.h"
+#include "Trace.h"
 
 
 
@@ -42,6 +44,7 @@ extern "C" {
 int
 player_jack_process_callback(jack_nframes_t nframes, void* arg)
 {
+	TraceSpan span("player_jack_process", "jack");
 	return static_cast<AudioPlayer*>(arg)->callback(nframes);
 }
 
@@ -67,7 +70,9 @@ namespace GS {
 
 AudioPlayer::AudioPlayer()
 		: bufferIndex_()
+		, playbackPosition_()
 		, jackOutputPort_()
+		, startupTime_()
 {
 }
 
@@ -76,7 +81,10 @@ AudioPlayer::play(double sampleRate)
 {
 	std::lock_guard<std::mutex> lock(bufferMutex_);
 
+	const auto startTime = std::chrono::steady_clock::now();
+	startupTime_ = 0.0;
 	bufferIndex_ = 0;
+	playbackPosition_ = 0;
 	playback_finished_ = false;
 
 	auto jackClient = std::make_unique<JackClient>(JackConfig::clientNamePlayer().c_str());
@@ -107,6 +115,7 @@ AudioPlayer::play(double sampleRate)
 	for (std::size_t i = 0; i < 2 && ports.list[i]; ++i) {
 		jackClient->connect(JackClient::portName(jackOutputPort_), ports.list[i]);
 	}
+	startupTime_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
 
 	do {
 		std::this_thread::sleep_for(std::chrono::milliseconds(200));
@@ -115,11 +124,12 @@ AudioPlayer::play(double sampleRate)
 }
 
 void
-AudioPlayer::copyBuffer(std::vector<float>& out)
+AudioPlayer::setBuffer(std::shared_ptr<const std::vector<float>> buffer)
 {
 	std::lock_guard<std::mutex> lock(bufferMutex_);
 
-	out = buffer_;
+	buffer_ = std::move(buffer);
+	playbackPosition_ = 0;
 }
 
 int
@@ -129,10 +139,11 @@ AudioPlayer::callback(jack_nframes_t nframes)
 	jack_default_audio_sample_t* out =
 		static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer(jackOutputPort_, nframes));
 
+	// The buffer is not replaced during the playback.
 	std::size_t outIndex = 0;
-	const std::size_t bufferSize = buffer_.size();
+	const std::size_t bufferSize = buffer_ ? buffer_->size() : 0;
 	while (bufferIndex_ < bufferSize && outIndex < nframes) {
-		out[outIndex] = buffer_[bufferIndex_];
+		out[outIndex] = (*buffer_)[bufferIndex_];
 		++bufferIndex_;
 		++outIndex;
 	}
@@ -140,6 +151,7 @@ AudioPlayer::callback(jack_nframes_t nframes)
 		out[outIndex] = 0.0;
 		++outIndex;
 	}
+	playbackPosition_.store(bufferIndex_, std::memory_order_relaxed);
 	if (bufferIndex_ == bufferSize) {
 		// Using this flag because with Pipewire 0.3.65 the "return 1" does not deactivate the client.
 		playback_finished_.store(true, std::memory_order_release);
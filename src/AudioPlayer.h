@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <cstddef> /* std::size_t */
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -39,31 +40,25 @@ public:
 	void stop(); // must be called only by the shutdown callback
 
 	// These functions can be called by the main thread.
-	template<typename T> void fillBuffer(T f);
+	void setBuffer(std::shared_ptr<const std::vector<float>> buffer); // will block during the playback
 	void play(double sampleRate); // will block until the end of the playback
-	void copyBuffer(std::vector<float>& out);
+	std::size_t playbackPosition() const { return playbackPosition_.load(std::memory_order_relaxed); } // samples
+	double startupTime() const { return startupTime_; } // s - JACK setup in the last call to play()
 private:
 	AudioPlayer(const AudioPlayer&) = delete;
 	AudioPlayer& operator=(const AudioPlayer&) = delete;
 	AudioPlayer(AudioPlayer&&) = delete;
 	AudioPlayer& operator=(AudioPlayer&&) = delete;
 
-	std::vector<float> buffer_;
+	std::shared_ptr<const std::vector<float>> buffer_; // may be shared with the owner of the audio
 	std::size_t bufferIndex_;
+	std::atomic<std::size_t> playbackPosition_; // copy of bufferIndex_ that can be read during the playback
 	std::mutex bufferMutex_;
 	std::atomic<jack_port_t*> jackOutputPort_;
 	std::atomic_bool playback_finished_;
+	double startupTime_;
 };
 
-template<typename T>
-void
-AudioPlayer::fillBuffer(T f)
-{
-	std::lock_guard<std::mutex> lock(bufferMutex_);
-
-	f(buffer_);
-}
-
 } // namespace GS
 
 #endif // AUDIO_PLAYER_H
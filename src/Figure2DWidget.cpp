@@ -17,8 +17,10 @@
 
 #include "Figure2DWidget.h"
 
-#include <algorithm> /* max_element, min_element */
+#include <algorithm> /* is_sorted, lower_bound, minmax_element, upper_bound */
+#include <atomic>
 #include <cmath> /* abs, ceil, floor, log10, max, min, pow */
+#include <iostream>
 
 #include <QCursor>
 #include <QMouseEvent>
@@ -26,6 +28,8 @@
 #include <QPoint>
 #include <QRectF>
 
+#include "Trace.h"
+
 namespace {
 
 constexpr int SPACING = 3;
@@ -34,6 +38,7 @@ constexpr int TICK_SIZE = 3;
 constexpr int MIN_AXIS_DIV = 4;
 constexpr int MIN_X_TICKS_MARGIN = 6;
 constexpr unsigned int MAX_X_LIST_SIZE_WITH_MARKER = 1000;
+constexpr unsigned int MAX_POINTS_PER_COLUMN = 4;
 constexpr double WHEEL_ZOOM_FACTOR = 0.01;
 constexpr double MOUSE_ZOOM_FACTOR = 0.002;
 constexpr double DEFAULT_Y_DELTA = 1.0;
@@ -46,10 +51,69 @@ constexpr double EPS = 1.0e-5;
 constexpr double MAX_TICK_POW = 2.0;
 constexpr double MIN_TICK_POW = -2.0;
 
+std::atomic<unsigned long> nextSeriesVersion{1};
+
 }
 
 namespace Lab {
 
+std::shared_ptr<const Figure2DSeries>
+Figure2DSeries::create(Buffer x, Buffer y, std::size_t size)
+{
+	std::shared_ptr<Figure2DSeries> series = createWithXRange(std::move(x), std::move(y), size);
+	if (!series) return nullptr;
+
+	const auto yBegin = series->y_->begin();
+	const auto [yMin, yMax] = std::minmax_element(yBegin, yBegin + series->size_);
+	series->yMin_ = *yMin;
+	series->yMax_ = *yMax;
+	return series;
+}
+
+std::shared_ptr<const Figure2DSeries>
+Figure2DSeries::create(Buffer x, Buffer y, std::size_t size, float yMin, float yMax)
+{
+	std::shared_ptr<Figure2DSeries> series = createWithXRange(std::move(x), std::move(y), size);
+	if (!series) return nullptr;
+
+	series->yMin_ = yMin;
+	series->yMax_ = yMax;
+	return series;
+}
+
+std::shared_ptr<Figure2DSeries>
+Figure2DSeries::createWithXRange(Buffer x, Buffer y, std::size_t size)
+{
+	if (!x || !y || x->size() != y->size()) {
+		std::cerr << "[Figure2DSeries::create] Arrays x and y with different sizes." << std::endl;
+		return nullptr;
+	}
+	if (size < 2U || size > x->size()) {
+		size = x->size();
+	}
+	if (size < 2U) {
+		std::cerr << "[Figure2DSeries::create] Arrays x and y are too small." << std::endl;
+		return nullptr;
+	}
+
+	std::shared_ptr<Figure2DSeries> series(new Figure2DSeries);
+	const auto xEnd = x->begin() + size;
+	series->xSorted_ = std::is_sorted(x->begin(), xEnd);
+	if (series->xSorted_) {
+		series->xMin_ = x->front();
+		series->xMax_ = *(xEnd - 1);
+	} else {
+		const auto [xMin, xMax] = std::minmax_element(x->begin(), xEnd);
+		series->xMin_ = *xMin;
+		series->xMax_ = *xMax;
+	}
+	series->x_ = std::move(x);
+	series->y_ = std::move(y);
+	series->size_ = size;
+	series->version_ = nextSeriesVersion++;
+	return series;
+}
+
 Figure2DWidget::Figure2DWidget(QWidget* parent)
 		: QWidget(parent)
 		, figureChanged_()
@@ -58,6 +122,7 @@ Figure2DWidget::Figure2DWidget(QWidget* parent)
 		, expandAxisTicks_(true)
 		, symmetricYRange_()
 		, reduceYRange_(true)
+		, decimation_(true)
 		, leftMargin_()
 		, rightMargin_()
 		, topMargin_()
@@ -100,8 +165,10 @@ Figure2DWidget::Figure2DWidget(QWidget* parent)
 void
 Figure2DWidget::paintEvent(QPaintEvent* /*event*/)
 {
-	if (xList_.empty() || xTicks_.size() < 2 || yTicks_.size() < 2) return;
-	if (xList_.size() > MAX_X_LIST_SIZE_WITH_MARKER) drawPointMarker_ = false;
+	TraceSpan span("Figure2DWidget::paintEvent", "paint");
+
+	if (!series_ || xTicks_.size() < 2 || yTicks_.size() < 2) return;
+	if (series_->size() > MAX_X_LIST_SIZE_WITH_MARKER) drawPointMarker_ = false;
 
 	QPainter painter(this);
 #ifdef _MSC_VER
@@ -231,11 +298,11 @@ Figure2DWidget::paintEvent(QPaintEvent* /*event*/)
 	}
 
 	// Cursor.
-	if (xCursorIndex_ >= 0 && static_cast<unsigned int>(xCursorIndex_) < xList_.size()) {
+	if (xCursorIndex_ >= 0 && static_cast<unsigned int>(xCursorIndex_) < series_->size()) {
 		QPen cursorPen;
 		cursorPen.setColor(Qt::red);
 		painter.setPen(cursorPen);
-		const double x = uBegin + (xList_[xCursorIndex_] - xBegin_) * xScale_;
+		const double x = uBegin + (series_->x()[xCursorIndex_] - xBegin_) * xScale_;
 		if (x >= uBegin && x <= uEnd) {
 			painter.drawLine(QPointF(x, vBegin), QPointF(x, vEnd));
 		}
@@ -250,71 +317,95 @@ Figure2DWidget::paintEvent(QPaintEvent* /*event*/)
 	// Draw curve.
 	painter.setClipRect(uBegin, vEnd, mainAreaWidth_, mainAreaHeight_);
 	painter.setPen(pen2);
-	if (drawCurveLines_) {
-		QPointF prevPoint(
-				0.5 + uBegin + (xList_[0] - xBegin_) * xScale_,
-				0.5 + vBegin + (yList_[0] - yBegin_) * yScale_);
-		if (drawPointMarker_) {
-			painter.drawEllipse(prevPoint, MARKER_SIZE, MARKER_SIZE);
-		}
-		for (unsigned int i = 1, size = xList_.size(); i < size; ++i) {
-			QPointF currPoint(
-				0.5 + uBegin + (xList_[i] - xBegin_) * xScale_,
-				0.5 + vBegin + (yList_[i] - yBegin_) * yScale_);
-			painter.drawLine(prevPoint, currPoint);
-			if (drawPointMarker_) {
-				painter.drawEllipse(currPoint, MARKER_SIZE, MARKER_SIZE);
-			}
-			prevPoint = currPoint;
-		}
-	} else {
-		for (unsigned int i = 0, size = xList_.size(); i < size; ++i) {
-			QPointF currPoint(
-				0.5 + uBegin + (xList_[i] - xBegin_) * xScale_,
-				0.5 + vBegin + (yList_[i] - yBegin_) * yScale_);
-			painter.drawEllipse(currPoint, POINT_MARKER_SIZE, POINT_MARKER_SIZE);
-		}
-	}
+	drawCurve(painter, *series_, uBegin, vBegin);
 	// Draw curve 2.
-	if (!x2List_.empty()) {
+	if (series2_) {
 		QPen pen3;
 		pen3.setColor(Qt::blue);
 		pen3.setWidth(2);
 		painter.setPen(pen3);
-		if (drawCurveLines_) {
-			QPointF prevPoint(
-					0.5 + uBegin + (x2List_[0] - xBegin_) * xScale_,
-					0.5 + vBegin + (y2List_[0] - yBegin_) * yScale_);
-			if (drawPointMarker_) {
-				painter.drawEllipse(prevPoint, MARKER_SIZE, MARKER_SIZE);
+		drawCurve(painter, *series2_, uBegin, vBegin);
+	}
+
+	painter.setClipping(false);
+}
+
+// If the x values are sorted, only the visible part of the curve is drawn,
+// and when there are many points per pixel column, the curve is reduced
+// to the first, minimum, maximum and last points of each column.
+// The result is drawn with one call to drawPolyline().
+void
+Figure2DWidget::drawCurve(QPainter& painter, const Figure2DSeries& series, double uBegin, double vBegin)
+{
+	const std::vector<float>& xList = series.x();
+	const std::vector<float>& yList = series.y();
+	const bool xSorted = series.xSorted();
+	auto point = [&](std::size_t i) {
+		return QPointF(
+			0.5 + uBegin + (xList[i] - xBegin_) * xScale_,
+			0.5 + vBegin + (yList[i] - yBegin_) * yScale_);
+	};
+
+	const std::size_t size = series.size();
+	std::size_t first = 0;
+	std::size_t end = size;
+	if (xSorted) {
+		// Visible range, including one point outside on each side.
+		const auto xListEnd = xList.begin() + size;
+		first = std::lower_bound(xList.begin(), xListEnd, static_cast<float>(xBegin_)) - xList.begin();
+		if (first > 0) --first;
+		end = std::upper_bound(xList.begin() + first, xListEnd, static_cast<float>(xEnd_)) - xList.begin();
+		if (end < size) ++end;
+	}
+
+	polygon_.clear();
+	const bool decimate = decimation_ && xSorted &&
+				end - first > MAX_POINTS_PER_COLUMN * static_cast<std::size_t>(std::max(mainAreaWidth_, 1));
+	if (decimate) {
+		auto column = [&](std::size_t i) {
+			return static_cast<long>(std::floor((xList[i] - xBegin_) * xScale_));
+		};
+		for (std::size_t i = first; i < end; ) {
+			const long c = column(i);
+			std::size_t iMin = i, iMax = i, j = i + 1U;
+			for ( ; j < end && column(j) == c; ++j) {
+				if (yList[j] < yList[iMin]) iMin = j;
+				if (yList[j] > yList[iMax]) iMax = j;
 			}
-			for (unsigned int i = 1, size = x2List_.size(); i < size; ++i) {
-				QPointF currPoint(
-					0.5 + uBegin + (x2List_[i] - xBegin_) * xScale_,
-					0.5 + vBegin + (y2List_[i] - yBegin_) * yScale_);
-				painter.drawLine(prevPoint, currPoint);
-				if (drawPointMarker_) {
-					painter.drawEllipse(currPoint, MARKER_SIZE, MARKER_SIZE);
+			// The points are added in index order, without duplicates.
+			const std::size_t indexList[MAX_POINTS_PER_COLUMN] = {i, std::min(iMin, iMax), std::max(iMin, iMax), j - 1U};
+			for (unsigned int k = 0; k < MAX_POINTS_PER_COLUMN; ++k) {
+				if (k == 0 || indexList[k] != indexList[k - 1U]) {
+					polygon_.append(point(indexList[k]));
 				}
-				prevPoint = currPoint;
-			}
-		} else {
-			for (unsigned int i = 0, size = x2List_.size(); i < size; ++i) {
-				QPointF currPoint(
-					0.5 + uBegin + (x2List_[i] - xBegin_) * xScale_,
-					0.5 + vBegin + (y2List_[i] - yBegin_) * yScale_);
-				painter.drawEllipse(currPoint, POINT_MARKER_SIZE, POINT_MARKER_SIZE);
 			}
+			i = j;
+		}
+	} else {
+		polygon_.reserve(static_cast<int>(end - first));
+		for (std::size_t i = first; i < end; ++i) {
+			polygon_.append(point(i));
 		}
 	}
 
-	painter.setClipping(false);
+	if (drawCurveLines_) {
+		painter.drawPolyline(polygon_);
+		if (drawPointMarker_ && !decimate) {
+			for (const QPointF& p : polygon_) {
+				painter.drawEllipse(p, MARKER_SIZE, MARKER_SIZE);
+			}
+		}
+	} else {
+		for (const QPointF& p : polygon_) {
+			painter.drawEllipse(p, POINT_MARKER_SIZE, POINT_MARKER_SIZE);
+		}
+	}
 }
 
 void
 Figure2DWidget::mouseDoubleClickEvent(QMouseEvent* event)
 {
-	if (xList_.empty() || xTicks_.empty()) return;
+	if (!series_ || xTicks_.empty()) return;
 	if (event->button() != Qt::LeftButton) return;
 
 	resetFigure(true);
@@ -323,7 +414,7 @@ Figure2DWidget::mouseDoubleClickEvent(QMouseEvent* event)
 void
 Figure2DWidget::mousePressEvent(QMouseEvent* event)
 {
-	if (xList_.empty() || xTicks_.empty()) return;
+	if (!series_ || xTicks_.empty()) return;
 
 #ifdef USING_QT6
 	lastMousePos_ = event->position();
@@ -340,7 +431,7 @@ Figure2DWidget::mouseMoveEvent(QMouseEvent* event)
 {
 	// Note: For mouse move events, event->button() == Qt::NoButton.
 
-	if (xList_.empty() || xTicks_.empty()) return;
+	if (!series_ || xTicks_.empty()) return;
 
 #ifdef USING_QT6
 	QPointF delta = event->position() - lastMousePos_;
@@ -414,7 +505,7 @@ Figure2DWidget::mouseMoveEvent(QMouseEvent* event)
 void
 Figure2DWidget::wheelEvent(QWheelEvent* event)
 {
-	if (xList_.empty() || xTicks_.empty()) return;
+	if (!series_ || xTicks_.empty()) return;
 
 	QPoint angle = event->angleDelta() / 8; // degrees
 	if (angle.y() == 0) return;
@@ -451,7 +542,7 @@ Figure2DWidget::wheelEvent(QWheelEvent* event)
 void
 Figure2DWidget::resizeEvent(QResizeEvent* /*event*/)
 {
-	if (xList_.empty() || xTicks_.empty()) return;
+	if (!series_ || xTicks_.empty()) return;
 
 	handleTransform();
 }
@@ -459,7 +550,7 @@ Figure2DWidget::resizeEvent(QResizeEvent* /*event*/)
 void
 Figure2DWidget::keyPressEvent(QKeyEvent* event)
 {
-	if (xList_.empty() || xTicks_.empty()) {
+	if (!series_ || xTicks_.empty()) {
 		QWidget::keyPressEvent(event);
 		return;
 	}
@@ -553,16 +644,17 @@ Figure2DWidget::autoSetAxesTicks(bool expand)
 bool
 Figure2DWidget::resetFigure(bool reduceYRange)
 {
-	// The values may not be sorted.
-	xEndData_   = *std::max_element(xList_.begin(), xList_.end());
-	xBeginData_ = *std::min_element(xList_.begin(), xList_.end());
-	yEndData_   = *std::max_element(yList_.begin(), yList_.end());
-	yBeginData_ = *std::min_element(yList_.begin(), yList_.end());
-	if (!x2List_.empty()) {
-		xEndData_   = std::max(static_cast<float>(xEndData_  ), *std::max_element(x2List_.begin(), x2List_.end()));
-		xBeginData_ = std::min(static_cast<float>(xBeginData_), *std::min_element(x2List_.begin(), x2List_.end()));
-		yEndData_   = std::max(static_cast<float>(yEndData_  ), *std::max_element(y2List_.begin(), y2List_.end()));
-		yBeginData_ = std::min(static_cast<float>(yBeginData_), *std::min_element(y2List_.begin(), y2List_.end()));
+	// The ranges were calculated in Figure2DSeries::create().
+	const Figure2DSeries& s1 = series_ ? *series_ : *series2_;
+	xEndData_   = s1.xMax();
+	xBeginData_ = s1.xMin();
+	yEndData_   = s1.yMax();
+	yBeginData_ = s1.yMin();
+	if (series_ && series2_) {
+		xEndData_   = std::max(static_cast<float>(xEndData_  ), series2_->xMax());
+		xBeginData_ = std::min(static_cast<float>(xBeginData_), series2_->xMin());
+		yEndData_   = std::max(static_cast<float>(yEndData_  ), series2_->yMax());
+		yBeginData_ = std::min(static_cast<float>(yBeginData_), series2_->yMin());
 	}
 
 	const double xValueDelta = xEndData_ - xBeginData_;
@@ -604,6 +696,47 @@ Figure2DWidget::resetFigure(bool reduceYRange)
 	return true;
 }
 
+// The x values are compared by buffer, they are not scanned.
+bool
+Figure2DWidget::sameRanges(const Figure2DSeries* s1, const Figure2DSeries* s2)
+{
+	return s1 && s2
+		&& &s1->x() == &s2->x()
+		&& s1->size() == s2->size()
+		&& s1->yMin() == s2->yMin()
+		&& s1->yMax() == s2->yMax();
+}
+
+void
+Figure2DWidget::setData(std::shared_ptr<const Figure2DSeries> series)
+{
+	if (sameRanges(series.get(), series_.get())) {
+		series_ = std::move(series);
+		update();
+		return;
+	}
+	series_ = std::move(series);
+	update();
+	if (series_ && !resetFigure(reduceYRange_)) {
+		series_.reset();
+	}
+}
+
+void
+Figure2DWidget::setData2(std::shared_ptr<const Figure2DSeries> series)
+{
+	if (sameRanges(series.get(), series2_.get())) {
+		series2_ = std::move(series);
+		update();
+		return;
+	}
+	series2_ = std::move(series);
+	update();
+	if (series2_ && !resetFigure(reduceYRange_)) {
+		series2_.reset();
+	}
+}
+
 void
 Figure2DWidget::setXLabel(QString label)
 {
@@ -19,21 +19,71 @@
 #define FIGURE_2D_WIDGET_H
 
 #include <cstddef> /* std::size_t */
-#include <iostream>
+#include <memory>
 #include <vector>
 
 #include <QLocale>
 #include <QPointF>
+#include <QPolygonF>
 #include <QString>
 #include <QWidget>
 
 namespace Lab {
 
+// Data of one curve.
+//
+// The x and y buffers are shared, so a producer can publish a new frame
+// without copying the values, and the same x buffer can be used by
+// several series. Each series has a unique version number, and the
+// ranges of the values are calculated only once, in create().
+// The values must not be modified after create(). A producer that
+// updates the curve continuously can alternate between two y buffers.
+class Figure2DSeries {
+public:
+	typedef std::shared_ptr<const std::vector<float>> Buffer;
+
+	// Uses the first "size" elements of x and y. If size < 2, uses all the elements.
+	// Returns nullptr if the data is invalid.
+	static std::shared_ptr<const Figure2DSeries> create(Buffer x, Buffer y, std::size_t size=0);
+	// The y values are not scanned.
+	static std::shared_ptr<const Figure2DSeries> create(Buffer x, Buffer y, std::size_t size,
+								float yMin, float yMax);
+
+	const std::vector<float>& x() const { return *x_; }
+	const std::vector<float>& y() const { return *y_; }
+	std::size_t size() const { return size_; }
+	unsigned long version() const { return version_; }
+	bool xSorted() const { return xSorted_; }
+	float xMin() const { return xMin_; }
+	float xMax() const { return xMax_; }
+	float yMin() const { return yMin_; }
+	float yMax() const { return yMax_; }
+private:
+	Figure2DSeries() = default;
+
+	static std::shared_ptr<Figure2DSeries> createWithXRange(Buffer x, Buffer y, std::size_t size);
+
+	Buffer x_;
+	Buffer y_;
+	std::size_t size_;
+	unsigned long version_;
+	bool xSorted_;
+	float xMin_;
+	float xMax_;
+	float yMin_;
+	float yMax_;
+};
+
 class Figure2DWidget : public QWidget {
 	Q_OBJECT
 public:
 	explicit Figure2DWidget(QWidget* parent=0);
 
+	// The figure is reset only if the x buffer, the size or the ranges
+	// of the series have changed.
+	void setData(std::shared_ptr<const Figure2DSeries> series);
+	void setData2(std::shared_ptr<const Figure2DSeries> series);
+	// These functions copy the data.
 	// If maxSize >= 2, use only maxSize elements.
 	template<typename T> void updateData(const std::vector<T>& x, const std::vector<T>& y, std::size_t maxSize=0);
 	template<typename T> void updateData2(const std::vector<T>& x, const std::vector<T>& y, std::size_t maxSize=0);
@@ -45,12 +95,12 @@ public:
 	void setSymmetricYRange(bool value) { symmetricYRange_ = value; }
 	void setReduceYRange(bool value) { reduceYRange_ = value; }
 	void setXCursorIndex(int value) { xCursorIndex_ = value; }
+	// If enabled (default), the curves are reduced to at most four points per pixel column.
+	void setDecimation(bool value) { decimation_ = value; update(); }
 	void resetYRange() { yBegin_ = 0.0; yEnd_ = 0.0; }
 	void clear() {
-		xList_.clear();
-		yList_.clear();
-		x2List_.clear();
-		y2List_.clear();
+		series_.reset();
+		series2_.reset();
 		update();
 	}
 protected:
@@ -65,6 +115,10 @@ private:
 	void handleTransform();
 	void autoSetAxesTicks(bool expand=false);
 	bool resetFigure(bool reduceYRange=true);
+	static bool sameRanges(const Figure2DSeries* s1, const Figure2DSeries* s2);
+	void drawCurve(QPainter& painter, const Figure2DSeries& series, double uBegin, double vBegin);
+
+	template<typename T> static Figure2DSeries::Buffer makeBuffer(const std::vector<T>& v, std::size_t size);
 
 	static void autoSetAxisTicks(double minValue, double maxValue,
 					std::vector<double>& ticks, double& coef,
@@ -76,6 +130,7 @@ private:
 	bool expandAxisTicks_;
 	bool symmetricYRange_;
 	bool reduceYRange_; // if false, updateData() will only extend the range
+	bool decimation_;
 	int leftMargin_;
 	int rightMargin_;
 	int topMargin_;
@@ -100,10 +155,8 @@ private:
 	double lastXBegin_;
 	double lastXEnd_;
 	double lastXScale_;
-	std::vector<float> xList_;
-	std::vector<float> yList_;
-	std::vector<float> x2List_;
-	std::vector<float> y2List_;
+	std::shared_ptr<const Figure2DSeries> series_;
+	std::shared_ptr<const Figure2DSeries> series2_;
 	std::vector<double> xTicks_;
 	std::vector<double> yTicks_;
 	std::vector<int> yTicksWidth_;
@@ -113,72 +166,31 @@ private:
 	int xCursorIndex_;
 	int maxXTickWidth_;
 	QLocale locale_;
+	QPolygonF polygon_;
 };
 
 template<typename T>
-void
-Figure2DWidget::updateData(const std::vector<T>& x, const std::vector<T>& y, std::size_t maxSize)
+Figure2DSeries::Buffer
+Figure2DWidget::makeBuffer(const std::vector<T>& v, std::size_t size)
 {
-	xList_.clear();
-	yList_.clear();
-	update();
-	if (x.size() != y.size()) {
-		std::cerr << "[Figure2DWidget::updateData] Arrays x and y with different sizes." << std::endl;
-		return;
-	}
-	if (x.size() < 2U) {
-		std::cerr << "[Figure2DWidget::updateData] Arrays x and y are too small." << std::endl;
-		return;
-	}
-
-	if (maxSize < 2U || maxSize > x.size()) {
-		maxSize = x.size();
-	}
-	xList_.resize(maxSize);
-	yList_.resize(maxSize);
-	for (unsigned int i = 0; i < maxSize; ++i) {
-		xList_[i] = x[i];
-		yList_[i] = y[i];
+	if (size < 2U || size > v.size()) {
+		size = v.size();
 	}
+	return std::make_shared<const std::vector<float>>(v.begin(), v.begin() + size);
+}
 
-	if (!resetFigure(reduceYRange_)) {
-		xList_.clear();
-		yList_.clear();
-		update();
-	}
+template<typename T>
+void
+Figure2DWidget::updateData(const std::vector<T>& x, const std::vector<T>& y, std::size_t maxSize)
+{
+	setData(Figure2DSeries::create(makeBuffer(x, maxSize), makeBuffer(y, maxSize)));
 }
 
 template<typename T>
 void
 Figure2DWidget::updateData2(const std::vector<T>& x, const std::vector<T>& y, std::size_t maxSize)
 {
-	x2List_.clear();
-	y2List_.clear();
-	update();
-	if (x.size() != y.size()) {
-		std::cerr << "[Figure2DWidget::updateData2] Arrays x and y with different sizes." << std::endl;
-		return;
-	}
-	if (x.size() < 2U) {
-		std::cerr << "[Figure2DWidget::updateData2] Arrays x and y are too small." << std::endl;
-		return;
-	}
-
-	if (maxSize < 2U || maxSize > x.size()) {
-		maxSize = x.size();
-	}
-	x2List_.resize(maxSize);
-	y2List_.resize(maxSize);
-	for (unsigned int i = 0; i < maxSize; ++i) {
-		x2List_[i] = x[i];
-		y2List_[i] = y[i];
-	}
-
-	if (!resetFigure(reduceYRange_)) {
-		x2List_.clear();
-		y2List_.clear();
-		update();
-	}
+	setData2(Figure2DSeries::create(makeBuffer(x, maxSize), makeBuffer(y, maxSize)));
 }
 
 } // namespace Lab
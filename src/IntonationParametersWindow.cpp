@@ -17,6 +17,8 @@
 
 #include "IntonationParametersWindow.h"
 
+#include <utility> /* move */
+
 #include "Controller.h"
 #include "Synthesis.h"
 #include "ui_IntonationParametersWindow.h"
@@ -99,7 +101,7 @@ IntonationParametersWindow::setup(Synthesis* synthesis)
 
 	synthesis_ = synthesis;
 
-	VTMControlModel::Configuration& config = synthesis_->vtmController->vtmControlModelConfiguration();
+	const VTMControlModel::Configuration& config = *synthesis_->configuration;
 
 	ui_->deviationSpinBox->setValue(config.driftDeviation);
 	ui_->cutoffSpinBox->setValue(config.driftLowpassCutoff);
@@ -122,7 +124,9 @@ IntonationParametersWindow::on_updateButton_clicked()
 {
 	if (synthesis_ == nullptr) return;
 
-	VTMControlModel::Configuration& config = synthesis_->vtmController->vtmControlModelConfiguration();
+	// The configuration may be shared with submitted jobs, so it is replaced.
+	auto newConfig = std::make_shared<VTMControlModel::Configuration>(*synthesis_->configuration);
+	VTMControlModel::Configuration& config = *newConfig;
 
 	config.microIntonation  = (ui_->microCheckBox->checkState()  == Qt::Checked);
 	config.macroIntonation  = (ui_->macroCheckBox->checkState()  == Qt::Checked);
@@ -133,17 +137,17 @@ IntonationParametersWindow::on_updateButton_clicked()
 	config.driftDeviation     = ui_->deviationSpinBox->value();
 	config.driftLowpassCutoff = ui_->cutoffSpinBox->value();
 
-	auto& eventList = synthesis_->vtmController->eventList();
-	if (ui_->useParametersCheckBox->checkState() == Qt::Checked) {
-		eventList.setFixedIntonationParameters(
-					ui_->notionalPitchSpinBox->value(),
-					ui_->pretonicPitchRangeSpinBox->value(),
-					ui_->pretonicPerturbationRangeSpinBox->value(),
-					ui_->tonicPitchRangeSpinBox->value(),
-					ui_->tonicPerturbationRangeSpinBox->value());
-		eventList.setUseFixedIntonationParameters(true);
-	} else {
-		eventList.setUseFixedIntonationParameters(false);
+	synthesis_->configuration = std::move(newConfig);
+
+	// Applied to the event list by SynthesisWorker.
+	FixedIntonationParameters& fixedIntonation = synthesis_->fixedIntonation;
+	fixedIntonation.enabled = (ui_->useParametersCheckBox->checkState() == Qt::Checked);
+	if (fixedIntonation.enabled) {
+		fixedIntonation.notionalPitch             = ui_->notionalPitchSpinBox->value();
+		fixedIntonation.pretonicPitchRange        = ui_->pretonicPitchRangeSpinBox->value();
+		fixedIntonation.pretonicPerturbationRange = ui_->pretonicPerturbationRangeSpinBox->value();
+		fixedIntonation.tonicPitchRange           = ui_->tonicPitchRangeSpinBox->value();
+		fixedIntonation.tonicPerturbationRange    = ui_->tonicPerturbationRangeSpinBox->value();
 	}
 }
 
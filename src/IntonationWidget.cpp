@@ -23,6 +23,7 @@
 #include <algorithm> /* max, min */
 #include <array>
 #include <cmath> /* abs */
+#include <cstddef> /* std::size_t */
 
 #include <QKeyEvent>
 #include <QMouseEvent>
@@ -33,6 +34,7 @@
 
 #include "EventList.h"
 #include "Model.h"
+#include "Trace.h"
 
 #define MARGIN 10.0
 #define TRACK_HEIGHT 20.0
@@ -73,6 +75,15 @@ constexpr std::array<const char*, 16> yLabels = {
 	"-20"
 };
 
+// Horner's method. The iterations are independent, so the loop can be vectorized.
+void
+evaluateCubic(double a, double b, double c, double d, const double* x, std::size_t n, double* y)
+{
+	for (std::size_t k = 0; k < n; ++k) {
+		y[k] = x[k] * (x[k] * (x[k] * a + b) + c) + d;
+	}
+}
+
 } // namespace
 
 namespace GS {
@@ -90,11 +101,21 @@ IntonationWidget::IntonationWidget(QWidget* parent)
 		, totalWidth_(MININUM_WIDTH)
 		, totalHeight_(MININUM_HEIGHT)
 		, selectedPoint_(-1)
+		, splinePolygonValid_()
+		, splineLeftMargin_()
+		, splineGraphWidth_()
+		, splineMaxTime_()
+		, pointIndexValid_()
+		, pointIndexLeftMargin_()
+		, pointIndexGraphWidth_()
+		, pointIndexMaxTime_()
+		, hoveredPoint_(-1)
 {
 	setMinimumWidth(totalWidth_);
 	setMinimumHeight(totalHeight_);
 
 	setFocusPolicy(Qt::StrongFocus); // enable key events
+	setMouseTracking(true);
 }
 
 
@@ -103,6 +124,8 @@ IntonationWidget::IntonationWidget(QWidget* parent)
 void
 IntonationWidget::paintEvent(QPaintEvent*)
 {
+	TraceSpan span("IntonationWidget::paintEvent", "paint");
+
 	if (eventList_ == nullptr || eventList_->list().empty()) {
 		return;
 	}
@@ -243,6 +266,18 @@ IntonationWidget::paintEvent(QPaintEvent*)
 
 	painter.setRenderHint(QPainter::Antialiasing, false);
 
+	// Point under the mouse cursor.
+	if (hoveredPoint_ >= 0 && hoveredPoint_ != selectedPoint_ &&
+			static_cast<std::size_t>(hoveredPoint_) < intonationPointList_.size()) {
+		double x = timeToX(intonationPointList_[hoveredPoint_].absoluteTime());
+		double y = valueToY(intonationPointList_[hoveredPoint_].semitone());
+		painter.setPen(Qt::gray);
+		painter.drawRect(QRectF(
+			 QPointF(x - SELECTION_SIZE, y - SELECTION_SIZE),
+			 QPointF(x + SELECTION_SIZE, y + SELECTION_SIZE)));
+		painter.setPen(pen);
+	}
+
 	// Point selection.
 	if (selectedPoint_ >= 0) {
 		double x = timeToX(intonationPointList_[selectedPoint_].absoluteTime());
@@ -329,24 +364,35 @@ IntonationWidget::mousePressEvent(QMouseEvent* event)
 #else
 	QPointF clickPoint = event->localPos();
 #endif
-	double minDist = 1.0e10;
-	for (unsigned int i = 0, size = intonationPointList_.size(); i < size; ++i) {
-		QPointF point(
-			timeToX(intonationPointList_[i].absoluteTime()),
-			valueToY(intonationPointList_[i].semitone()));
-
-		// Simplified "distance".
-		double dist = std::abs(point.x() - clickPoint.x()) + std::abs(point.y() - clickPoint.y());
-		if (dist < minDist) {
-			minDist = dist;
-			selectedPoint_ = i;
-		}
-	}
+	// Simplified "distance": |dx| + |dy|.
+	updatePointIndex();
+	selectedPoint_ = pointIndex_.nearest(clickPoint.x(), clickPoint.y());
 	sendSelectedPointData();
 
 	update();
 }
 
+void
+IntonationWidget::mouseMoveEvent(QMouseEvent* event)
+{
+	if (eventList_ == nullptr || eventList_->list().empty() || intonationPointList_.empty()) {
+		return;
+	}
+
+#ifdef USING_QT6
+	QPointF pos = event->position();
+#else
+	QPointF pos = event->localPos();
+#endif
+	updatePointIndex();
+	const int point = pointIndex_.firstInRange(pos.x(), pos.y(), SELECTION_SIZE);
+	if (point != hoveredPoint_) {
+		hoveredPoint_ = point;
+		setCursor(point >= 0 ? Qt::PointingHandCursor : Qt::ArrowCursor);
+		update();
+	}
+}
+
 void
 IntonationWidget::keyPressEvent(QKeyEvent* event)
 {
@@ -358,7 +404,7 @@ IntonationWidget::keyPressEvent(QKeyEvent* event)
 
 	switch (event->key()) {
 	case Qt::Key_Delete:
-		intonationPointList_.erase(intonationPointList_.begin() + selectedPoint_);
+		removeIntonationPoint(selectedPoint_);
 		selectedPoint_ = -1;
 		break;
 	case Qt::Key_Up:
@@ -366,12 +412,14 @@ IntonationWidget::keyPressEvent(QKeyEvent* event)
 			std::min(
 				MAX_VALUE,
 				intonationPointList_[selectedPoint_].semitone() + 1.0));
+		handlePointChange(selectedPoint_);
 		break;
 	case Qt::Key_Down:
 		intonationPointList_[selectedPoint_].setSemitone(
 			std::max(
 				MIN_VALUE,
 				intonationPointList_[selectedPoint_].semitone() - 1.0));
+		handlePointChange(selectedPoint_);
 		break;
 	case Qt::Key_Left:
 		if (intonationPointList_[selectedPoint_].ruleIndex() == 0) {
@@ -379,7 +427,7 @@ IntonationWidget::keyPressEvent(QKeyEvent* event)
 		}
 		{
 			auto intonationPoint = intonationPointList_[selectedPoint_];
-			intonationPointList_.erase(intonationPointList_.begin() + selectedPoint_);
+			removeIntonationPoint(selectedPoint_);
 			intonationPoint.setRuleIndex(intonationPoint.ruleIndex() - 1);
 			selectedPoint_ = addIntonationPoint(intonationPoint);
 		}
@@ -390,7 +438,7 @@ IntonationWidget::keyPressEvent(QKeyEvent* event)
 		}
 		{
 			auto intonationPoint = intonationPointList_[selectedPoint_];
-			intonationPointList_.erase(intonationPointList_.begin() + selectedPoint_);
+			removeIntonationPoint(selectedPoint_);
 			intonationPoint.setRuleIndex(intonationPoint.ruleIndex() + 1);
 			selectedPoint_ = addIntonationPoint(intonationPoint);
 		}
@@ -416,6 +464,7 @@ IntonationWidget::updateData(VTMControlModel::EventList* eventList)
 	eventList_ = eventList;
 
 	modelUpdated_ = true;
+	handlePointListChange();
 
 	update();
 }
@@ -435,6 +484,7 @@ IntonationWidget::setSelectedPointValue(double value)
 	}
 
 	intonationPointList_[selectedPoint_].setSemitone(value);
+	handlePointChange(selectedPoint_);
 	if (changedValue) {
 		sendSelectedPointData();
 	}
@@ -456,6 +506,7 @@ IntonationWidget::setSelectedPointSlope(double slope)
 	}
 
 	intonationPointList_[selectedPoint_].setSlope(slope);
+	handlePointChange(selectedPoint_);
 	if (changedValue) {
 		sendSelectedPointData();
 	}
@@ -477,6 +528,7 @@ IntonationWidget::setSelectedPointBeatOffset(double beatOffset)
 	}
 
 	intonationPointList_[selectedPoint_].setOffsetTime(beatOffset);
+	handlePointChange(selectedPoint_);
 	sendSelectedPointData();
 	update();
 }
@@ -502,6 +554,7 @@ IntonationWidget::loadIntonationFromEventList()
 	graphWidth_ = maxTime_ * timeScale_;
 
 	intonationPointList_ = eventList_->intonationPoints();
+	handlePointListChange();
 	if (selectedPoint_ >= static_cast<int>(intonationPointList_.size())) {
 		selectedPoint_ = -1;
 	}
@@ -540,56 +593,139 @@ IntonationWidget::drawPointMarker(QPainter& painter, double x, double y)
 	painter.drawEllipse(QPointF(x, y), MARKER_SIZE, MARKER_SIZE);
 }
 
+// The curves are calculated only for the segments that were invalidated,
+// and the polygon is rebuilt only if a segment or the scale has changed.
 void
 IntonationWidget::smoothPoints(QPainter& painter)
 {
 	if (intonationPointList_.size() < 2U) return;
 
-	for (unsigned int i = 0, end = intonationPointList_.size() - 1; i < end; ++i) {
-		const auto& point1 = intonationPointList_[i];
-		const auto& point2 = intonationPointList_[i + 1];
-
-		double x1 = point1.absoluteTime();
-		double y1 = point1.semitone();
-		double m1 = point1.slope();
-
-		double x2 = point2.absoluteTime();
-		double y2 = point2.semitone();
-		double m2 = point2.slope();
-
-		double x12 = x1  * x1;
-		double x13 = x12 * x1;
-
-		double x22 = x2  * x2;
-		double x23 = x22 * x2;
+	const std::size_t numberOfSegments = intonationPointList_.size() - 1U;
+	if (splineSegmentList_.size() != numberOfSegments) {
+		splineSegmentList_.assign(numberOfSegments, SplineSegment{});
+	}
+	if (leftMargin_ != splineLeftMargin_ || graphWidth_ != splineGraphWidth_ || maxTime_ != splineMaxTime_) {
+		splineLeftMargin_ = leftMargin_;
+		splineGraphWidth_ = graphWidth_;
+		splineMaxTime_ = maxTime_;
+		splinePolygonValid_ = false;
+	}
+	for (unsigned int i = 0; i < numberOfSegments; ++i) {
+		if (!splineSegmentList_[i].valid) {
+			updateSplineSegment(i);
+			splinePolygonValid_ = false;
+		}
+	}
 
-		double denominator = x2 - x1;
-		denominator = denominator * denominator * denominator;
+	if (!splinePolygonValid_) {
+		splinePolygon_.clear();
+		for (unsigned int i = 0; i < numberOfSegments; ++i) {
+			const SplineSegment& segment = splineSegmentList_[i];
+			// The first point is equal to the last point of the previous segment.
+			for (std::size_t k = (i == 0) ? 0 : 1, size = segment.timeList.size(); k < size; ++k) {
+				splinePolygon_.append(QPointF(0.5 + timeToX(segment.timeList[k]), 0.5 + valueToY(segment.valueList[k])));
+			}
+		}
+		splinePolygonValid_ = true;
+	}
 
-		double d = (-(y2 * x13) + 3.0 * y2 * x12 * x2 + m2 * x13 * x2 + m1 * x12 * x22 - m2 * x12 * x22 - 3.0 * x1 * y1 * x22 - m1 * x1 * x23 + y1 * x23)
-			/ denominator;
-		double c = (-(m2 * x13) - 6.0 * y2 * x1 * x2 - 2.0 * m1 * x12 * x2 - m2 * x12 * x2 + 6.0 * x1 * y1 * x2 + m1 * x1 * x22 + 2.0 * m2 * x1 * x22 + m1 * x23)
-			/ denominator;
-		double b = (3.0 * y2 * x1 + m1 * x12 + 2.0 * m2 * x12 - 3.0 * x1 * y1 + 3.0 * x2 * y2 + m1 * x1 * x2 - m2 * x1 * x2 - 3.0 * y1 * x2 - 2.0 * m1 * x22 - m2 * x22)
-			/ denominator;
-		double a = (-2.0 * y2 - m1 * x1 - m2 * x1 + 2.0 * y1 + m1 * x2 + m2 * x2) / denominator;
+	painter.drawPolyline(splinePolygon_);
+}
 
-		QPointF prevPoint(0.5 + timeToX(x1), 0.5 + valueToY(y1));
+void
+IntonationWidget::updateSplineSegment(unsigned int index)
+{
+	const auto& point1 = intonationPointList_[index];
+	const auto& point2 = intonationPointList_[index + 1];
+
+	double x1 = point1.absoluteTime();
+	double y1 = point1.semitone();
+	double m1 = point1.slope();
+
+	double x2 = point2.absoluteTime();
+	double y2 = point2.semitone();
+	double m2 = point2.slope();
+
+	double x12 = x1  * x1;
+	double x13 = x12 * x1;
+
+	double x22 = x2  * x2;
+	double x23 = x22 * x2;
+
+	double denominator = x2 - x1;
+	denominator = denominator * denominator * denominator;
+
+	double d = (-(y2 * x13) + 3.0 * y2 * x12 * x2 + m2 * x13 * x2 + m1 * x12 * x22 - m2 * x12 * x22 - 3.0 * x1 * y1 * x22 - m1 * x1 * x23 + y1 * x23)
+		/ denominator;
+	double c = (-(m2 * x13) - 6.0 * y2 * x1 * x2 - 2.0 * m1 * x12 * x2 - m2 * x12 * x2 + 6.0 * x1 * y1 * x2 + m1 * x1 * x22 + 2.0 * m2 * x1 * x22 + m1 * x23)
+		/ denominator;
+	double b = (3.0 * y2 * x1 + m1 * x12 + 2.0 * m2 * x12 - 3.0 * x1 * y1 + 3.0 * x2 * y2 + m1 * x1 * x2 - m2 * x1 * x2 - 3.0 * y1 * x2 - 2.0 * m1 * x22 - m2 * x22)
+		/ denominator;
+	double a = (-2.0 * y2 - m1 * x1 - m2 * x1 + 2.0 * y1 + m1 * x2 + m2 * x2) / denominator;
+
+	// The curve is evaluated at the multiples of SMOOTH_POINTS_X_INCREMENT from
+	// static_cast<unsigned int>(x1), and starts at point 1 and ends at point 2.
+	const unsigned int j1 = static_cast<unsigned int>(x1);
+	const unsigned int j2 = static_cast<unsigned int>(x2);
+	const std::size_t n = (j2 >= j1) ? (j2 - j1) / SMOOTH_POINTS_X_INCREMENT + 1U : 0;
+
+	SplineSegment& segment = splineSegmentList_[index];
+	segment.timeList.resize(n + 2U);
+	segment.valueList.resize(n + 2U);
+	segment.timeList[0] = x1;
+	segment.valueList[0] = y1;
+	for (std::size_t k = 0; k < n; ++k) {
+		segment.timeList[k + 1U] = j1 + k * SMOOTH_POINTS_X_INCREMENT;
+	}
+	evaluateCubic(a, b, c, d, &segment.timeList[1], n, &segment.valueList[1]);
+	segment.timeList[n + 1U] = x2;
+	segment.valueList[n + 1U] = y2;
+	segment.valid = true;
+}
 
-		for (unsigned int j = static_cast<unsigned int>(x1); j <= static_cast<unsigned int>(x2); j += SMOOTH_POINTS_X_INCREMENT) {
-			double x = j;
-			double y = x * (x * (x * a + b) + c) + d;
+// Invalidates the point index, and the spline segments that end and start at the point.
+void
+IntonationWidget::handlePointChange(int pointIndex)
+{
+	pointIndexValid_ = false;
+	for (int i = pointIndex - 1; i <= pointIndex; ++i) {
+		if (i >= 0 && static_cast<std::size_t>(i) < splineSegmentList_.size()) {
+			splineSegmentList_[i].valid = false;
+		}
+	}
+}
 
-			QPointF currPoint(0.5 + timeToX(x), 0.5 + valueToY(y));
+void
+IntonationWidget::handlePointListChange()
+{
+	pointIndexValid_ = false;
+	hoveredPoint_ = -1;
 
-			painter.drawLine(prevPoint, currPoint);
+	splineSegmentList_.clear();
+}
 
-			prevPoint = currPoint;
-		}
+// Rebuilds the index if the points or the scale have changed.
+void
+IntonationWidget::updatePointIndex()
+{
+	if (pointIndexValid_ && leftMargin_ == pointIndexLeftMargin_ &&
+			graphWidth_ == pointIndexGraphWidth_ && maxTime_ == pointIndexMaxTime_) {
+		return;
+	}
 
-		QPointF lastPoint(0.5 + timeToX(x2), 0.5 + valueToY(y2));
-		painter.drawLine(prevPoint, lastPoint);
+	pointIndex_.clear();
+	for (unsigned int i = 0, size = intonationPointList_.size(); i < size; ++i) {
+		pointIndex_.add(
+			timeToX(intonationPointList_[i].absoluteTime()),
+			valueToY(intonationPointList_[i].semitone()),
+			i);
 	}
+	pointIndex_.sort();
+
+	pointIndexValid_ = true;
+	pointIndexLeftMargin_ = leftMargin_;
+	pointIndexGraphWidth_ = graphWidth_;
+	pointIndexMaxTime_ = maxTime_;
 }
 
 // Returns the insertion index.
@@ -604,14 +740,43 @@ IntonationWidget::addIntonationPoint(VTMControlModel::IntonationPoint& newPoint)
 	}
 
 	double time = newPoint.absoluteTime();
-	for (unsigned int i = 0, size = intonationPointList_.size(); i < size; ++i) {
-		if (time < intonationPointList_[i].absoluteTime()) {
-			intonationPointList_.insert(intonationPointList_.begin() + i, newPoint);
-			return i;
+	unsigned int index = 0;
+	for (unsigned int size = intonationPointList_.size(); index < size; ++index) {
+		if (time < intonationPointList_[index].absoluteTime()) {
+			break;
+		}
+	}
+	intonationPointList_.insert(intonationPointList_.begin() + index, newPoint);
+	pointIndexValid_ = false;
+	hoveredPoint_ = -1;
+
+	// The segment that contained the new point is split in two.
+	if (intonationPointList_.size() >= 2U && splineSegmentList_.size() == intonationPointList_.size() - 2U) {
+		splineSegmentList_.insert(splineSegmentList_.begin() + std::min<std::size_t>(index, splineSegmentList_.size()), SplineSegment{});
+		handlePointChange(index);
+	} else {
+		handlePointListChange();
+	}
+
+	return index;
+}
+
+void
+IntonationWidget::removeIntonationPoint(int index)
+{
+	intonationPointList_.erase(intonationPointList_.begin() + index);
+	pointIndexValid_ = false;
+	hoveredPoint_ = -1;
+
+	// The two segments that contained the point are merged.
+	if (!splineSegmentList_.empty() && splineSegmentList_.size() == intonationPointList_.size()) {
+		splineSegmentList_.erase(splineSegmentList_.begin() + std::min<std::size_t>(index, splineSegmentList_.size() - 1U));
+		if (index > 0 && static_cast<std::size_t>(index - 1) < splineSegmentList_.size()) {
+			splineSegmentList_[index - 1].valid = false;
 		}
+	} else {
+		handlePointListChange();
 	}
-	intonationPointList_.push_back(newPoint);
-	return intonationPointList_.size() - 1;
 }
 
 void
@@ -23,9 +23,11 @@
 
 #include <vector>
 
+#include <QPolygonF>
 #include <QWidget>
 
 #include "IntonationPoint.h"
+#include "PointIndex.h"
 
 
 
@@ -61,6 +63,7 @@ protected:
 	virtual void paintEvent(QPaintEvent*);
 	virtual void mouseDoubleClickEvent(QMouseEvent* event);
 	virtual void mousePressEvent(QMouseEvent* event);
+	virtual void mouseMoveEvent(QMouseEvent* event);
 	virtual void keyPressEvent(QKeyEvent* event);
 private:
 	IntonationWidget(const IntonationWidget&) = delete;
@@ -68,13 +71,26 @@ private:
 	IntonationWidget(IntonationWidget&&) = delete;
 	IntonationWidget& operator=(IntonationWidget&&) = delete;
 
+	// Cubic curve between two intonation points.
+	struct SplineSegment {
+		bool valid;
+		std::vector<double> timeList;
+		std::vector<double> valueList;
+	};
+
 	double valueToY(double value);
 	double timeToX(double time);
 	double yToValue(double y);
 	double xToTime(double x);
 	void drawPointMarker(QPainter& painter, double x, double y);
 	void smoothPoints(QPainter& painter);
+	void updateSplineSegment(unsigned int index);
+	// These functions must be called after the intonation points are modified.
+	void handlePointChange(int pointIndex);
+	void handlePointListChange();
+	void updatePointIndex();
 	int addIntonationPoint(VTMControlModel::IntonationPoint& newPoint);
+	void removeIntonationPoint(int index);
 
 	VTMControlModel::EventList* eventList_;
 	double timeScale_;
@@ -89,6 +105,18 @@ private:
 	int selectedPoint_;
 	std::vector<VTMControlModel::IntonationPoint> intonationPointList_;
 	std::vector<int> postureTimeList_;
+	std::vector<SplineSegment> splineSegmentList_; // splineSegmentList_[i]: from point i to point i + 1
+	QPolygonF splinePolygon_; // in widget coordinates
+	bool splinePolygonValid_;
+	double splineLeftMargin_;
+	double splineGraphWidth_;
+	double splineMaxTime_;
+	PointIndex pointIndex_; // positions of the intonation points in widget coordinates
+	bool pointIndexValid_;
+	double pointIndexLeftMargin_;
+	double pointIndexGraphWidth_;
+	double pointIndexMaxTime_;
+	int hoveredPoint_;
 };
 
 } // namespace GS
@@ -174,4 +174,21 @@ IntonationWindow::disableProcessingButtons()
 	ui_->synthesizeToFileButton->setEnabled(false);
 }
 
+// Slot.
+void
+IntonationWindow::attachEventList()
+{
+	if (synthesis_ == nullptr || !synthesis_->vtmController) return;
+
+	ui_->intonationWidget->updateData(&synthesis_->vtmController->eventList());
+}
+
+// Slot.
+// The event list must not be accessed while it is being modified by the synthesis thread.
+void
+IntonationWindow::detachEventList()
+{
+	ui_->intonationWidget->updateData(nullptr);
+}
+
 } // namespace GS
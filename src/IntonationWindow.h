@@ -47,6 +47,8 @@ public slots:
 	void loadIntonationFromEventList();
 	void enableProcessingButtons();
 	void disableProcessingButtons();
+	void attachEventList();
+	void detachEventList();
 private slots:
 	void on_valueLineEdit_editingFinished();
 	void on_slopeLineEdit_editingFinished();
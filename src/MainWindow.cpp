@@ -49,6 +49,7 @@
 #include "RuleTesterWindow.h"
 #include "Synthesis.h"
 #include "SynthesisWindow.h"
+#include "Trace.h"
 #include "TransitionEditorWindow.h"
 #include "ui_MainWindow.h"
 
@@ -158,6 +159,38 @@ MainWindow::MainWindow(QWidget* parent)
 	connect(ruleManagerWindow_.get(), &RuleManagerWindow::equationReferenceChanged,
 			prototypeManagerWindow_.get(), &PrototypeManagerWindow::setupEquationsTree);
 
+	// Invalidate the cached synthesis results.
+	connect(dataEntryWindow_.get()              , &DataEntryWindow::categoryChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(dataEntryWindow_.get()              , &DataEntryWindow::parameterChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(dataEntryWindow_.get()              , &DataEntryWindow::symbolChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(postureEditorWindow_.get()          , &PostureEditorWindow::postureChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(postureEditorWindow_.get()          , &PostureEditorWindow::postureCategoryChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(prototypeManagerWindow_.get()       , &PrototypeManagerWindow::equationChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(prototypeManagerWindow_.get()       , &PrototypeManagerWindow::transitionChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(prototypeManagerWindow_.get()       , &PrototypeManagerWindow::specialTransitionChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(transitionEditorWindow_.get()       , &TransitionEditorWindow::transitionChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(specialTransitionEditorWindow_.get(), &TransitionEditorWindow::transitionChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(ruleManagerWindow_.get()            , &RuleManagerWindow::ruleChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(ruleManagerWindow_.get()            , &RuleManagerWindow::transitionReferenceChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(ruleManagerWindow_.get()            , &RuleManagerWindow::specialTransitionReferenceChanged,
+			this, &MainWindow::incrementModelRevision);
+	connect(ruleManagerWindow_.get()            , &RuleManagerWindow::equationReferenceChanged,
+			this, &MainWindow::incrementModelRevision);
+
+	connect(synthesisWindow_.get() , &SynthesisWindow::eventListReplaced,
+			intonationWindow_.get()           , &IntonationWindow::attachEventList);
 	connect(synthesisWindow_.get() , &SynthesisWindow::textSynthesized,
 			intonationWindow_.get()           , &IntonationWindow::loadIntonationFromEventList);
 	connect(synthesisWindow_.get() , &SynthesisWindow::textSynthesized,
@@ -165,13 +198,21 @@ MainWindow::MainWindow(QWidget* parent)
 
 	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisStarted,
 			intonationWindow_.get()           , &IntonationWindow::disableProcessingButtons);
+	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisStarted,
+			intonationWindow_.get()           , &IntonationWindow::detachEventList);
 	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisStarted,
 			parameterModificationWindow_.get(), &ParameterModificationWindow::disableWindow);
+	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisStarted,
+			this                              , &MainWindow::disableModelEditors);
 
+	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisFinished,
+			intonationWindow_.get()           , &IntonationWindow::attachEventList);
 	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisFinished,
 			intonationWindow_.get()           , &IntonationWindow::enableProcessingButtons);
 	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisFinished,
 			parameterModificationWindow_.get(), &ParameterModificationWindow::enableWindow);
+	connect(synthesisWindow_.get() , &SynthesisWindow::synthesisFinished,
+			this                              , &MainWindow::enableModelEditors);
 
 	connect(intonationWindow_.get(), &IntonationWindow::synthesisRequested,
 			synthesisWindow_.get() , &SynthesisWindow::synthesizeWithManualIntonation);
@@ -378,6 +419,7 @@ MainWindow::on_parameterModificationButton_clicked()
 bool
 MainWindow::openModel()
 {
+	TraceSpan span("MainWindow::openModel", "model");
 	try {
 		Index index{config_.projectDir.toStdString()};
 		JackConfig::setupFromFile(index.entry("jack_file").c_str());
@@ -386,7 +428,9 @@ MainWindow::openModel()
 		model_ = std::make_unique<VTMControlModel::Model>();
 		model_->load(config_.dataFilePath.toStdString());
 
+		synthesisWindow_->stopSynthesis();
 		synthesis_->setup(model_.get());
+		synthesis_->loadReferenceModel();
 
 		dataEntryWindow_->resetModel(model_.get());
 		postureEditorWindow_->resetModel(model_.get());
@@ -428,10 +472,12 @@ MainWindow::openModel()
 bool
 MainWindow::saveModel()
 {
+	TraceSpan span("MainWindow::saveModel", "model");
 	try {
 		model_->validate();
 
 		model_->save(config_.dataFilePath.toStdString());
+		synthesis_->loadReferenceModel(); // the file has changed
 
 		qDebug() << "### Model saved to" << config_.dataFilePath;
 	} catch (const std::exception& exc) {
@@ -447,7 +493,9 @@ MainWindow::updateSynthesis()
 	if (!model_) return;
 
 	try {
+		synthesisWindow_->stopSynthesis();
 		synthesis_->setup(model_.get());
+		synthesis_->loadReferenceModel();
 
 		synthesisWindow_->setup(model_.get(), synthesis_.get());
 		intonationWindow_->setup(synthesis_.get());
@@ -470,6 +518,43 @@ MainWindow::destroyInteractiveVTMWindow()
 	interactiveVTMWindow_.reset();
 }
 
+// Slot.
+void
+MainWindow::incrementModelRevision()
+{
+	++synthesis_->modelRevision;
+}
+
+// Slot.
+void
+MainWindow::enableModelEditors()
+{
+	setModelEditorsEnabled(true);
+}
+
+// Slot.
+// The model must not be modified while it is being used by the synthesis thread.
+// It is not saved either, because the controller modifies it during the synthesis.
+void
+MainWindow::disableModelEditors()
+{
+	setModelEditorsEnabled(false);
+}
+
+void
+MainWindow::setModelEditorsEnabled(bool enabled)
+{
+	dataEntryWindow_->setEnabled(enabled);
+	postureEditorWindow_->setEnabled(enabled);
+	prototypeManagerWindow_->setEnabled(enabled);
+	transitionEditorWindow_->setEnabled(enabled);
+	specialTransitionEditorWindow_->setEnabled(enabled);
+	ruleManagerWindow_->setEnabled(enabled);
+	ruleTesterWindow_->setEnabled(enabled);
+	intonationParametersWindow_->setEnabled(enabled);
+	ui_->saveAction->setEnabled(enabled);
+}
+
 void
 MainWindow::on_aboutAction_triggered()
 {
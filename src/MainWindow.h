@@ -75,6 +75,9 @@ private slots:
 
 	void updateSynthesis();
 	void destroyInteractiveVTMWindow();
+	void incrementModelRevision();
+	void enableModelEditors();
+	void disableModelEditors();
 private:
 	MainWindow(const MainWindow&) = delete;
 	MainWindow& operator=(const MainWindow&) = delete;
@@ -83,6 +86,7 @@ private:
 
 	bool openModel();
 	bool saveModel();
+	void setModelEditorsEnabled(bool enabled);
 
 	AppConfig config_;
 	std::unique_ptr<VTMControlModel::Model> model_;
@@ -0,0 +1,67 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "ModelSnapshot.h"
+
+#include <sys/mman.h> /* memfd_create */
+#include <sys/stat.h> /* fstat */
+#include <unistd.h> /* close */
+
+#include "Exception.h"
+#include "Model.h"
+
+
+
+namespace GS {
+
+ModelSnapshot::ModelSnapshot(VTMControlModel::Model& model, unsigned int modelRevision)
+		: fd_(memfd_create("gama_tts_editor_model", MFD_CLOEXEC))
+		, modelRevision_(modelRevision)
+		, size_()
+{
+	if (fd_ == -1) {
+		THROW_EXCEPTION(ModelSnapshotException, "Could not create the memory file for the model.");
+	}
+	filePath_ = "/proc/self/fd/" + std::to_string(fd_);
+	try {
+		model.save(filePath_);
+	} catch (...) {
+		close(fd_);
+		throw;
+	}
+	struct stat st;
+	if (fstat(fd_, &st) == 0) {
+		size_ = st.st_size;
+	}
+}
+
+ModelSnapshot::~ModelSnapshot()
+{
+	close(fd_);
+}
+
+// Each opening of the path in /proc creates an independent file description,
+// so the copies can be loaded concurrently.
+std::unique_ptr<VTMControlModel::Model>
+ModelSnapshot::createModel() const
+{
+	auto model = std::make_unique<VTMControlModel::Model>();
+	model->load(filePath_);
+	return model;
+}
+
+} // namespace GS
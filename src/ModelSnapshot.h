@@ -0,0 +1,70 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef MODEL_SNAPSHOT_H
+#define MODEL_SNAPSHOT_H
+
+#include <cstddef> /* std::size_t */
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+
+
+namespace GS {
+
+struct ModelSnapshotException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+namespace VTMControlModel {
+class Model;
+}
+
+// Saved state of the model, used to create independent copies
+// (the controllers modify the model during the synthesis).
+//
+// The model is saved once, to an anonymous file in memory (memfd),
+// so the copies do not touch the file system and do not need the
+// original model.
+class ModelSnapshot {
+public:
+	// The model must not be modified during the call.
+	ModelSnapshot(VTMControlModel::Model& model, unsigned int modelRevision);
+	~ModelSnapshot();
+
+	unsigned int modelRevision() const { return modelRevision_; }
+	// Size of the saved model (bytes). Used to estimate the memory used by a copy.
+	std::size_t size() const { return size_; }
+
+	// May be called from any thread.
+	std::unique_ptr<VTMControlModel::Model> createModel() const;
+private:
+	ModelSnapshot(const ModelSnapshot&) = delete;
+	ModelSnapshot& operator=(const ModelSnapshot&) = delete;
+	ModelSnapshot(ModelSnapshot&&) = delete;
+	ModelSnapshot& operator=(ModelSnapshot&&) = delete;
+
+	int fd_;
+	std::string filePath_; // path of the memory file in /proc
+	unsigned int modelRevision_;
+	std::size_t size_;
+};
+
+} // namespace GS
+
+#endif // MODEL_SNAPSHOT_H
@@ -0,0 +1,331 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "OfflineRenderer.h"
+
+#include <algorithm> /* max, min */
+#include <cmath> /* abs, rint */
+#include <iostream>
+
+#include "ConfigurationData.h"
+#include "Exception.h"
+#include "Log.h"
+#include "VocalTractModel.h"
+#include "VTMUtil.h"
+#include "WAVWriter.h"
+#include "WorkerPool.h"
+
+
+
+namespace GS {
+
+OfflineRenderer::OfflineRenderer(const ConfigurationData& vtmConfigData, double controlRate,
+					const Configuration& config)
+		: vtmConfigData_(vtmConfigData)
+		, config_(config)
+		, controlSteps_()
+		, controlRate_(controlRate)
+		, stats_()
+		, outputScale_()
+{
+	if (controlRate_ <= 0.0) {
+		THROW_EXCEPTION(InvalidValueException, "Invalid control rate: " << controlRate_ << '.');
+	}
+	auto vtm = VTM::VocalTractModel::getInstance(vtmConfigData_, false);
+	controlSteps_ = static_cast<unsigned int>(std::rint(vtm->internalSampleRate() / controlRate_));
+	if (controlSteps_ == 0) {
+		THROW_EXCEPTION(InvalidValueException, "Invalid control rate: " << controlRate_ << '.');
+	}
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+void
+OfflineRenderer::render(const std::vector<std::vector<float>>& paramList, std::vector<float>& output)
+{
+	stats_ = Statistics();
+
+	std::vector<Chunk> chunkList;
+	splitTrack(paramList, chunkList);
+	stats_.numberOfChunks = chunkList.size();
+	if (chunkList.size() <= 1U) {
+		renderSerial(paramList, output);
+		return;
+	}
+
+	WorkerPool pool(config_.numberOfWorkers);
+	pool.run(chunkList.size(), [&](unsigned int /*workerIndex*/, std::size_t chunkIndex) {
+		renderChunk(paramList, chunkList[chunkIndex]);
+	});
+
+	// Join the chunks.
+	output.clear();
+	std::size_t tailPos = 0; // position of the tail of the previous chunk
+	for (std::size_t k = 0; k < chunkList.size(); ++k) {
+		const std::vector<float>& chunkOutput = chunkList[k].output;
+		if (k == 0) {
+			output = chunkOutput;
+			tailPos = std::min(chunkList[k].mainSize, output.size());
+			continue;
+		}
+
+		appendWithCrossfade(output, tailPos, chunkOutput);
+		tailPos = std::min(tailPos + chunkList[k].mainSize, output.size());
+	}
+
+	if (Log::debugEnabled) {
+		std::cout << "[OfflineRenderer::render] Chunks: " << chunkList.size() << " samples: " << output.size() << std::endl;
+	}
+
+	if (config_.validate) {
+		validate(paramList, output);
+	}
+}
+
+void
+OfflineRenderer::renderSerial(const std::vector<std::vector<float>>& paramList, std::vector<float>& output)
+{
+	output.clear();
+	if (paramList.size() < 2U) return;
+
+	auto vtm = VTM::VocalTractModel::getInstance(vtmConfigData_, false);
+	renderTransitions(paramList, 1, paramList.size(), *vtm, output);
+}
+
+void
+OfflineRenderer::renderJoin(const std::vector<std::vector<float>>& paramList, std::size_t joinFrame,
+				std::vector<float>& bridge, std::vector<float>& head) const
+{
+	if (joinFrame == 0 || joinFrame >= paramList.size()) {
+		THROW_EXCEPTION(InvalidValueException, "Invalid join frame: " << joinFrame << '.');
+	}
+	const std::size_t prerollTransitions = std::rint(config_.prerollDuration * controlRate_);
+	const std::size_t crossfadeTransitions = std::max<std::size_t>(1, std::rint(config_.crossfadeDuration * controlRate_));
+
+	auto vtm = VTM::VocalTractModel::getInstance(vtmConfigData_, false);
+
+	// Pre-roll.
+	const std::size_t prerollStart = (joinFrame > prerollTransitions + 1U) ?
+						joinFrame - prerollTransitions : 1;
+	std::vector<float> prerollOutput;
+	renderTransitions(paramList, prerollStart, joinFrame, *vtm, prerollOutput);
+
+	bridge.clear();
+	renderTransitions(paramList, joinFrame, joinFrame + 1U, *vtm, bridge);
+
+	head.clear();
+	const std::size_t headEnd = std::min(joinFrame + 1U + crossfadeTransitions, paramList.size());
+	renderTransitions(paramList, joinFrame + 1U, headEnd, *vtm, head);
+}
+
+void
+OfflineRenderer::joinContext(std::size_t& framesBefore, std::size_t& framesAfter) const
+{
+	const std::size_t prerollTransitions = std::rint(config_.prerollDuration * controlRate_);
+	const std::size_t crossfadeTransitions = std::max<std::size_t>(1, std::rint(config_.crossfadeDuration * controlRate_));
+	framesBefore = prerollTransitions + 1U;
+	framesAfter = crossfadeTransitions + 1U;
+}
+
+void
+OfflineRenderer::appendWithCrossfade(std::vector<float>& output, std::size_t fadeStart,
+					const std::vector<float>& input)
+{
+	fadeStart = std::min(fadeStart, output.size());
+	const std::size_t fadeSize = std::min(output.size() - fadeStart, input.size());
+	for (std::size_t j = 0; j < fadeSize; ++j) {
+		const float w = (j + 0.5f) / fadeSize;
+		output[fadeStart + j] = (1.0f - w) * output[fadeStart + j] + w * input[j];
+	}
+	output.resize(fadeStart + fadeSize);
+	output.insert(output.end(), input.begin() + fadeSize, input.end());
+}
+
+void
+OfflineRenderer::renderToFile(const std::vector<std::vector<float>>& paramList, double outputSampleRate,
+				const std::string& filePath)
+{
+	std::vector<float> output;
+	render(paramList, output);
+
+	outputScale_ = VTM::Util::calculateOutputScale(VTM::Util::maximumAbsoluteValue(output));
+	for (float& sample : output) {
+		sample *= outputScale_;
+	}
+
+	WAVWriter writer(filePath, outputSampleRate);
+	writer.write(output.data(), output.size());
+	writer.close();
+}
+
+float
+OfflineRenderer::frameVolume(const std::vector<float>& frame) const
+{
+	float volume = 0.0;
+	for (unsigned int i : volumeParamList_) {
+		if (i < frame.size()) {
+			volume = std::max(volume, frame[i]);
+		}
+	}
+	return volume;
+}
+
+void
+OfflineRenderer::splitTrack(const std::vector<std::vector<float>>& paramList, std::vector<Chunk>& chunkList) const
+{
+	chunkList.clear();
+	if (paramList.size() < 2U) return;
+
+	const std::size_t numTransitions = paramList.size() - 1U;
+	const std::size_t minChunkTransitions = std::max<std::size_t>(1, std::rint(config_.minChunkDuration * controlRate_));
+	const std::size_t numChunks = std::max<std::size_t>(1,
+					std::min<std::size_t>(numTransitions / minChunkTransitions,
+								WorkerPool::effectiveNumberOfWorkers(config_.numberOfWorkers)));
+
+	// Find the boundaries. Each one is searched near the position of a uniform split.
+	const std::size_t chunkSize = numTransitions / numChunks;
+	const std::size_t searchRadius = chunkSize / 4;
+	std::vector<std::size_t> boundaryList;
+	boundaryList.push_back(1);
+	for (std::size_t k = 1; k < numChunks; ++k) {
+		const std::size_t target = 1 + k * chunkSize;
+		const std::size_t first = std::max(target - searchRadius, boundaryList.back() + 1);
+		const std::size_t last = std::min(target + searchRadius, numTransitions);
+		std::size_t best = target;
+		float bestVolume = 0.0;
+		std::size_t bestDistance = 0;
+		for (std::size_t i = first; i <= last; ++i) {
+			// All the volumes below the threshold are considered equivalent.
+			const float volume = std::max(frameVolume(paramList[i]), config_.silenceThreshold);
+			const std::size_t distance = (i > target) ? i - target : target - i;
+			if (i == first || volume < bestVolume || (volume == bestVolume && distance < bestDistance)) {
+				best = i;
+				bestVolume = volume;
+				bestDistance = distance;
+			}
+		}
+		boundaryList.push_back(best);
+	}
+	boundaryList.push_back(paramList.size());
+
+	chunkList.resize(numChunks);
+	for (std::size_t k = 0; k < numChunks; ++k) {
+		chunkList[k].firstTransition = boundaryList[k];
+		chunkList[k].endTransition = boundaryList[k + 1];
+		chunkList[k].mainSize = 0;
+	}
+}
+
+void
+OfflineRenderer::renderChunk(const std::vector<std::vector<float>>& paramList, Chunk& chunk) const
+{
+	const std::size_t prerollTransitions = std::rint(config_.prerollDuration * controlRate_);
+	const std::size_t crossfadeTransitions = std::max<std::size_t>(1, std::rint(config_.crossfadeDuration * controlRate_));
+
+	auto vtm = VTM::VocalTractModel::getInstance(vtmConfigData_, false);
+
+	// Pre-roll.
+	const std::size_t prerollStart = (chunk.firstTransition > prerollTransitions + 1U) ?
+						chunk.firstTransition - prerollTransitions : 1;
+	std::vector<float> prerollOutput;
+	renderTransitions(paramList, prerollStart, chunk.firstTransition, *vtm, prerollOutput);
+
+	chunk.output.clear();
+	renderTransitions(paramList, chunk.firstTransition, chunk.endTransition, *vtm, chunk.output);
+	chunk.mainSize = chunk.output.size();
+
+	// Tail, to be crossfaded with the next chunk.
+	const std::size_t tailEnd = std::min(chunk.endTransition + crossfadeTransitions, paramList.size());
+	renderTransitions(paramList, chunk.endTransition, tailEnd, *vtm, chunk.output);
+}
+
+void
+OfflineRenderer::renderTransitions(const std::vector<std::vector<float>>& paramList,
+					std::size_t firstTransition, std::size_t endTransition,
+					VTM::VocalTractModel& vtm, std::vector<float>& output) const
+{
+	if (firstTransition == 0) {
+		THROW_EXCEPTION(InvalidValueException, "Invalid transition index: 0.");
+	}
+	if (firstTransition >= endTransition) return;
+
+	const std::size_t numParam = paramList[0].size();
+	std::vector<float> currentParam(numParam);
+	std::vector<float> delta(numParam);
+	const float coef = 1.0f / controlSteps_;
+	std::vector<float>& vtmOutputBuffer = vtm.outputBuffer();
+
+	for (std::size_t t = firstTransition; t < endTransition; ++t) {
+		const std::vector<float>& prevParam = paramList[t - 1];
+		const std::vector<float>& nextParam = paramList[t];
+		if (prevParam.size() != numParam || nextParam.size() != numParam) {
+			THROW_EXCEPTION(InvalidValueException, "Invalid number of parameters in frame " << t << '.');
+		}
+		for (std::size_t i = 0; i < numParam; ++i) {
+			currentParam[i] = prevParam[i];
+			delta[i] = (nextParam[i] - prevParam[i]) * coef;
+		}
+		for (unsigned int step = 0; step < controlSteps_; ++step) {
+			if (step > 0) {
+				// Do linear interpolation.
+				for (std::size_t i = 0; i < numParam; ++i) {
+					currentParam[i] += delta[i];
+				}
+			}
+			vtm.setAllParameters(currentParam);
+			vtm.execSynthesisStep();
+		}
+
+		output.insert(output.end(), vtmOutputBuffer.begin(), vtmOutputBuffer.end());
+		vtmOutputBuffer.clear();
+	}
+}
+
+void
+OfflineRenderer::validate(const std::vector<std::vector<float>>& paramList, std::vector<float>& output)
+{
+	std::vector<float> serialOutput;
+	renderSerial(paramList, serialOutput);
+
+	// Compare using the scale that will be applied to the output.
+	const float scale = VTM::Util::calculateOutputScale(VTM::Util::maximumAbsoluteValue(serialOutput));
+	const std::size_t n = std::min(output.size(), serialOutput.size());
+	float maxError = 0.0;
+	for (std::size_t i = 0; i < n; ++i) {
+		maxError = std::max(maxError, std::abs(output[i] - serialOutput[i]) * scale);
+	}
+	const std::size_t sizeDiff = std::max(output.size(), serialOutput.size()) - n;
+
+	stats_.validated = true;
+	stats_.maxError = maxError;
+	if (Log::debugEnabled) {
+		std::cout << "[OfflineRenderer::validate] Max. error: " << maxError
+			<< " size difference: " << sizeDiff << std::endl;
+	}
+
+	// The resamplers in the chunks may be in different phases, so the size may differ by a few samples.
+	if (maxError > config_.tolerance || sizeDiff > stats_.numberOfChunks) {
+		std::cerr << "[OfflineRenderer::validate] The parallel result differs from the serial result (max. error: "
+			<< maxError << " size difference: " << sizeDiff << "). Using the serial result." << std::endl;
+		output.swap(serialOutput);
+		stats_.usedSerialResult = true;
+	}
+}
+
+} // namespace GS
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef OFFLINE_RENDERER_H
+#define OFFLINE_RENDERER_H
+
+#include <cstddef> /* std::size_t */
+#include <string>
+#include <vector>
+
+
+
+namespace GS {
+
+class ConfigurationData;
+namespace VTM {
+class VocalTractModel;
+}
+
+// Renders a VTM parameter track, without real-time constraints.
+//
+// The track is split at low-energy frames, and the chunks are rendered in
+// parallel, each with its own vocal tract model. Each model is warmed up with
+// a few frames before the start of its chunk (pre-roll), and the end of each
+// chunk is crossfaded with the start of the next one.
+class OfflineRenderer {
+public:
+	struct Configuration {
+		unsigned int numberOfWorkers; // 0: use the number of hardware threads
+		double minChunkDuration;      // s
+		double prerollDuration;       // s
+		double crossfadeDuration;     // s
+		float silenceThreshold;       // dB - maximum volume at a split point
+		bool validate;                // compare with the serial result (renders the track twice)
+		float tolerance;              // maximum absolute difference in the scaled output
+
+		Configuration()
+			: numberOfWorkers()
+			, minChunkDuration(2.0)
+			, prerollDuration(0.1)
+			, crossfadeDuration(0.005)
+			, silenceThreshold(10.0)
+			, validate()
+			, tolerance(0.05f)
+		{
+		}
+	};
+
+	struct Statistics {
+		unsigned int numberOfChunks;
+		bool validated;
+		float maxError; // valid only if validated == true
+		bool usedSerialResult;
+	};
+
+	OfflineRenderer(const ConfigurationData& vtmConfigData, double controlRate,
+			const Configuration& config=Configuration{});
+	~OfflineRenderer();
+
+	// Indexes of the volume parameters (dB). They are used to find the split points.
+	// If the list is empty, the track is split at regular intervals.
+	void setVolumeParameters(const std::vector<unsigned int>& paramIndexList) { volumeParamList_ = paramIndexList; }
+
+	// The output is not scaled.
+	void render(const std::vector<std::vector<float>>& paramList, std::vector<float>& output);
+	void renderSerial(const std::vector<std::vector<float>>& paramList, std::vector<float>& output);
+
+	// Renders the join of two parts of the track that have been rendered separately,
+	// each with a new vocal tract model. joinFrame is the first frame of the second part.
+	// The model is warmed up with the frames before the join (pre-roll).
+	// bridge receives the transition between the parts, which is in none of them, and
+	// head receives the next transitions, to be crossfaded with the start of the second part.
+	// The output is not scaled.
+	void renderJoin(const std::vector<std::vector<float>>& paramList, std::size_t joinFrame,
+			std::vector<float>& bridge, std::vector<float>& head) const;
+	// Number of frames before and after joinFrame (included) that are used by renderJoin().
+	void joinContext(std::size_t& framesBefore, std::size_t& framesAfter) const;
+
+	// Crossfades the samples of output starting at fadeStart with the start of input,
+	// and appends the remaining samples of input.
+	static void appendWithCrossfade(std::vector<float>& output, std::size_t fadeStart,
+					const std::vector<float>& input);
+
+	// Renders, scales and writes to a WAVE file.
+	void renderToFile(const std::vector<std::vector<float>>& paramList, double outputSampleRate,
+				const std::string& filePath);
+
+	const Statistics& statistics() const { return stats_; }
+	float lastOutputScale() const { return outputScale_; }
+private:
+	struct Chunk {
+		std::size_t firstTransition;
+		std::size_t endTransition;
+		std::vector<float> output;
+		std::size_t mainSize; // the remaining samples are crossfaded with the next chunk
+	};
+
+	OfflineRenderer(const OfflineRenderer&) = delete;
+	OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+	OfflineRenderer(OfflineRenderer&&) = delete;
+	OfflineRenderer& operator=(OfflineRenderer&&) = delete;
+
+	float frameVolume(const std::vector<float>& frame) const;
+	void splitTrack(const std::vector<std::vector<float>>& paramList, std::vector<Chunk>& chunkList) const;
+	void renderChunk(const std::vector<std::vector<float>>& paramList, Chunk& chunk) const;
+	// Transition i interpolates from frame i - 1 to frame i.
+	void renderTransitions(const std::vector<std::vector<float>>& paramList,
+				std::size_t firstTransition, std::size_t endTransition,
+				VTM::VocalTractModel& vtm, std::vector<float>& output) const;
+	void validate(const std::vector<std::vector<float>>& paramList, std::vector<float>& output);
+
+	const ConfigurationData& vtmConfigData_;
+	Configuration config_;
+	unsigned int controlSteps_;
+	double controlRate_;
+	std::vector<unsigned int> volumeParamList_;
+	Statistics stats_;
+	float outputScale_;
+};
+
+} // namespace GS
+
+#endif // OFFLINE_RENDERER_H
@@ -0,0 +1,289 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "ParallelSynthesis.h"
+
+#include <algorithm> /* max, min */
+#include <cmath> /* abs */
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <utility> /* move */
+
+#include "Controller.h"
+#include "Index.h"
+#include "Log.h"
+#include "Model.h"
+#include "ModelSnapshot.h"
+#include "OfflineRenderer.h"
+#include "VTMUtil.h"
+#include "WorkerPool.h"
+
+#define CHUNK_MARKER "/c"
+
+
+
+namespace GS {
+
+struct ParallelSynthesis::Worker {
+	std::unique_ptr<VTMControlModel::Model> model;
+	std::unique_ptr<VTMControlModel::Controller> controller; // references model
+};
+
+ParallelSynthesis::ParallelSynthesis(std::shared_ptr<Index> index, std::shared_ptr<const ModelSnapshot> modelSnapshot,
+					unsigned int numberOfWorkers)
+		: index_(index)
+		, modelSnapshot_(modelSnapshot)
+		, stats_()
+{
+	// The controllers modify the model (formula symbols) during the synthesis,
+	// so each worker needs its own copy.
+	workerList_.resize(WorkerPool::effectiveNumberOfWorkers(numberOfWorkers));
+	for (auto& w : workerList_) {
+		w = std::make_unique<Worker>();
+		w->model = modelSnapshot_->createModel();
+		w->controller = std::make_unique<VTMControlModel::Controller>(*index_, *w->model);
+	}
+}
+
+ParallelSynthesis::~ParallelSynthesis()
+{
+}
+
+unsigned int
+ParallelSynthesis::modelRevision() const
+{
+	return modelSnapshot_->modelRevision();
+}
+
+std::vector<std::string>
+ParallelSynthesis::splitPhoneticString(const std::string& phoneticString)
+{
+	std::vector<std::string> segmentList;
+	std::istringstream in(phoneticString);
+	std::string token;
+	std::string segment;
+	auto addSegment = [&]() {
+		if (!segment.empty()) {
+			segmentList.push_back(CHUNK_MARKER " " + segment + " " CHUNK_MARKER);
+			segment.clear();
+		}
+	};
+	bool chunkMarkerFound = false;
+	while (in >> token) {
+		if (token == CHUNK_MARKER) {
+			chunkMarkerFound = true;
+			addSegment();
+		} else {
+			if (!segment.empty()) segment += ' ';
+			segment += token;
+		}
+	}
+	if (!chunkMarkerFound) {
+		// Nothing to split.
+		segmentList.clear();
+		segmentList.push_back(phoneticString);
+		return segmentList;
+	}
+	addSegment();
+	return segmentList;
+}
+
+void
+ParallelSynthesis::synthesize(const std::function<void(VTMControlModel::Controller&)>& setup,
+				VTMControlModel::Controller& controller, const std::string& phoneticString,
+				const std::string& reuseKey, bool verify,
+				const std::function<void(const std::vector<float>&, std::size_t, std::size_t)>& progress,
+				std::vector<float>& audio, std::vector<std::vector<float>>& vtmParamList)
+{
+	stats_ = Statistics();
+
+	audio.clear();
+	vtmParamList.clear();
+	const std::vector<std::string> segmentList = splitPhoneticString(phoneticString);
+	stats_.numberOfSegments = segmentList.size();
+	if (segmentList.empty()) return;
+
+	// The chunks are synthesized independently, so a segment that is present in
+	// the previous phonetic string can be reused, even if it has moved.
+	if (reuseKey.empty() || reuseKey != reuseKey_) {
+		segmentMap_.clear();
+		joinMap_.clear();
+	}
+	const std::size_t lastSegment = segmentList.size() - 1U;
+	std::vector<std::shared_ptr<const Segment>> resultList(segmentList.size());
+	std::vector<std::size_t> pendingList; // indexes of the segments to synthesize
+	for (std::size_t i = 0; i < lastSegment; ++i) {
+		auto iter = segmentMap_.find(segmentList[i]);
+		if (iter != segmentMap_.end()) {
+			resultList[i] = iter->second;
+			++stats_.numberOfReusedSegments;
+		} else {
+			pendingList.push_back(i);
+		}
+	}
+	pendingList.push_back(lastSegment); // its event list is needed
+
+	for (auto& w : workerList_) {
+		setup(*w->controller);
+	}
+	const auto& config = controller.vtmControlModelConfiguration();
+
+	// Each segment has been rendered by a new vocal tract model, and the transition
+	// from the last frame of a segment to the first frame of the next one is missing.
+	// A join that depends only on the frames of its two segments can be reused.
+	OfflineRenderer renderer(controller.vtmConfigData(), config.controlRate);
+	std::size_t framesBefore, framesAfter;
+	renderer.joinContext(framesBefore, framesAfter);
+	std::vector<std::shared_ptr<const Join>> joinList(lastSegment);
+	std::vector<std::string> joinKeyList(lastSegment);
+	auto getJoin = [&](std::size_t k) -> std::shared_ptr<const Join> {
+		const Segment& prevSegment = *resultList[k];
+		const Segment& nextSegment = *resultList[k + 1U];
+		if (prevSegment.paramList.size() >= framesBefore && nextSegment.paramList.size() >= framesAfter) {
+			joinKeyList[k] = segmentList[k] + '\0' + segmentList[k + 1U];
+			auto iter = joinMap_.find(joinKeyList[k]);
+			if (iter != joinMap_.end()) {
+				++stats_.numberOfReusedJoins;
+				return iter->second;
+			}
+		}
+
+		// The frames around the join. The frames before the join may come from
+		// more than one segment. The frames after the join come only from the
+		// next segment, because the following ones may not be ready.
+		std::vector<std::vector<float>> paramList;
+		std::size_t firstSegment = k;
+		std::size_t numberOfFrames = prevSegment.paramList.size();
+		while (numberOfFrames < framesBefore && firstSegment > 0) {
+			numberOfFrames += resultList[--firstSegment]->paramList.size();
+		}
+		std::size_t skip = (numberOfFrames > framesBefore) ? numberOfFrames - framesBefore : 0;
+		for (std::size_t i = firstSegment; i <= k; ++i) {
+			const auto& segmentParamList = resultList[i]->paramList;
+			const std::size_t first = std::min(skip, segmentParamList.size());
+			skip -= first;
+			paramList.insert(paramList.end(), segmentParamList.begin() + first, segmentParamList.end());
+		}
+		const std::size_t joinFrame = paramList.size();
+		paramList.insert(paramList.end(), nextSegment.paramList.begin(),
+					nextSegment.paramList.begin() + std::min(framesAfter, nextSegment.paramList.size()));
+
+		auto join = std::make_shared<Join>();
+		if (joinFrame > 0 && joinFrame < paramList.size()) {
+			renderer.renderJoin(paramList, joinFrame, join->bridge, join->head);
+		}
+		return join;
+	};
+
+	// The segments are appended to the audio in order, as soon as they and the
+	// previous ones are ready, so the progress can be reported during the synthesis.
+	std::mutex assemblyMutex;
+	std::size_t numberOfAssembledSegments = 0;
+	auto assemble = [&]() { // assemblyMutex must be locked
+		const std::size_t first = audio.size();
+		while (numberOfAssembledSegments < resultList.size() && resultList[numberOfAssembledSegments]) {
+			const std::size_t i = numberOfAssembledSegments++;
+			const Segment& segment = *resultList[i];
+			if (i == 0) {
+				audio.insert(audio.end(), segment.audio.begin(), segment.audio.end());
+				continue;
+			}
+			joinList[i - 1U] = getJoin(i - 1U);
+			const Join& join = *joinList[i - 1U];
+			audio.insert(audio.end(), join.bridge.begin(), join.bridge.end());
+			const std::size_t fadeStart = audio.size();
+			audio.insert(audio.end(), join.head.begin(), join.head.end());
+			OfflineRenderer::appendWithCrossfade(audio, fadeStart, segment.audio);
+		}
+		if (progress && audio.size() > first) {
+			// Assumes that the remaining segments have the average size.
+			progress(audio, first, audio.size() * resultList.size() / numberOfAssembledSegments);
+		}
+	};
+	{
+		std::lock_guard<std::mutex> lock(assemblyMutex);
+		assemble(); // reused segments at the start
+	}
+
+	WorkerPool pool(workerList_.size());
+	pool.run(pendingList.size(), [&](unsigned int workerIndex, std::size_t j) {
+		const std::size_t i = pendingList[j];
+		VTMControlModel::Controller& segmentController = (i == lastSegment) ?
+						controller : *workerList_[workerIndex]->controller;
+		auto segment = std::make_shared<Segment>();
+		segmentController.synthesizePhoneticStringToBuffer(segmentList[i], nullptr, segment->audio);
+		// The controller has scaled the audio of the segment.
+		const float scale = segmentController.outputScale();
+		if (scale > 0.0f) {
+			for (float& sample : segment->audio) {
+				sample /= scale;
+			}
+		}
+		segment->paramList = segmentController.vtmParameterList();
+
+		std::lock_guard<std::mutex> lock(assemblyMutex);
+		resultList[i] = std::move(segment);
+		assemble();
+	});
+
+	for (const auto& segment : resultList) {
+		vtmParamList.insert(vtmParamList.end(), segment->paramList.begin(), segment->paramList.end());
+	}
+
+	// Keep only the segments and joins of the current phonetic string.
+	segmentMap_.clear();
+	joinMap_.clear();
+	reuseKey_ = reuseKey;
+	if (!reuseKey.empty()) {
+		for (std::size_t i = 0; i < segmentList.size(); ++i) {
+			segmentMap_[segmentList[i]] = resultList[i];
+		}
+		for (std::size_t k = 0; k < joinList.size(); ++k) {
+			if (!joinKeyList[k].empty()) {
+				joinMap_[joinKeyList[k]] = joinList[k];
+			}
+		}
+	}
+	const float scale = VTM::Util::calculateOutputScale(VTM::Util::maximumAbsoluteValue(audio));
+	for (float& sample : audio) {
+		sample *= scale;
+	}
+
+	if (verify) {
+		std::vector<float> serialAudio;
+		controller.synthesizePhoneticStringToBuffer(phoneticString, nullptr, serialAudio);
+
+		const std::size_t n = std::min(audio.size(), serialAudio.size());
+		float maxError = 0.0;
+		for (std::size_t i = 0; i < n; ++i) {
+			maxError = std::max(maxError, std::abs(audio[i] - serialAudio[i]));
+		}
+		stats_.verified = true;
+		stats_.maxError = maxError;
+		stats_.sizeDifference = std::max(audio.size(), serialAudio.size()) - n;
+		if (Log::debugEnabled) {
+			std::cout << "[ParallelSynthesis] segments: " << stats_.numberOfSegments
+				<< " reused: " << stats_.numberOfReusedSegments
+				<< " reused joins: " << stats_.numberOfReusedJoins
+				<< " max error: " << stats_.maxError
+				<< " size difference: " << stats_.sizeDifference << std::endl;
+		}
+	}
+}
+
+} // namespace GS
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef PARALLEL_SYNTHESIS_H
+#define PARALLEL_SYNTHESIS_H
+
+#include <cstddef> /* std::size_t */
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace GS {
+
+class Index;
+class ModelSnapshot;
+namespace VTMControlModel {
+class Controller;
+class Model;
+}
+
+// Synthesizes the chunks of a phonetic string in parallel.
+//
+// Each worker has its own copy of the model and its own controller.
+// The VTM parameters of the chunks are concatenated, the joins between
+// the chunks are rendered again with a warmed-up vocal tract model
+// (OfflineRenderer::renderJoin()), and the audio is scaled as a whole.
+// The chunks are appended to the audio in order, while the next ones
+// are being synthesized.
+//
+// The chunks and joins of the previous synthesis are kept, so after an edit
+// only the chunks that have changed and their joins need to be synthesized again.
+// The last chunk is always synthesized, because its event list is needed.
+class ParallelSynthesis {
+public:
+	struct Statistics {
+		unsigned int numberOfSegments;
+		unsigned int numberOfReusedSegments;
+		unsigned int numberOfReusedJoins;
+		bool verified;
+		float maxError;             // valid only if verified == true
+		std::size_t sizeDifference; // samples - valid only if verified == true
+	};
+
+	// The models of the workers are created from the snapshot.
+	// If numberOfWorkers is 0, the number of hardware threads is used.
+	ParallelSynthesis(std::shared_ptr<Index> index, std::shared_ptr<const ModelSnapshot> modelSnapshot,
+				unsigned int numberOfWorkers=0);
+	~ParallelSynthesis();
+
+	const std::shared_ptr<Index>& index() const { return index_; }
+	unsigned int modelRevision() const;
+
+	// Splits the phonetic string at the chunk markers (/c).
+	// Each returned segment is a complete chunk.
+	static std::vector<std::string> splitPhoneticString(const std::string& phoneticString);
+
+	// setup is called for each controller of the workers before the synthesis
+	// (configuration, tempo, intonation). It may be called from any thread.
+	// The last segment is synthesized by controller, which must have been set up,
+	// so its event list is the same as after a serial synthesis (the controller
+	// keeps only the event list of the last chunk).
+	// The audio is scaled. If verify is true, the result is compared with
+	// the serial synthesis using the controller.
+	// reuseKey must identify everything except the phonetic string that affects
+	// the result (configuration, tempo, ...). If it is not empty, the segments
+	// of the previous call with the same key are reused.
+	// If progress is not empty, it is called each time segments are appended
+	// to the audio, with the audio (not scaled), the index of the first new
+	// sample and an estimate of the final number of samples. It may be called
+	// from any thread, but not concurrently.
+	void synthesize(const std::function<void(VTMControlModel::Controller&)>& setup,
+			VTMControlModel::Controller& controller, const std::string& phoneticString,
+			const std::string& reuseKey, bool verify,
+			const std::function<void(const std::vector<float>&, std::size_t, std::size_t)>& progress,
+			std::vector<float>& audio, std::vector<std::vector<float>>& vtmParamList);
+
+	const Statistics& statistics() const { return stats_; }
+private:
+	struct Worker;
+	struct Segment {
+		std::vector<std::vector<float>> paramList;
+		std::vector<float> audio; // not scaled
+	};
+	struct Join {
+		std::vector<float> bridge;
+		std::vector<float> head;
+	};
+
+	ParallelSynthesis(const ParallelSynthesis&) = delete;
+	ParallelSynthesis& operator=(const ParallelSynthesis&) = delete;
+	ParallelSynthesis(ParallelSynthesis&&) = delete;
+	ParallelSynthesis& operator=(ParallelSynthesis&&) = delete;
+
+	std::shared_ptr<Index> index_;
+	std::shared_ptr<const ModelSnapshot> modelSnapshot_;
+	std::vector<std::unique_ptr<Worker>> workerList_;
+	Statistics stats_;
+	std::string reuseKey_;
+	std::unordered_map<std::string, std::shared_ptr<const Segment>> segmentMap_; // segments of the previous call
+	std::unordered_map<std::string, std::shared_ptr<const Join>> joinMap_; // joins of the previous call
+};
+
+} // namespace GS
+
+#endif // PARALLEL_SYNTHESIS_H
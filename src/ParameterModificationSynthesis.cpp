@@ -21,12 +21,15 @@
 #include <cmath> /* rint */
 #include <iostream>
 #include <thread>
+#include <utility> /* move */
 
 #include "ConfigurationData.h"
 #include "Exception.h"
 #include "JackConfig.h"
 #include "Log.h"
+#include "Trace.h"
 #include "VocalTractModel.h"
+#include "VTMParameterFile.h"
 #include "VTMUtil.h"
 
 #define PARAMETER_FILTER_PERIOD_SEC (20.0e-3)
@@ -46,6 +49,7 @@ extern "C" {
 int
 param_modif_jack_process_callback(jack_nframes_t nframes, void* arg)
 {
+	TraceSpan span("param_modif_jack_process", "jack");
 	try {
 		ParameterModificationSynthesis::Processor* p = static_cast<ParameterModificationSynthesis::Processor*>(arg);
 		return p->process(nframes);
@@ -157,7 +161,7 @@ ParameterModificationSynthesis::Processor::process(jack_nframes_t nframes)
 		// Calculate the parameters for the control step.
 		if (stepIndex_ == 0) {
 			// Apply the modification.
-			const float origValue = paramList_[paramSetIndex_][modif_.parameter];
+			const float origValue = originalFrame(paramSetIndex_)[modif_.parameter];
 			if (modif_.operation == OPER_ADD) {
 				modifiedParamList_[paramSetIndex_][modif_.parameter] = origValue + filteredModif;
 			} else if (modif_.operation == OPER_MULTIPLY) {
@@ -207,10 +211,41 @@ ParameterModificationSynthesis::Processor::stop()
  */
 void
 ParameterModificationSynthesis::Processor::resetData(const std::vector<std::vector<float>>& paramList) {
+	mappedFile_.reset();
 	paramList_ = paramList;
 	modifiedParamList_ = paramList_;
 }
 
+/*******************************************************************************
+ *
+ */
+void
+ParameterModificationSynthesis::Processor::resetData(std::shared_ptr<const MappedVTMParameterFile> file)
+{
+	if (file->numberOfParameters() != numParameters_) {
+		THROW_EXCEPTION(InvalidParameterException, "Invalid number of parameters in the file: "
+					<< file->numberOfParameters() << " (expected: " << numParameters_ << ").");
+	}
+
+	modifiedParamList_.resize(file->numberOfFrames());
+	for (std::size_t i = 0, size = modifiedParamList_.size(); i < size; ++i) {
+		const float* frame = file->frame(i);
+		modifiedParamList_[i].assign(frame, frame + numParameters_);
+	}
+	paramList_.clear();
+	paramList_.shrink_to_fit();
+	mappedFile_ = std::move(file);
+}
+
+/*******************************************************************************
+ *
+ */
+const float*
+ParameterModificationSynthesis::Processor::originalFrame(std::size_t index) const
+{
+	return mappedFile_ ? mappedFile_->frame(index) : paramList_[index].data();
+}
+
 /*******************************************************************************
  *
  */
@@ -258,8 +293,8 @@ ParameterModificationSynthesis::Processor::resetParameter(unsigned int parameter
 		THROW_EXCEPTION(InvalidParameterException, "Invalid parameter index:" << parameter << '.');
 	}
 
-	for (std::size_t i = 0, size = paramList_.size(); i < size; ++i) {
-		modifiedParamList_[i][parameter] = paramList_[i][parameter];
+	for (std::size_t i = 0, size = modifiedParamList_.size(); i < size; ++i) {
+		modifiedParamList_[i][parameter] = originalFrame(i)[parameter];
 	}
 }
 
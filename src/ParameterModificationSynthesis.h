@@ -31,6 +31,7 @@
 namespace GS {
 
 class ConfigurationData;
+class MappedVTMParameterFile;
 namespace VTM {
 class VocalTractModel;
 }
@@ -70,6 +71,9 @@ public:
 
 		// These functions can be called by the main thread only when the JACK thread is not running.
 		void resetData(const std::vector<std::vector<float>>& paramList);
+		// The original frames are read from the mapped file, which is kept open.
+		// Only the modified frames are copied.
+		void resetData(std::shared_ptr<const MappedVTMParameterFile> file);
 		bool validData() const;
 		void prepareSynthesis(jack_port_t* jackOutputPort, float gain);
 		template<typename T> void getModifiedParameter(unsigned int parameter, T& paramList) const;
@@ -85,11 +89,14 @@ public:
 		Processor(Processor&&) = delete;
 		Processor& operator=(Processor&&) = delete;
 
+		const float* originalFrame(std::size_t index) const;
+
 		unsigned int numParameters_;
 		std::atomic<jack_port_t*> outputPort_;
 		std::size_t vtmBufferPos_;
 		JackRingbuffer* parameterRingbuffer_;
-		std::vector<std::vector<float>> paramList_;
+		std::vector<std::vector<float>> paramList_; // empty if mappedFile_ is not null
+		std::shared_ptr<const MappedVTMParameterFile> mappedFile_;
 		std::vector<std::vector<float>> modifiedParamList_;
 		std::unique_ptr<VTM::VocalTractModel> vocalTractModel_;
 		std::vector<float> currentParam_;
@@ -166,9 +173,9 @@ ParameterModificationSynthesis::Processor::getParameter(unsigned int parameter,
 		THROW_EXCEPTION(InvalidParameterException, "Invalid parameter index:" << parameter << '.');
 	}
 
-	paramList.resize(paramList_.size());
-	for (std::size_t i = 0, size = paramList_.size(); i < size; ++i) {
-		paramList[i] = paramList_[i][parameter];
+	paramList.resize(modifiedParamList_.size());
+	for (std::size_t i = 0, size = modifiedParamList_.size(); i < size; ++i) {
+		paramList[i] = originalFrame(i)[parameter];
 	}
 }
 
@@ -20,6 +20,8 @@
 #include <QPainter>
 #include <QMouseEvent>
 
+#include "Trace.h"
+
 
 
 namespace GS {
@@ -44,6 +46,8 @@ ParameterModificationWidget::stop()
 void
 ParameterModificationWidget::paintEvent(QPaintEvent* /*event*/)
 {
+	TraceSpan span("ParameterModificationWidget::paintEvent", "paint");
+
 	QPainter painter(this);
 
 	const int xCenter = width() / 2;
@@ -17,8 +17,14 @@
 
 #include "ParameterModificationWindow.h"
 
+#include <algorithm> /* remove */
+#include <cctype> /* tolower */
 #include <cmath> /* pow */
 #include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <QFileDialog>
 #include <QMessageBox>
@@ -26,9 +32,11 @@
 
 #include "Controller.h"
 #include "Model.h"
+#include "OfflineRenderer.h"
 #include "ParameterModificationSynthesis.h"
 #include "Synthesis.h"
 #include "ui_ParameterModificationWindow.h"
+#include "VTMParameterFile.h"
 
 #define DEFAULT_AMPLITUDE (10.0)
 #define ADD_AMPLITUDE_INCREMENT (0.1)
@@ -36,10 +44,32 @@
 #define MAX_AMPLITUDE_SPINBOX_VALUE (60.0)
 #define DEFAULT_OUTPUT_GAIN (0.5)
 #define GAIN_INCREMENT (0.01)
-#define VTM_PARAM_FILE_NAME "generated__modif_vtm_param.txt"
+#define VTM_PARAM_FILE_NAME "generated__modif_vtm_param.vtmp"
 
 
 
+namespace {
+
+// Returns the indexes of the volume parameters (glot_vol, asp_vol, fric_vol).
+std::vector<unsigned int>
+volumeParameterIndexList(const GS::VTMControlModel::Model& model)
+{
+	std::vector<unsigned int> indexList;
+	for (unsigned int i = 0, size = model.parameterList().size(); i < size; ++i) {
+		std::string name = model.parameterList()[i].name();
+		name.erase(std::remove(name.begin(), name.end(), '_'), name.end());
+		for (char& c : name) {
+			c = std::tolower(static_cast<unsigned char>(c));
+		}
+		if (name == "glotvol" || name == "aspvol" || name == "fricvol") {
+			indexList.push_back(i);
+		}
+	}
+	return indexList;
+}
+
+} // namespace
+
 namespace GS {
 
 ParameterModificationWindow::ParameterModificationWindow(QWidget* parent)
@@ -51,6 +81,7 @@ ParameterModificationWindow::ParameterModificationWindow(QWidget* parent)
 		, state_(State::stopped)
 		, modificationValue_()
 		, modificationTimer_(this)
+		, paramSeriesIndex_(-1)
 {
 	ui_->setupUi(this);
 
@@ -79,6 +110,7 @@ ParameterModificationWindow::ParameterModificationWindow(QWidget* parent)
 
 ParameterModificationWindow::~ParameterModificationWindow()
 {
+	if (renderFuture_.valid()) renderFuture_.wait();
 }
 
 void
@@ -129,20 +161,32 @@ ParameterModificationWindow::resetData()
 {
 	if (!model_) return;
 
-	synthesis_->paramModifSynth->processor().resetData(synthesis_->vtmController->vtmParameterList());
-
-	// Fill the x-axis in the parameter graph.
-	modifParamX_.resize(synthesis_->vtmController->vtmParameterList().size());
-	const double period = 1.0 / synthesis_->vtmController->vtmControlModelConfiguration().controlRate;
-	for (std::size_t i = 0, size = modifParamX_.size(); i < size; ++i) {
-		modifParamX_[i] = i * period * 1000.0; // convert to milliseconds
-	}
+	const std::vector<std::vector<float>>& paramList = synthesis_->vtmParamList ?
+				*synthesis_->vtmParamList : synthesis_->vtmController->vtmParameterList();
+	synthesis_->paramModifSynth->processor().resetData(paramList);
+	setupTimeAxis(paramList.size());
 
 	showModifiedParameterData();
 
 	enableWindow();
 }
 
+// Fills the x-axis in the parameter graph.
+void
+ParameterModificationWindow::setupTimeAxis(std::size_t numberOfFrames)
+{
+	auto modifParamX = std::make_shared<std::vector<float>>(numberOfFrames);
+	const double period = 1.0 / synthesis_->vtmController->vtmControlModelConfiguration().controlRate;
+	for (std::size_t i = 0; i < numberOfFrames; ++i) {
+		(*modifParamX)[i] = i * period * 1000.0; // convert to milliseconds
+	}
+	modifParamX_ = std::move(modifParamX);
+
+	// The unmodified parameters have been replaced.
+	paramSeries_.reset();
+	paramSeriesIndex_ = -1;
+}
+
 void
 ParameterModificationWindow::enableInput()
 {
@@ -196,38 +240,109 @@ ParameterModificationWindow::on_synthesizeButton_clicked()
 	synthesisTimer_.start(SYNTH_TIMER_INTERVAL_MS);
 }
 
+// The rendering is executed in a separate thread, using a copy of the parameters.
+// The controller is kept alive, because its configuration is used by the renderer.
 void
 ParameterModificationWindow::on_synthesizeToFileButton_clicked()
 {
-	if (!model_) return;
+	if (!model_ || renderFuture_.valid()) return;
 
 	QString filePath = QFileDialog::getSaveFileName(this, tr("Save file"), synthesis_->appConfig.projectDir, tr("WAV files (*.wav)"));
 	if (filePath.isEmpty()) {
 		return;
 	}
 
+	std::string vtmParamFilePath;
+	if (ui_->saveVTMParamCheckBox->isChecked()) {
+		vtmParamFilePath = (synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME).toStdString();
+	}
+	auto vtmParamList = std::make_shared<std::vector<std::vector<float>>>();
+	std::vector<std::string> paramNameList;
+	try {
+		synthesis_->paramModifSynth->processor().getModifiedParameterList(*vtmParamList);
+		paramNameList = VTMParameterFile::parameterNameList(*model_);
+	} catch (const std::exception& exc) {
+		QMessageBox::critical(this, tr("Error"), exc.what());
+		return;
+	}
+	std::shared_ptr<VTMControlModel::Controller> controller = synthesis_->vtmController;
+	const double controlRate = controller->vtmControlModelConfiguration().controlRate;
+	const double outputSampleRate = controller->outputSampleRate();
+	std::vector<unsigned int> volumeParamList = volumeParameterIndexList(*model_);
+	OfflineRenderer::Configuration config;
+	config.validate = ui_->validateRenderCheckBox->isChecked();
+
 	emit synthesisStarted();
 	disableWindow();
 
-	try {
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
+	renderFuture_ = std::async(std::launch::async,
+			[this, filePath = filePath.toStdString(), vtmParamFilePath, vtmParamList, controller,
+				controlRate, outputSampleRate, paramNameList, volumeParamList, config]() {
+		QString errorMessage;
+		OfflineRenderer::Statistics stats{};
+		try {
+			if (!vtmParamFilePath.empty()) {
+				VTMParameterFile::writeBinary(vtmParamFilePath, controlRate, paramNameList, *vtmParamList);
+			}
+
+			OfflineRenderer renderer(controller->vtmConfigData(), controlRate, config);
+			renderer.setVolumeParameters(volumeParamList);
+			renderer.renderToFile(*vtmParamList, outputSampleRate, filePath);
+			stats = renderer.statistics();
+		} catch (const std::exception& exc) {
+			errorMessage = exc.what();
 		}
+		QMetaObject::invokeMethod(this, [this, errorMessage, stats, tolerance = config.tolerance]() {
+			renderFuture_.get();
+			if (!errorMessage.isEmpty()) {
+				QMessageBox::critical(this, tr("Error"), errorMessage);
+			} else if (stats.validated) {
+				QString msg = tr("Chunks: %1\nMaximum difference from the serial rendering: %2 (tolerance: %3)")
+						.arg(stats.numberOfChunks).arg(stats.maxError).arg(tolerance);
+				if (stats.usedSerialResult) {
+					msg += tr("\nThe serial rendering has been saved.");
+				}
+				QMessageBox::information(this, tr("Synthesis to file"), msg);
+			}
+			enableWindow();
+			emit synthesisFinished();
+		}, Qt::QueuedConnection);
+	});
+}
+
+void
+ParameterModificationWindow::on_loadVTMParamButton_clicked()
+{
+	if (!model_) return;
 
-		std::vector<std::vector<float>> vtmParamList;
-		synthesis_->paramModifSynth->processor().getModifiedParameterList(vtmParamList);
-		synthesis_->vtmController->synthesizeToFile(
-					vtmParamList,
-					saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-					filePath.toStdString().c_str());
-	} catch (const Exception& exc) {
+	QString filePath = QFileDialog::getOpenFileName(this, tr("Load VTM parameters"), synthesis_->appConfig.projectDir,
+								tr("VTM parameter files (*.vtmp)"));
+	if (filePath.isEmpty()) {
+		return;
+	}
+
+	try {
+		// resetData() must not be called during the playback.
+		if (synthesis_->paramModifSynth->processor().running()) return;
+
+		auto file = std::make_shared<const MappedVTMParameterFile>(filePath.toStdString());
+		const double controlRate = synthesis_->vtmController->vtmControlModelConfiguration().controlRate;
+		if (file->controlRate() != controlRate) {
+			THROW_EXCEPTION(VTMParameterFileException, "The control rate of the file (" << file->controlRate()
+						<< " Hz) is different from the current control rate (" << controlRate << " Hz).");
+		}
+		const std::vector<std::string> paramNameList = VTMParameterFile::parameterNameList(*model_);
+		if (file->parameterNameList() != paramNameList) {
+			THROW_EXCEPTION(VTMParameterFileException, "The parameters in the file are different from the parameters in the model.");
+		}
+		synthesis_->paramModifSynth->processor().resetData(file);
+		setupTimeAxis(file->numberOfFrames());
+	} catch (const std::exception& exc) {
 		QMessageBox::critical(this, tr("Error"), exc.what());
+		return;
 	}
 
-	enableWindow();
-	emit synthesisFinished();
+	showModifiedParameterData();
 }
 
 void
@@ -336,22 +451,32 @@ ParameterModificationWindow::checkSynthesis()
 void
 ParameterModificationWindow::showModifiedParameterData()
 {
-	if (!model_ || modifParamX_.empty()) {
+	if (!model_ || !modifParamX_ || modifParamX_->empty()) {
 		clearParameterCurveWidget();
 		return;
 	}
 
 	const int parameter = ui_->parameterComboBox->currentIndex();
-	synthesis_->paramModifSynth->processor().getParameter(parameter, paramY_);
-	synthesis_->paramModifSynth->processor().getModifiedParameter(parameter, modifParamY_);
+	const auto& processor = synthesis_->paramModifSynth->processor();
+	if (!paramSeries_ || paramSeriesIndex_ != parameter) {
+		auto paramY = std::make_shared<std::vector<float>>();
+		processor.getParameter(parameter, *paramY);
+		paramSeries_ = Lab::Figure2DSeries::create(modifParamX_, std::move(paramY));
+		paramSeriesIndex_ = parameter;
+	}
+	auto modifParamY = std::make_shared<std::vector<float>>();
+	processor.getModifiedParameter(parameter, *modifParamY);
+	auto modifParamSeries = Lab::Figure2DSeries::create(modifParamX_, std::move(modifParamY));
 
-	if (paramY_.empty() || modifParamY_.empty()) {
+	if (!paramSeries_ || !modifParamSeries) {
 		clearParameterCurveWidget();
 		return;
 	}
 
-	ui_->parameterCurveWidget->updateData(modifParamX_, paramY_);
-	ui_->parameterCurveWidget->updateData2(modifParamX_, modifParamY_);
+	// The x buffer is shared by the two curves, and the unmodified curve is
+	// published again only when the parameter or the data changes.
+	ui_->parameterCurveWidget->setData(paramSeries_);
+	ui_->parameterCurveWidget->setData2(std::move(modifParamSeries));
 	ui_->parameterCurveWidget->update();
 }
 
@@ -368,6 +493,7 @@ ParameterModificationWindow::setInputEnabled(bool enabled)
 	ui_->synthesizeButton->setEnabled(enabled);
 	ui_->saveVTMParamCheckBox->setEnabled(enabled);
 	ui_->synthesizeToFileButton->setEnabled(enabled);
+	ui_->loadVTMParamButton->setEnabled(enabled);
 }
 
 double
@@ -18,6 +18,8 @@
 #ifndef PARAMETER_MODIFICATION_WINDOW_H
 #define PARAMETER_MODIFICATION_WINDOW_H
 
+#include <cstddef> /* std::size_t */
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -25,6 +27,8 @@
 #include <QVector>
 #include <QWidget>
 
+#include "Figure2DWidget.h"
+
 namespace Ui {
 class ParameterModificationWindow;
 }
@@ -57,6 +61,7 @@ private slots:
 	void on_resetParameterButton_clicked();
 	void on_synthesizeButton_clicked();
 	void on_synthesizeToFileButton_clicked();
+	void on_loadVTMParamButton_clicked();
 	void on_parameterComboBox_currentIndexChanged(int index);
 	void on_addRadioButton_toggled(bool checked);
 	void handleModificationStarted();
@@ -78,6 +83,7 @@ private:
 	ParameterModificationWindow(ParameterModificationWindow&&) = delete;
 	ParameterModificationWindow& operator=(ParameterModificationWindow&&) = delete;
 
+	void setupTimeAxis(std::size_t numberOfFrames);
 	void showModifiedParameterData();
 	void setInputEnabled(bool enabled);
 	double outputGain();
@@ -91,9 +97,10 @@ private:
 	double modificationValue_;
 	QTimer modificationTimer_;
 	QTimer synthesisTimer_;
-	std::vector<double> paramY_;
-	std::vector<double> modifParamX_;
-	std::vector<double> modifParamY_;
+	Lab::Figure2DSeries::Buffer modifParamX_;
+	std::shared_ptr<const Lab::Figure2DSeries> paramSeries_; // unmodified parameter
+	int paramSeriesIndex_;
+	std::future<void> renderFuture_; // synthesis to file
 };
 
 } // namespace GS
@@ -0,0 +1,237 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "ParameterOverviewWidget.h"
+
+#include <algorithm> /* clamp, max, min */
+#include <cmath> /* ceil */
+#include <utility> /* move */
+
+#include <QColor>
+#include <QLineF>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+#include "Trace.h"
+
+#define MARGIN (2.0)
+#define LANE_SPACING (2.0)
+#define OVERVIEW_HEIGHT (64)
+#define VIEW_ALPHA (64)
+
+
+
+namespace GS {
+
+ParameterOverviewWidget::ParameterOverviewWidget(QWidget* parent)
+		: QWidget(parent)
+		, viewStartTime_()
+		, viewDuration_()
+		, dragOffset_()
+		, dragging_()
+{
+	setFixedHeight(OVERVIEW_HEIGHT);
+	setMouseTracking(true);
+	setBackgroundRole(QPalette::Base);
+	setAutoFillBackground(true);
+}
+
+void
+ParameterOverviewWidget::setOverview(std::shared_ptr<const ParameterOverview> overview)
+{
+	overview_ = std::move(overview);
+	image_ = QImage();
+	update();
+}
+
+// Slot.
+void
+ParameterOverviewWidget::setView(double startTime, double duration)
+{
+	if (dragging_) return; // the view is controlled by the mouse
+	if (startTime == viewStartTime_ && duration == viewDuration_) return;
+	viewStartTime_ = startTime;
+	viewDuration_ = duration;
+	update();
+}
+
+double
+ParameterOverviewWidget::timeToX(double time) const
+{
+	return MARGIN + (time / overview_->duration) * (width() - 2.0 * MARGIN);
+}
+
+double
+ParameterOverviewWidget::xToTime(double x) const
+{
+	return ((x - MARGIN) / (width() - 2.0 * MARGIN)) * overview_->duration;
+}
+
+bool
+ParameterOverviewWidget::isInsideView(double x) const
+{
+	const double time = xToTime(x);
+	return time >= viewStartTime_ && time <= viewStartTime_ + viewDuration_;
+}
+
+// Moves the view so that the mouse keeps the same position in it.
+void
+ParameterOverviewWidget::moveView(double x)
+{
+	const double maxStartTime = std::max(overview_->duration - viewDuration_, 0.0);
+	const double startTime = std::clamp(xToTime(x) - dragOffset_, 0.0, maxStartTime);
+	if (startTime == viewStartTime_) return;
+	viewStartTime_ = startTime;
+	update();
+
+	emit viewMoved(startTime);
+}
+
+// Each lane shows the envelope of the signal or of one parameter. The columns
+// of the overview are merged when the widget is narrower.
+void
+ParameterOverviewWidget::renderImage()
+{
+	TraceSpan span("ParameterOverviewWidget::renderImage", "paint");
+
+	const qreal dpr = devicePixelRatioF();
+	image_ = QImage(size() * dpr, QImage::Format_ARGB32_Premultiplied);
+	image_.setDevicePixelRatio(dpr);
+	image_.fill(Qt::transparent);
+	if (!overview_ || overview_->duration <= 0.0 || width() <= 2.0 * MARGIN) return;
+
+	QPainter painter(&image_);
+	const double graphWidth = width() - 2.0 * MARGIN;
+	const int numberOfLanes = 1 + static_cast<int>(overview_->paramEnvelopeList.size());
+	const double laneHeight = (height() - 2.0 * MARGIN - (numberOfLanes - 1) * LANE_SPACING) / numberOfLanes;
+	const double columnsPerPixel = ParameterOverview::NUMBER_OF_COLUMNS / graphWidth;
+
+	QVector<QLineF> lineList;
+	auto drawEnvelope = [&](const std::vector<PeakPyramid::Peak>& envelope, double yTop, float valueMin, float valueMax) {
+		const double yFactor = laneHeight / (valueMax - valueMin);
+		lineList.clear();
+		for (int i = 0, size = static_cast<int>(std::ceil(graphWidth)); i < size; ++i) {
+			const std::size_t first = static_cast<std::size_t>(i * columnsPerPixel);
+			const std::size_t end = std::min(std::max(static_cast<std::size_t>((i + 1) * columnsPerPixel), first + 1U),
+								envelope.size());
+			PeakPyramid::Peak p{valueMax, valueMin}; // empty
+			for (std::size_t j = first; j < end; ++j) {
+				if (envelope[j].min > envelope[j].max) continue;
+				p.min = std::min(p.min, envelope[j].min);
+				p.max = std::max(p.max, envelope[j].max);
+			}
+			if (p.min > p.max) continue;
+			const double x = MARGIN + i + 0.5;
+			lineList.append(QLineF{
+						x, yTop + (valueMax - p.max) * yFactor,
+						x, yTop + (valueMax - p.min) * yFactor + 1.0}); // 1.0 added to show constant values
+		}
+		painter.drawLines(lineList);
+	};
+
+	painter.setPen(Qt::darkGray);
+	drawEnvelope(overview_->signalEnvelope, MARGIN, -1.0f, 1.0f);
+
+	painter.setPen(Qt::black);
+	for (std::size_t i = 0; i < overview_->paramEnvelopeList.size(); ++i) {
+		const double yTop = MARGIN + (i + 1U) * (laneHeight + LANE_SPACING);
+		drawEnvelope(overview_->paramEnvelopeList[i], yTop, 0.0f, 1.0f);
+	}
+}
+
+void
+ParameterOverviewWidget::paintEvent(QPaintEvent* /*event*/)
+{
+	TraceSpan span("ParameterOverviewWidget::paintEvent", "paint");
+
+	if (image_.isNull() || image_.size() != size() * devicePixelRatioF()) {
+		renderImage();
+	}
+
+	QPainter painter(this);
+	painter.drawImage(QPointF(0.0, 0.0), image_);
+	painter.drawRect(0, 0, width() - 1, height() - 1);
+
+	if (!overview_ || overview_->duration <= 0.0 || viewDuration_ <= 0.0) return;
+
+	// Viewport.
+	const double x1 = timeToX(viewStartTime_);
+	const double x2 = timeToX(std::min(viewStartTime_ + viewDuration_, overview_->duration));
+	const QRectF viewRect(QPointF(x1, 0.0), QPointF(std::max(x2, x1 + 1.0), height() - 1.0));
+	QColor color = palette().color(QPalette::Highlight);
+	painter.setPen(color);
+	color.setAlpha(VIEW_ALPHA);
+	painter.fillRect(viewRect, color);
+	painter.drawRect(viewRect);
+}
+
+void
+ParameterOverviewWidget::mousePressEvent(QMouseEvent* event)
+{
+	if (!overview_ || overview_->duration <= 0.0 || viewDuration_ <= 0.0) return;
+	if (event->button() != Qt::LeftButton) return;
+
+#ifdef USING_QT6
+	const double x = event->position().x();
+#else
+	const double x = event->localPos().x();
+#endif
+	if (isInsideView(x)) {
+		dragOffset_ = xToTime(x) - viewStartTime_;
+	} else {
+		// Center the view at the mouse position.
+		dragOffset_ = 0.5 * viewDuration_;
+		moveView(x);
+	}
+	dragging_ = true;
+	setCursor(Qt::ClosedHandCursor);
+}
+
+void
+ParameterOverviewWidget::mouseMoveEvent(QMouseEvent* event)
+{
+	// Note: For mouse move events, event->button() == Qt::NoButton.
+
+	if (!overview_ || overview_->duration <= 0.0 || viewDuration_ <= 0.0) return;
+
+#ifdef USING_QT6
+	const double x = event->position().x();
+#else
+	const double x = event->localPos().x();
+#endif
+	if (dragging_) {
+		moveView(x);
+	} else if (isInsideView(x)) {
+		setCursor(Qt::OpenHandCursor);
+	} else {
+		unsetCursor();
+	}
+}
+
+void
+ParameterOverviewWidget::mouseReleaseEvent(QMouseEvent* event)
+{
+	if (event->button() != Qt::LeftButton || !dragging_) return;
+
+	dragging_ = false;
+	setCursor(Qt::OpenHandCursor);
+}
+
+} // namespace GS
@@ -0,0 +1,87 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef PARAMETER_OVERVIEW_WIDGET_H
+#define PARAMETER_OVERVIEW_WIDGET_H
+
+#include <memory>
+#include <vector>
+
+#include <QImage>
+#include <QWidget>
+
+#include "PeakPyramid.h"
+
+
+
+namespace GS {
+
+// Decimated envelopes of the speech signal and of the selected parameters,
+// for the entire utterance.
+struct ParameterOverview {
+	static constexpr int NUMBER_OF_COLUMNS = 1024;
+
+	double duration{}; // ms
+	// One peak per column. It may have less than NUMBER_OF_COLUMNS peaks.
+	std::vector<PeakPyramid::Peak> signalEnvelope;
+	// One list of NUMBER_OF_COLUMNS peaks per selected parameter, with the values normalized to [0, 1].
+	// The peak is empty (min > max) if the curve is not defined in the column.
+	std::vector<std::vector<PeakPyramid::Peak>> paramEnvelopeList;
+};
+
+// Strip with the overview of the utterance, and a draggable viewport that
+// shows the time range visible in ParameterWidget.
+class ParameterOverviewWidget : public QWidget {
+	Q_OBJECT
+public:
+	explicit ParameterOverviewWidget(QWidget* parent=nullptr);
+	virtual ~ParameterOverviewWidget() = default;
+
+	void setOverview(std::shared_ptr<const ParameterOverview> overview);
+public slots:
+	// startTime, duration: ms
+	void setView(double startTime, double duration);
+signals:
+	void viewMoved(double startTime);
+protected:
+	virtual void paintEvent(QPaintEvent* event);
+	virtual void mousePressEvent(QMouseEvent* event);
+	virtual void mouseMoveEvent(QMouseEvent* event);
+	virtual void mouseReleaseEvent(QMouseEvent* event);
+private:
+	ParameterOverviewWidget(const ParameterOverviewWidget&) = delete;
+	ParameterOverviewWidget& operator=(const ParameterOverviewWidget&) = delete;
+	ParameterOverviewWidget(ParameterOverviewWidget&&) = delete;
+	ParameterOverviewWidget& operator=(ParameterOverviewWidget&&) = delete;
+
+	double timeToX(double time) const;
+	double xToTime(double x) const;
+	bool isInsideView(double x) const;
+	void moveView(double x);
+	void renderImage();
+
+	std::shared_ptr<const ParameterOverview> overview_;
+	QImage image_; // envelopes - rendered again when the overview or the size is changed
+	double viewStartTime_; // ms
+	double viewDuration_; // ms
+	double dragOffset_; // ms - from the start of the view to the mouse position
+	bool dragging_;
+};
+
+} // namespace GS
+
+#endif // PARAMETER_OVERVIEW_WIDGET_H
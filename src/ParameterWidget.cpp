@@ -22,17 +22,27 @@
 
 #include "ParameterWidget.h"
 
+#include <algorithm> /* clamp, max, min, minmax_element */
 #include <cmath>
 #include <cstring> /* strlen */
+#include <utility> /* move */
 
+#include <QLineF>
+#include <QMetaObject>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPointF>
 #include <QRectF>
 #include <QSizePolicy>
+#include <QVector>
+#include <QWheelEvent>
 
 #include "EventList.h"
 #include "Model.h"
+#include "ParameterOverviewWidget.h"
+#include "PeakPyramid.h"
+#include "Spectrogram.h"
+#include "Trace.h"
 
 #define MARGIN (10.0)
 #define SPEECH_SIGNAL_HEIGHT (100.0)
@@ -43,6 +53,16 @@
 #define DEFAULT_TIME_SCALE (0.7)
 #define POINT_RADIUS (2.0)
 #define GRAPH_HIDE_TOLERANCE (0.5)
+#define VISIBLE_RANGE_MARGIN (100.0) /* pixels - space for the text at the left of the exposed area */
+#define TILE_WIDTH (256) /* pixels */
+#define GRAPH_TILE_MARGIN (5.0) /* pixels - space for the curve points above and below the graph */
+#define MAX_NUMBER_OF_TILES (512)
+#define HEADER_LAYER (-1)
+#define SPECTROGRAM_HEIGHT (160.0)
+#define SPECTROGRAM_MAX_FREQUENCY (8000.0) /* Hz */
+#define MAX_SPECTROGRAM_IMAGE_WIDTH (8192) /* pixels - the image is stretched if the lane is wider */
+#define MAX_NUMBER_OF_SPECTROGRAM_IMAGES (8)
+#define SPECTROGRAM_DELAY_MS (300)
 
 
 
@@ -62,22 +82,58 @@ ParameterWidget::ParameterWidget(QWidget* parent)
 		, totalWidth_(MININUM_WIDTH)
 		, totalHeight_(MININUM_HEIGHT)
 		, verticalScrollbarValue_()
-		, horizontalScrollbarValue_()
+		, viewX_()
+		, viewStartTime_(-1.0)
+		, viewDuration_()
+		, playheadTime_(-1.0)
 		, textTotalHeight_()
+		, timeIndexValid_()
+		, timeIndexSorted_()
+		, peakPyramidGeneration_()
+		, peakPyramidPending_()
+		, spectrogramEnabled_()
+		, spectrogramGeneration_()
+		, tileXBase_()
+		, tileXEnd_()
+		, tileTimeScale_()
+		, tileHeaderHeight_()
+		, tileGraphHeight_()
+		, tileDevicePixelRatio_(1.0)
 {
-	setMinimumWidth(totalWidth_);
 	setMinimumHeight(totalHeight_);
 
 	setMouseTracking(true);
+
+	prerenderTimer_.setSingleShot(true);
+	prerenderTimer_.setInterval(0);
+	connect(&prerenderTimer_, &QTimer::timeout, this, &ParameterWidget::prerenderTiles);
+
+	spectrogramTimer_.setSingleShot(true);
+	spectrogramTimer_.setInterval(SPECTROGRAM_DELAY_MS);
+	connect(&spectrogramTimer_, &QTimer::timeout, this, &ParameterWidget::calculateSpectrogram);
+}
+
+ParameterWidget::~ParameterWidget()
+{
+	if (peakPyramidFuture_.valid()) peakPyramidFuture_.wait();
+	if (spectrogramFuture_.valid()) spectrogramFuture_.wait();
 }
 
 
 
 // Note: with no antialiasing, the coordinates in QPointF are rounded to the nearest integer.
+//
+// The header (speech signal, postures and rules) and the parameter graphs are
+// drawn from cached tiles. Only the labels at the left, which follow the
+// horizontal scrollbar, are drawn directly.
 void
-ParameterWidget::paintEvent(QPaintEvent* /*event*/)
+ParameterWidget::paintEvent(QPaintEvent* event)
 {
+	TraceSpan span("ParameterWidget::paintEvent", "paint");
+
 	if (eventList_ == nullptr || eventList_->list().empty()) {
+		// During the synthesis, only the speech signal may be available.
+		paintSpeechSignal(event);
 		return;
 	}
 
@@ -102,7 +158,7 @@ ParameterWidget::paintEvent(QPaintEvent* /*event*/)
 				maxWidth = width;
 			}
 		}
-		labelWidth_ = maxWidth;
+		labelWidth_ = std::max(maxWidth, fm.horizontalAdvance(tr("Spectrogram")));
 
 		modelUpdated_ = false;
 	}
@@ -115,6 +171,9 @@ ParameterWidget::paintEvent(QPaintEvent* /*event*/)
 	} else {
 		xEnd = xBase + eventList_->list().back()->time * timeScale_;
 		yEnd = getGraphBaseY(selectedParamList_.size() - 1U);
+		if (spectrogramEnabled_) {
+			yEnd = getSpectrogramTopY() + SPECTROGRAM_HEIGHT;
+		}
 	}
 	totalWidth_ = std::ceil(xEnd + 3.0 * MARGIN);
 	if (totalWidth_ < MININUM_WIDTH) {
@@ -124,101 +183,46 @@ ParameterWidget::paintEvent(QPaintEvent* /*event*/)
 	if (totalHeight_ < MININUM_HEIGHT) {
 		totalHeight_ = MININUM_HEIGHT;
 	}
-	setMinimumWidth(totalWidth_);
 	setMinimumHeight(totalHeight_);
+	updateView(xBase);
 
 	const double headerBottomY = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + 2.0 * textTotalHeight_;
 	const QPalette pal;
 
-	if (!selectedParamList_.empty()) {
-		// Speech signal.
-		if (speechSignal_ && !speechSignal_->empty()) {
-			const double xCoef = (1000.0 / *speechSamplerate_) * timeScale_; // multiply by 1000.0 to convert to ms
-			QPointF prevPoint{xBase, MARGIN + 0.5 * SPEECH_SIGNAL_HEIGHT + verticalScrollbarValue_};
-			for (std::size_t i = 0, size = speechSignal_->size(); i < size; ++i) {
-				const double x = xBase + i * xCoef;
-				const double y = MARGIN + (1.0 - (*speechSignal_)[i]) * 0.5 * SPEECH_SIGNAL_HEIGHT + verticalScrollbarValue_;
-				painter.drawLine(prevPoint, QPointF{x, y});
-				prevPoint.setX(x);
-				prevPoint.setY(y);
-			}
-		}
-
-		postureTimeList_.clear();
-
-		const double yPosture = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textTotalHeight_ + textYOffset + verticalScrollbarValue_;
-		unsigned int postureIndex = 0;
-		for (const VTMControlModel::Event_ptr& ev : eventList_->list()) {
-			const double x = xBase + ev->time * timeScale_;
-			if (ev->flag) {
-				postureTimeList_.push_back(ev->time);
-				const VTMControlModel::PostureData* postureData = eventList_->getPostureDataAtIndex(postureIndex++);
-				if (postureData) {
-					// Posture name.
-					if (postureData->marked) {
-						painter.drawText(QPointF(x, yPosture), QString(postureData->posture->name().c_str()) + '\'');
-					} else {
-						painter.drawText(QPointF(x, yPosture), postureData->posture->name().c_str());
-					}
-				}
-				// Event vertical lines.
-				for (unsigned int i = 0; i < selectedParamList_.size(); ++i) {
-					const double yBase = getGraphBaseY(i);
-					const double yTop = yBase - graphHeight_;
-					if (yTop < headerBottomY + verticalScrollbarValue_ - GRAPH_HIDE_TOLERANCE) {
-						continue;
-					}
-					painter.drawLine(QPointF(x, yTop), QPointF(x, yBase));
-				}
-			}
+	if (!timeIndexValid_ || eventTimeList_.size() != eventList_->list().size()) {
+		updateTimeIndex();
+	}
+	setupTileLayout(xBase, xEnd, headerBottomY);
+
+	painter.translate(-viewX_, 0.0);
+	const QRect rect = event->rect().translated(viewX_, 0);
+	const int firstColumn = std::max(rect.left(), 0) / TILE_WIDTH;
+	const int lastColumn = std::max(rect.right(), 0) / TILE_WIDTH;
+	prerenderList_.clear();
+	auto drawTiles = [&](int layer, double y, double height) {
+		if (y + height < rect.top() || y > rect.bottom() + 1) return;
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			painter.drawImage(QPointF(column * TILE_WIDTH, y), tile(layer, column));
 		}
+		if (firstColumn > 0) prerenderList_.emplace_back(layer, firstColumn - 1);
+		prerenderList_.emplace_back(layer, lastColumn + 1);
+	};
 
-		const double yRuleText = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textYOffset + verticalScrollbarValue_;
-
-		for (int i = 0; i < eventList_->numberOfRules(); ++i) {
-			const auto* ruleData = eventList_->getRuleDataAtIndex(i);
-			if (ruleData) {
-				const unsigned int firstPosture = ruleData->firstPosture;
-				const unsigned int lastPosture = ruleData->lastPosture;
-
-				int postureTime1, postureTime2;
-				if (firstPosture < postureTimeList_.size()) {
-					postureTime1 = postureTimeList_[firstPosture];
-				} else {
-					postureTime1 = 0; // invalid
-				}
-				if (lastPosture < postureTimeList_.size()) {
-					postureTime2 = postureTimeList_[lastPosture];
-				} else {
-					postureTime2 = postureTime1 + ruleData->duration;
-				}
-
-				const double xPost1 = xBase + postureTime1 * timeScale_;
-				const double xPost2 = xBase + postureTime2 * timeScale_;
-				// Rule frame.
-				painter.drawRect(QRectF(
-						QPointF(xPost1, MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + verticalScrollbarValue_),
-						QPointF(xPost2, MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textTotalHeight_ + verticalScrollbarValue_)));
-				// Rule number.
-				painter.drawText(QPointF(xPost1 + TEXT_MARGIN, yRuleText), QString::number(ruleData->number));
-			}
-		}
+	if (!selectedParamList_.empty()) {
+		drawTiles(HEADER_LAYER, verticalScrollbarValue_, tileHeaderHeight_);
 
 		// Background for "Rule" label.
 		painter.fillRect(QRectF(
-					QPointF(horizontalScrollbarValue_                 , verticalScrollbarValue_),
-					QPointF(xBase - MARGIN + horizontalScrollbarValue_, headerBottomY + graphHeight_ + MARGIN + verticalScrollbarValue_)
+					QPointF(viewX_                 , verticalScrollbarValue_),
+					QPointF(xBase - MARGIN + viewX_, headerBottomY + graphHeight_ + MARGIN + verticalScrollbarValue_)
 					), pal.window());
 
+		const double yRuleText = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textYOffset + verticalScrollbarValue_;
 		QString ruleLabel = tr("Rule");
-		painter.drawText(QPointF(MARGIN + (labelWidth_ - fm.horizontalAdvance(ruleLabel)) + horizontalScrollbarValue_, yRuleText), ruleLabel);
+		painter.drawText(QPointF(MARGIN + (labelWidth_ - fm.horizontalAdvance(ruleLabel)) + viewX_, yRuleText), ruleLabel);
 	}
 
-	const QPen pen;
-	QPen pen2;
-	pen2.setWidth(2);
-
-	const double xText = MARGIN + horizontalScrollbarValue_;
+	const double xText = MARGIN + viewX_;
 
 	for (unsigned int i = 0; i < selectedParamList_.size(); ++i) {
 		const double yBase = getGraphBaseY(i);
@@ -231,79 +235,331 @@ ParameterWidget::paintEvent(QPaintEvent* /*event*/)
 		const double currentMin = model_->parameterList()[paramIndex].minimum();
 		const double currentMax = model_->parameterList()[paramIndex].maximum();
 
-		// Graph frame.
-		painter.drawLine(QPointF(xBase, yTop) , QPointF(xEnd , yTop));
-		painter.drawLine(QPointF(xBase, yBase), QPointF(xEnd , yBase));
-		painter.drawLine(QPointF(xBase, yTop) , QPointF(xBase, yBase));
-		painter.drawLine(QPointF(xEnd , yTop) , QPointF(xEnd , yBase));
+		drawTiles(paramIndex, yTop - GRAPH_TILE_MARGIN, graphHeight_ + 2.0 * GRAPH_TILE_MARGIN);
 
-		// Graph curve.
-		painter.setPen(pen2);
-		painter.setRenderHint(QPainter::Antialiasing);
-		QPointF prevPoint;
-		const double valueFactor = 1.0 / (currentMax - currentMin);
+		// Background for labels and limits.
+		painter.fillRect(QRectF(
+					QPointF(viewX_                 , yTop  - MARGIN),
+					QPointF(xBase - MARGIN + viewX_, yBase + MARGIN)
+					), pal.window());
 
-		// Normal events.
-		for (const VTMControlModel::Event_ptr& ev : eventList_->list()) {
-			const double x = 0.5 + xBase + ev->time * timeScale_; // 0.5 added because of antialiasing
-			const double value = ev->getParameter(paramIndex, false);
-			if (value != VTMControlModel::Event::EMPTY_PARAMETER) {
-				const double y = 0.5 + yBase - (value - currentMin) * valueFactor * graphHeight_; // 0.5 added because of antialiasing
-				const QPointF point(x, y);
-				if (!prevPoint.isNull()) {
-					painter.drawLine(prevPoint, point);
-				}
-				painter.drawEllipse(point, POINT_RADIUS, POINT_RADIUS);
-				prevPoint.setX(x);
-				prevPoint.setY(y);
-			}
+		// Label.
+		painter.drawText(QPointF(xText, yBase - 0.5 * graphHeight_), model_->parameterList()[paramIndex].name().c_str());
+		// Limits.
+		painter.drawText(QPointF(xText, yBase)                            , QString("%1").arg(currentMin, maxLabelSize_));
+		painter.drawText(QPointF(xText, yBase - graphHeight_ + fontAscent), QString("%1").arg(currentMax, maxLabelSize_));
+	}
+
+	// Spectrogram lane.
+	if (spectrogramEnabled_ && spectrogram_ && spectrogram_->numberOfFrames() > 0 && !selectedParamList_.empty()) {
+		const double yTop = getSpectrogramTopY();
+		const double yBase = yTop + SPECTROGRAM_HEIGHT;
+		if (yTop >= headerBottomY + verticalScrollbarValue_ - GRAPH_HIDE_TOLERANCE &&
+				yTop <= rect.bottom() + 1 && yBase >= rect.top()) {
+			const double width = spectrogram_->signalDuration() * 1000.0 * timeScale_; // convert to ms
+			painter.drawImage(QRectF(xBase, yTop, width, SPECTROGRAM_HEIGHT), spectrogramImage());
+			painter.drawRect(QRectF(QPointF(xBase, yTop), QPointF(xBase + width, yBase)));
+
+			// Background for label and limits.
+			painter.fillRect(QRectF(
+						QPointF(viewX_                 , yTop  - MARGIN),
+						QPointF(xBase - MARGIN + viewX_, yBase + MARGIN)
+						), pal.window());
+			painter.drawText(QPointF(xText, yTop + 0.5 * SPECTROGRAM_HEIGHT), tr("Spectrogram"));
+			const double maxFrequency = std::min(SPECTROGRAM_MAX_FREQUENCY, 0.5 * spectrogram_->sampleRate());
+			painter.drawText(QPointF(xText, yBase)             , QString("%1 Hz").arg(0));
+			painter.drawText(QPointF(xText, yTop + fontAscent) , QString("%1 Hz").arg(maxFrequency));
 		}
-		// Constant value until the end.
-		if (!prevPoint.isNull()) {
-			const QPointF point(xEnd, prevPoint.y());
-			painter.drawLine(prevPoint, point);
+	}
+
+	// Playhead.
+	if (playheadTime_ >= 0.0 && !selectedParamList_.empty()) {
+		const double x = xBase + playheadTime_ * timeScale_;
+		if (x >= xBase + viewX_) { // not under the labels
+			painter.setPen(Qt::blue);
+			painter.drawLine(QPointF(x, MARGIN), QPointF(x, yEnd));
 		}
+	}
+
+	if (!prerenderList_.empty() && !prerenderTimer_.isActive()) {
+		prerenderTimer_.start();
+	}
+}
+
+// Draws only the speech signal and the playhead, without tiles.
+void
+ParameterWidget::paintSpeechSignal(QPaintEvent* event)
+{
+	if (!speechSignal_ || speechSignal_->empty() || !speechSamplerate_ || *speechSamplerate_ <= 0.0) {
+		return;
+	}
+
+	const double xBase = 3.0 * MARGIN + labelWidth_;
+	const double xEnd = xBase + speechSignal_->size() * (1000.0 / *speechSamplerate_) * timeScale_; // convert to ms
+	totalWidth_ = std::max(static_cast<int>(std::ceil(xEnd + 3.0 * MARGIN)), MININUM_WIDTH);
+	updateView(xBase);
+
+	QPainter painter(this);
+	painter.translate(-viewX_, 0.0);
+	drawSpeechSignal(painter, event->rect().translated(viewX_, 0), xBase);
 
-		// Special events.
-		prevPoint.setX(0.0); prevPoint.setY(0.0);
-		pen2.setColor(Qt::red);
-		painter.setPen(pen2);
-		for (const VTMControlModel::Event_ptr& ev : eventList_->list()) {
-			const double x = 0.5 + xBase + ev->time * timeScale_; // 0.5 added because of antialiasing
-			const double value = ev->getParameter(paramIndex, true);
+	if (playheadTime_ >= 0.0) {
+		const double x = xBase + playheadTime_ * timeScale_;
+		painter.setPen(Qt::blue);
+		painter.drawLine(QPointF(x, MARGIN), QPointF(x, MARGIN + SPEECH_SIGNAL_HEIGHT));
+	}
+}
+
+// Discards the tiles if the layout has changed.
+void
+ParameterWidget::setupTileLayout(double xBase, double xEnd, double headerBottomY)
+{
+	const qreal dpr = devicePixelRatioF();
+	if (xBase != tileXBase_ || xEnd != tileXEnd_ || timeScale_ != tileTimeScale_ ||
+			headerBottomY != tileHeaderHeight_ || dpr != tileDevicePixelRatio_) {
+		invalidateTiles(true, true);
+	} else if (graphHeight_ != tileGraphHeight_) {
+		invalidateTiles(false, true);
+	}
+	tileXBase_ = xBase;
+	tileXEnd_ = xEnd;
+	tileTimeScale_ = timeScale_;
+	tileHeaderHeight_ = headerBottomY;
+	tileGraphHeight_ = graphHeight_;
+	tileDevicePixelRatio_ = dpr;
+}
+
+void
+ParameterWidget::invalidateTiles(bool header, bool graphs)
+{
+	if (header && graphs) {
+		tileMap_.clear();
+		return;
+	}
+	for (auto iter = tileMap_.begin(); iter != tileMap_.end(); ) {
+		if ((iter->first.first == HEADER_LAYER) ? header : graphs) {
+			iter = tileMap_.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+// Discards the header tiles that contain x or are at its right.
+void
+ParameterWidget::invalidateHeaderTiles(double x)
+{
+	const int firstColumn = std::max(static_cast<int>(std::floor(x / TILE_WIDTH)), 0);
+	auto iter = tileMap_.lower_bound(std::make_pair(HEADER_LAYER, firstColumn));
+	while (iter != tileMap_.end() && iter->first.first == HEADER_LAYER) {
+		iter = tileMap_.erase(iter);
+	}
+}
+
+// layer: HEADER_LAYER or parameter index.
+QImage
+ParameterWidget::tile(int layer, int column)
+{
+	const auto key = std::make_pair(layer, column);
+	auto iter = tileMap_.find(key);
+	if (iter != tileMap_.end()) {
+		return iter->second;
+	}
+
+	if (tileMap_.size() >= MAX_NUMBER_OF_TILES) {
+		tileMap_.clear();
+	}
+	QImage image = (layer == HEADER_LAYER) ? renderHeaderTile(column) : renderGraphTile(layer, column);
+	tileMap_[key] = image;
+	return image;
+}
+
+QImage
+ParameterWidget::createTileImage(double height) const
+{
+	QImage image(QSize(TILE_WIDTH, static_cast<int>(std::ceil(height))) * tileDevicePixelRatio_,
+			QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(tileDevicePixelRatio_);
+	image.fill(Qt::transparent);
+	return image;
+}
+
+// Speech signal, posture names and rules. The origin is at the top of the widget.
+QImage
+ParameterWidget::renderHeaderTile(int column)
+{
+	TraceSpan span("ParameterWidget::renderHeaderTile", "paint");
+
+	QImage image = createTileImage(tileHeaderHeight_);
+	QPainter painter(&image);
+	painter.setFont(QFont("monospace"));
+	const QFontMetrics fm = painter.fontMetrics();
+	const int textYOffset = fm.ascent() + fm.leading() + 1;
+	const int x0 = column * TILE_WIDTH;
+	painter.translate(-x0, 0.0);
+	const double xBase = tileXBase_;
+
+	drawSpeechSignal(painter, QRect(x0, 0, TILE_WIDTH, image.height()), xBase);
+
+	// Time range of the tile (ms).
+	const double time1 = (x0 - VISIBLE_RANGE_MARGIN - xBase) / timeScale_;
+	const double time2 = (x0 + TILE_WIDTH + MARGIN - xBase) / timeScale_;
+	std::size_t firstEvent, endEvent;
+	getEventRange(time1, time2, firstEvent, endEvent);
+	const auto& list = eventList_->list();
+
+	const double yPosture = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textTotalHeight_ + textYOffset;
+	for (std::size_t j = firstEvent; j < endEvent; ++j) {
+		const int postureIndex = eventPostureIndexList_[j];
+		if (postureIndex < 0) continue;
+		const double x = xBase + list[j]->time * timeScale_;
+		const VTMControlModel::PostureData* postureData = eventList_->getPostureDataAtIndex(postureIndex);
+		if (postureData) {
+			// Posture name.
+			if (postureData->marked) {
+				painter.drawText(QPointF(x, yPosture), QString(postureData->posture->name().c_str()) + '\'');
+			} else {
+				painter.drawText(QPointF(x, yPosture), postureData->posture->name().c_str());
+			}
+		}
+	}
+
+	const double yRuleText = MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textYOffset;
+
+	// The rules are sequential, so the first visible rule is the first that ends after time1.
+	auto ruleIter = ruleSpanList_.begin();
+	if (timeIndexSorted_) {
+		ruleIter = std::lower_bound(ruleSpanList_.begin(), ruleSpanList_.end(), time1,
+						[](const RuleSpan& rule, double time) { return rule.time2 < time; });
+	}
+	for ( ; ruleIter != ruleSpanList_.end(); ++ruleIter) {
+		if (timeIndexSorted_ && ruleIter->time1 > time2) break;
+
+		const double xPost1 = xBase + ruleIter->time1 * timeScale_;
+		const double xPost2 = xBase + ruleIter->time2 * timeScale_;
+		// Rule frame.
+		painter.drawRect(QRectF(
+				QPointF(xPost1, MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT),
+				QPointF(xPost2, MARGIN * 2.0 + SPEECH_SIGNAL_HEIGHT + textTotalHeight_)));
+		// Rule number.
+		painter.drawText(QPointF(xPost1 + TEXT_MARGIN, yRuleText), QString::number(ruleIter->number));
+	}
+
+	return image;
+}
+
+// Event lines, frame and curves of one parameter. The origin is GRAPH_TILE_MARGIN
+// pixels above the top of the graph.
+QImage
+ParameterWidget::renderGraphTile(unsigned int paramIndex, int column)
+{
+	TraceSpan span("ParameterWidget::renderGraphTile", "paint");
+
+	QImage image = createTileImage(tileGraphHeight_ + 2.0 * GRAPH_TILE_MARGIN);
+	QPainter painter(&image);
+	const int x0 = column * TILE_WIDTH;
+	painter.translate(-x0, 0.0);
+	const double xBase = tileXBase_;
+	const double xEnd = tileXEnd_;
+	const double yTop = GRAPH_TILE_MARGIN;
+	const double yBase = yTop + graphHeight_;
+
+	const double time1 = (x0 - MARGIN - xBase) / timeScale_;
+	const double time2 = (x0 + TILE_WIDTH + MARGIN - xBase) / timeScale_;
+	std::size_t firstEvent, endEvent;
+	getEventRange(time1, time2, firstEvent, endEvent);
+	const auto& list = eventList_->list();
+
+	// Event vertical lines.
+	for (std::size_t j = firstEvent; j < endEvent; ++j) {
+		if (eventPostureIndexList_[j] < 0) continue;
+		const double x = xBase + list[j]->time * timeScale_;
+		painter.drawLine(QPointF(x, yTop), QPointF(x, yBase));
+	}
+
+	const double currentMin = model_->parameterList()[paramIndex].minimum();
+	const double currentMax = model_->parameterList()[paramIndex].maximum();
+
+	// Graph frame.
+	painter.drawLine(QPointF(xBase, yTop) , QPointF(xEnd , yTop));
+	painter.drawLine(QPointF(xBase, yBase), QPointF(xEnd , yBase));
+	painter.drawLine(QPointF(xBase, yTop) , QPointF(xBase, yBase));
+	painter.drawLine(QPointF(xEnd , yTop) , QPointF(xEnd , yBase));
+
+	// Graph curve.
+	QPen pen2;
+	pen2.setWidth(2);
+	painter.setPen(pen2);
+	painter.setRenderHint(QPainter::Antialiasing);
+	const double valueFactor = 1.0 / (currentMax - currentMin);
+
+	// Draws the points in [firstEvent, endEvent), and the lines that connect
+	// them to the nearest points outside the range.
+	auto drawCurve = [&](bool special) {
+		auto getPoint = [&](std::size_t j, double value) {
+			const double x = 0.5 + xBase + list[j]->time * timeScale_; // 0.5 added because of antialiasing
+			const double y = 0.5 + yBase - (value - currentMin) * valueFactor * graphHeight_; // 0.5 added because of antialiasing
+			return QPointF(x, y);
+		};
+		QPointF prevPoint;
+		for (std::size_t j = firstEvent; j > 0; --j) {
+			const double value = list[j - 1U]->getParameter(paramIndex, special);
+			if (value != VTMControlModel::Event::EMPTY_PARAMETER) {
+				prevPoint = getPoint(j - 1U, value);
+				break;
+			}
+		}
+		bool lastPointDrawn = true;
+		for (std::size_t j = firstEvent, size = list.size(); j < size; ++j) {
+			const double value = list[j]->getParameter(paramIndex, special);
 			if (value != VTMControlModel::Event::EMPTY_PARAMETER) {
-				const double y = 0.5 + yBase - (value - currentMin) * valueFactor * graphHeight_; // 0.5 added because of antialiasing
-				const QPointF point(x, y);
+				const QPointF point = getPoint(j, value);
 				if (!prevPoint.isNull()) {
 					painter.drawLine(prevPoint, point);
 				}
+				if (j >= endEvent) {
+					lastPointDrawn = false;
+					break;
+				}
 				painter.drawEllipse(point, POINT_RADIUS, POINT_RADIUS);
-				prevPoint.setX(x);
-				prevPoint.setY(y);
+				prevPoint = point;
 			}
 		}
 		// Constant value until the end.
-		if (!prevPoint.isNull()) {
+		if (lastPointDrawn && !prevPoint.isNull()) {
 			const QPointF point(xEnd, prevPoint.y());
 			painter.drawLine(prevPoint, point);
 		}
-		pen2.setColor(Qt::black);
+	};
 
-		painter.setRenderHint(QPainter::Antialiasing, false);
-		painter.setPen(pen);
+	// Normal events.
+	drawCurve(false);
 
-		// Background for labels and limits.
-		painter.fillRect(QRectF(
-					QPointF(horizontalScrollbarValue_                 , yTop  - MARGIN),
-					QPointF(xBase - MARGIN + horizontalScrollbarValue_, yBase + MARGIN)
-					), pal.window());
+	// Special events.
+	pen2.setColor(Qt::red);
+	painter.setPen(pen2);
+	drawCurve(true);
 
-		// Label.
-		painter.drawText(QPointF(xText, yBase - 0.5 * graphHeight_), model_->parameterList()[paramIndex].name().c_str());
-		// Limits.
-		painter.drawText(QPointF(xText, yBase)                            , QString("%1").arg(currentMin, maxLabelSize_));
-		painter.drawText(QPointF(xText, yBase - graphHeight_ + fontAscent), QString("%1").arg(currentMax, maxLabelSize_));
+	return image;
+}
+
+// Slot.
+//
+// Renders the tiles next to the visible ones, so they are ready when the user scrolls.
+void
+ParameterWidget::prerenderTiles()
+{
+	if (eventList_ == nullptr || eventList_->list().empty() || !model_) {
+		prerenderList_.clear();
+		return;
+	}
+	const int maxColumn = static_cast<int>(std::ceil(totalWidth_ / static_cast<double>(TILE_WIDTH)));
+	for (const auto& key : prerenderList_) {
+		if (key.second >= maxColumn) continue;
+		if (key.first != HEADER_LAYER && static_cast<unsigned int>(key.first) >= model_->parameterList().size()) continue;
+		tile(key.first, key.second);
 	}
+	prerenderList_.clear();
 }
 
 void
@@ -318,15 +574,18 @@ ParameterWidget::mouseMoveEvent(QMouseEvent* event)
 	}
 
 #ifdef USING_QT6
-	const double x = event->position().x();
+	const double x = event->position().x() + viewX_;
 	const double y = event->position().y();
 #else
-	const double x = event->x();
+	const double x = event->x() + viewX_;
 	const double y = event->y();
 #endif
 	const double xBase = 3.0 * MARGIN + labelWidth_;
 
-	double xEnd = xBase + eventList_->list().back()->time * timeScale_;
+	if (!timeIndexValid_ || eventTimeList_.size() != eventList_->list().size()) {
+		updateTimeIndex();
+	}
+	double xEnd = xBase + eventTimeList_.back() * timeScale_;
 
 	if (x < xBase || x > xEnd) {
 		emit mouseMoved(time, value);
@@ -349,6 +608,16 @@ ParameterWidget::mouseMoveEvent(QMouseEvent* event)
 		}
 	}
 
+	if (spectrogramEnabled_ && spectrogram_) {
+		const double yTop = getSpectrogramTopY();
+		const double yBase = yTop + SPECTROGRAM_HEIGHT;
+		if (yTop <= y && y <= yBase) {
+			const double maxFrequency = std::min(SPECTROGRAM_MAX_FREQUENCY, 0.5 * spectrogram_->sampleRate());
+			value = ((yBase - y) / SPECTROGRAM_HEIGHT) * maxFrequency;
+			time = (x - xBase) / timeScale_;
+		}
+	}
+
 	emit mouseMoved(time, value);
 }
 
@@ -356,7 +625,7 @@ void
 ParameterWidget::mouseDoubleClickEvent(QMouseEvent* /*event*/)
 {
 	// Reset zoom.
-	timeScale_ = DEFAULT_TIME_SCALE;
+	setTimeScale(DEFAULT_TIME_SCALE);
 	graphHeight_ = DEFAULT_GRAPH_HEIGHT;
 
 	update();
@@ -364,6 +633,363 @@ ParameterWidget::mouseDoubleClickEvent(QMouseEvent* /*event*/)
 	emit zoomReset();
 }
 
+// Horizontal scrolling. The vertical scrolling is done by the scroll area.
+void
+ParameterWidget::wheelEvent(QWheelEvent* event)
+{
+	const int delta = event->angleDelta().x();
+	if (delta == 0) {
+		event->ignore();
+		return;
+	}
+	viewX_ -= delta;
+	update();
+}
+
+void
+ParameterWidget::updateTimeIndex()
+{
+	eventTimeList_.clear();
+	eventPostureIndexList_.clear();
+	postureTimeList_.clear();
+	ruleSpanList_.clear();
+	timeIndexSorted_ = false;
+	timeIndexValid_ = true;
+	invalidateTiles(true, true);
+	if (!eventList_) return;
+
+	for (const VTMControlModel::Event_ptr& ev : eventList_->list()) {
+		eventTimeList_.push_back(ev->time);
+		if (ev->flag) {
+			eventPostureIndexList_.push_back(static_cast<int>(postureTimeList_.size()));
+			postureTimeList_.push_back(ev->time);
+		} else {
+			eventPostureIndexList_.push_back(-1);
+		}
+	}
+
+	for (int i = 0; i < eventList_->numberOfRules(); ++i) {
+		const auto* ruleData = eventList_->getRuleDataAtIndex(i);
+		if (ruleData) {
+			const unsigned int firstPosture = ruleData->firstPosture;
+			const unsigned int lastPosture = ruleData->lastPosture;
+
+			int postureTime1, postureTime2;
+			if (firstPosture < postureTimeList_.size()) {
+				postureTime1 = postureTimeList_[firstPosture];
+			} else {
+				postureTime1 = 0; // invalid
+			}
+			if (lastPosture < postureTimeList_.size()) {
+				postureTime2 = postureTimeList_[lastPosture];
+			} else {
+				postureTime2 = postureTime1 + ruleData->duration;
+			}
+			ruleSpanList_.push_back(RuleSpan{postureTime1, postureTime2, static_cast<int>(ruleData->number)});
+		}
+	}
+
+	timeIndexSorted_ = std::is_sorted(eventTimeList_.begin(), eventTimeList_.end()) &&
+		std::is_sorted(ruleSpanList_.begin(), ruleSpanList_.end(),
+				[](const RuleSpan& a, const RuleSpan& b) { return a.time1 < b.time1; }) &&
+		std::is_sorted(ruleSpanList_.begin(), ruleSpanList_.end(),
+				[](const RuleSpan& a, const RuleSpan& b) { return a.time2 < b.time2; });
+}
+
+void
+ParameterWidget::getEventRange(double time1, double time2, std::size_t& first, std::size_t& end) const
+{
+	if (!timeIndexSorted_) {
+		first = 0;
+		end = eventTimeList_.size();
+		return;
+	}
+	first = std::lower_bound(eventTimeList_.begin(), eventTimeList_.end(), time1) - eventTimeList_.begin();
+	if (first > 0) --first;
+	end = std::upper_bound(eventTimeList_.begin(), eventTimeList_.end(), time2) - eventTimeList_.begin();
+	if (end < eventTimeList_.size()) ++end;
+}
+
+// Only the columns in rect are drawn.
+// When zoomed out, each column is drawn with one vertical line, using the peak pyramid.
+void
+ParameterWidget::drawSpeechSignal(QPainter& painter, const QRect& rect, double xBase)
+{
+	if (!speechSignal_ || speechSignal_->empty() || !speechSamplerate_ || *speechSamplerate_ <= 0.0) {
+		return;
+	}
+	const std::vector<float>& signal = *speechSignal_;
+	const double xCoef = (1000.0 / *speechSamplerate_) * timeScale_; // multiply by 1000.0 to convert to ms
+	const double samplesPerPixel = 1.0 / xCoef;
+	auto yCoord = [&](float value) {
+		return MARGIN + (1.0 - value) * 0.5 * SPEECH_SIGNAL_HEIGHT;
+	};
+	auto sampleIndex = [&](double x) -> std::size_t {
+		const double i = std::floor((x - xBase) * samplesPerPixel);
+		return i <= 0.0 ? 0 : std::min(static_cast<std::size_t>(i), signal.size());
+	};
+
+	const double xFirst = std::max(xBase, static_cast<double>(rect.left()));
+	const double xEnd = std::min(xBase + signal.size() * xCoef, static_cast<double>(rect.right() + 1));
+	if (xFirst >= xEnd) return;
+
+	QVector<QLineF> lineList;
+	const int level = peakPyramid_ ? peakPyramid_->selectLevel(samplesPerPixel) : -1;
+	if (level < 0) {
+		if (samplesPerPixel >= PeakPyramid::baseBlockSize() && signal.size() > PeakPyramid::baseBlockSize()) {
+			return; // the pyramid is being built
+		}
+		// Draw the samples, including one sample outside on each side.
+		std::size_t first = sampleIndex(xFirst);
+		if (first > 0) --first;
+		const std::size_t end = std::min(sampleIndex(xEnd) + 2U, signal.size());
+		lineList.reserve(static_cast<int>(end - first));
+		QPointF prevPoint{xBase + first * xCoef, yCoord(signal[first])};
+		for (std::size_t i = first + 1U; i < end; ++i) {
+			const QPointF point{xBase + i * xCoef, yCoord(signal[i])};
+			lineList.append(QLineF{prevPoint, point});
+			prevPoint = point;
+		}
+	} else {
+		lineList.reserve(static_cast<int>(xEnd - xFirst) + 1);
+		bool hasPrev = false;
+		PeakPyramid::Peak prev{};
+		for (double x = std::floor(xFirst); x < xEnd; x += 1.0) {
+			const std::size_t first = sampleIndex(x);
+			const std::size_t end = std::max(sampleIndex(x + 1.0), first + 1U);
+			if (first >= signal.size()) break;
+			PeakPyramid::Peak p = peakPyramid_->peak(level, first, end);
+			// Connect with the previous column.
+			const PeakPyramid::Peak range = hasPrev ?
+				PeakPyramid::Peak{std::min(p.min, prev.max), std::max(p.max, prev.min)} : p;
+			lineList.append(QLineF{x, yCoord(range.max), x, yCoord(range.min)});
+			prev = p;
+			hasPrev = true;
+		}
+	}
+	painter.drawLines(lineList);
+}
+
+// The pyramid is built in a separate thread, using a copy of the signal.
+// The spectrogram is calculated in another thread.
+void
+ParameterWidget::calculateSpectrogram()
+{
+	spectrogramTimer_.stop();
+	spectrogram_.reset();
+	spectrogramImageMap_.clear();
+	const unsigned int generation = ++spectrogramGeneration_;
+	if (!spectrogramEnabled_ || !speechSignal_ || speechSignal_->empty() || !speechSamplerate_ || *speechSamplerate_ <= 0.0) return;
+
+	auto signal = std::make_shared<const std::vector<float>>(*speechSignal_);
+	const double sampleRate = *speechSamplerate_;
+	if (spectrogramFuture_.valid()) spectrogramFuture_.wait();
+	spectrogramFuture_ = std::async(std::launch::async, [this, generation, signal, sampleRate]() {
+		TraceSpan span("Spectrogram::calculate", "paint");
+		auto spectrogram = std::make_shared<Spectrogram>();
+		spectrogram->calculate(*signal, sampleRate);
+		QMetaObject::invokeMethod(this, [this, generation, spectrogram]() {
+			if (generation != spectrogramGeneration_) return; // obsolete
+			spectrogram_ = spectrogram;
+			update();
+		}, Qt::QueuedConnection);
+	});
+}
+
+// Returns the image of the spectrogram for the current time scale.
+// Each column shows the maximum level of the frames that it covers.
+const QImage&
+ParameterWidget::spectrogramImage()
+{
+	auto iter = spectrogramImageMap_.find(timeScale_);
+	if (iter != spectrogramImageMap_.end()) {
+		return iter->second;
+	}
+
+	TraceSpan span("ParameterWidget::spectrogramImage", "paint");
+
+	if (spectrogramImageMap_.size() >= MAX_NUMBER_OF_SPECTROGRAM_IMAGES) {
+		spectrogramImageMap_.clear();
+	}
+
+	const Spectrogram& spectrogram = *spectrogram_;
+	const int width = std::clamp(
+				static_cast<int>(std::ceil(spectrogram.signalDuration() * 1000.0 * timeScale_)),
+				1, MAX_SPECTROGRAM_IMAGE_WIDTH);
+	const int height = static_cast<int>(SPECTROGRAM_HEIGHT);
+	const double maxFrequency = std::min(SPECTROGRAM_MAX_FREQUENCY, 0.5 * spectrogram.sampleRate());
+	const double maxBin = maxFrequency * spectrogram.frameSize() / spectrogram.sampleRate();
+
+	// Range of frames of each column: the frames whose center (Spectrogram::frameTime())
+	// is inside the column. A column without frame centers shows the nearest frame.
+	const std::size_t numFrames = spectrogram.numberOfFrames();
+	const double columnDuration = spectrogram.signalDuration() / width;
+	std::vector<std::size_t> firstFrameList(width);
+	std::vector<std::size_t> endFrameList(width);
+	std::size_t f = 0;
+	for (int x = 0; x < width; ++x) {
+		const std::size_t first = f;
+		while (f < numFrames && (x == width - 1 || spectrogram.frameTime(f) < (x + 1) * columnDuration)) {
+			++f;
+		}
+		if (f > first) {
+			firstFrameList[x] = first;
+			endFrameList[x] = f;
+		} else {
+			const double columnCenter = (x + 0.5) * columnDuration;
+			std::size_t nearest = std::min(f, numFrames - 1U);
+			if (nearest > 0 && columnCenter - spectrogram.frameTime(nearest - 1U)
+						< spectrogram.frameTime(nearest) - columnCenter) {
+				--nearest;
+			}
+			firstFrameList[x] = nearest;
+			endFrameList[x] = nearest + 1U;
+		}
+	}
+
+	QImage image(width, height, QImage::Format_Grayscale8);
+	for (int y = 0; y < height; ++y) {
+		const std::size_t bin = static_cast<std::size_t>(maxBin * (height - 1 - y) / (height - 1) + 0.5);
+		uchar* line = image.scanLine(y);
+		for (int x = 0; x < width; ++x) {
+			unsigned char level = spectrogram.frame(firstFrameList[x])[bin];
+			for (std::size_t k = firstFrameList[x] + 1U; k < endFrameList[x]; ++k) {
+				level = std::max(level, spectrogram.frame(k)[bin]);
+			}
+			line[x] = 255 - level; // dark = high level
+		}
+	}
+
+	return spectrogramImageMap_[timeScale_] = image;
+}
+
+// The signal envelope is taken from the peak pyramid. Until the pyramid is
+// ready, the overview contains only the parameter envelopes.
+void
+ParameterWidget::updateOverview()
+{
+	TraceSpan span("ParameterWidget::updateOverview", "paint");
+
+	constexpr int numColumns = ParameterOverview::NUMBER_OF_COLUMNS;
+	auto overview = std::make_shared<ParameterOverview>();
+	if (eventList_ && !eventList_->list().empty() && model_ && eventList_->list().back()->time > 0.0) {
+		const auto& list = eventList_->list();
+		const double duration = list.back()->time;
+		overview->duration = duration;
+
+		// Speech signal.
+		if (peakPyramid_ && speechSignal_ && speechSamplerate_ && *speechSamplerate_ > 0.0) {
+			const std::vector<float>& signal = *speechSignal_;
+			const double samplesPerColumn = duration * 1.0e-3 * *speechSamplerate_ / numColumns; // ms to s
+			const int level = peakPyramid_->selectLevel(samplesPerColumn);
+			overview->signalEnvelope.reserve(numColumns);
+			for (int i = 0; i < numColumns; ++i) {
+				const std::size_t first = static_cast<std::size_t>(i * samplesPerColumn);
+				const std::size_t end = std::min(std::max(static_cast<std::size_t>((i + 1) * samplesPerColumn), first + 1U),
+									signal.size());
+				if (first >= end) break;
+				if (level < 0) {
+					const auto range = std::minmax_element(signal.begin() + first, signal.begin() + end);
+					overview->signalEnvelope.push_back(PeakPyramid::Peak{*range.first, *range.second});
+				} else {
+					overview->signalEnvelope.push_back(peakPyramid_->peak(level, first, end));
+				}
+			}
+		}
+
+		// Parameters. The curves are linear between the points, so the envelope
+		// of a column is given by the points in the column and by the values at
+		// its limits.
+		const double columnsPerMs = numColumns / duration;
+		auto getColumn = [&](double time) {
+			return std::clamp(static_cast<int>(time * columnsPerMs), 0, numColumns - 1);
+		};
+		for (unsigned int paramIndex : selectedParamList_) {
+			const double currentMin = model_->parameterList()[paramIndex].minimum();
+			const double currentMax = model_->parameterList()[paramIndex].maximum();
+			const double valueFactor = 1.0 / (currentMax - currentMin);
+			std::vector<PeakPyramid::Peak> envelope(numColumns, PeakPyramid::Peak{1.0f, 0.0f}); // empty
+			auto addValue = [&](int column, double value) {
+				const float v = std::clamp(static_cast<float>((value - currentMin) * valueFactor), 0.0f, 1.0f);
+				envelope[column].min = std::min(envelope[column].min, v);
+				envelope[column].max = std::max(envelope[column].max, v);
+			};
+			auto addSegment = [&](double time1, double value1, double time2, double value2) {
+				if (time2 <= time1) {
+					addValue(getColumn(time1), value1);
+					addValue(getColumn(time1), value2);
+					return;
+				}
+				const double slope = (value2 - value1) / (time2 - time1);
+				for (int c = getColumn(time1), end = getColumn(time2); c <= end; ++c) {
+					const double t1 = std::max(time1, c / columnsPerMs);
+					const double t2 = std::min(time2, (c + 1) / columnsPerMs);
+					addValue(c, value1 + (t1 - time1) * slope);
+					addValue(c, value1 + (t2 - time1) * slope);
+				}
+			};
+			bool hasPrev = false;
+			double prevTime = 0.0, prevValue = 0.0;
+			for (const auto& event : list) {
+				const double value = event->getParameter(paramIndex, false);
+				if (value == VTMControlModel::Event::EMPTY_PARAMETER) continue;
+				if (hasPrev) {
+					addSegment(prevTime, prevValue, event->time, value);
+				} else {
+					addValue(getColumn(event->time), value);
+				}
+				prevTime = event->time;
+				prevValue = value;
+				hasPrev = true;
+			}
+			// Constant value until the end.
+			if (hasPrev) addSegment(prevTime, prevValue, duration, prevValue);
+
+			overview->paramEnvelopeList.push_back(std::move(envelope));
+		}
+	}
+	overview_ = overview;
+
+	emit overviewChanged();
+}
+
+double
+ParameterWidget::getSpectrogramTopY()
+{
+	return getGraphBaseY(selectedParamList_.size() - 1U) + MARGIN;
+}
+
+void
+ParameterWidget::buildPeakPyramid()
+{
+	peakPyramid_.reset();
+	const unsigned int generation = ++peakPyramidGeneration_;
+	peakPyramidPending_ = false;
+	if (!speechSignal_ || speechSignal_->empty()) return;
+
+	peakPyramidPending_ = true;
+
+	auto signal = std::make_shared<const std::vector<float>>(*speechSignal_);
+	if (peakPyramidFuture_.valid()) peakPyramidFuture_.wait(); // the build is fast
+	peakPyramidFuture_ = std::async(std::launch::async, [this, generation, signal]() {
+		TraceSpan span("PeakPyramid::build", "paint");
+		auto pyramid = std::make_shared<PeakPyramid>();
+		pyramid->build(*signal);
+		QMetaObject::invokeMethod(this, [this, generation, pyramid]() {
+			if (generation != peakPyramidGeneration_) return; // obsolete
+			peakPyramid_ = pyramid;
+			peakPyramidPending_ = false;
+			// Samples may have been appended during the build.
+			if (speechSignal_ && pyramid->signalSize() < speechSignal_->size()) {
+				peakPyramid_->append(*speechSignal_);
+			}
+			invalidateTiles(true, false);
+			updateOverview();
+			update();
+		}, Qt::QueuedConnection);
+	});
+}
+
 double
 ParameterWidget::getGraphBaseY(unsigned int index)
 {
@@ -391,10 +1017,68 @@ ParameterWidget::updateData(
 	modelUpdated_ = true;
 
 	selectedParamList_.clear();
+	timeIndexValid_ = false;
+	invalidateTiles(true, true);
+	buildPeakPyramid();
+	calculateSpectrogram();
+	updateOverview();
 
 	update();
 }
 
+void
+ParameterWidget::handleSpeechSignalUpdate()
+{
+	invalidateTiles(true, false);
+	buildPeakPyramid();
+	calculateSpectrogram();
+	updateOverview();
+	update();
+}
+
+// The peak pyramid is extended, and only the header tiles that show the new
+// samples are rendered again.
+void
+ParameterWidget::handleSpeechSignalAppend(std::size_t firstSample)
+{
+	if (!speechSignal_ || !speechSamplerate_ || *speechSamplerate_ <= 0.0) return;
+
+	if (peakPyramid_ && peakPyramid_->signalSize() <= firstSample) {
+		peakPyramid_->append(*speechSignal_);
+	} else if (!peakPyramidPending_) {
+		buildPeakPyramid();
+	} // else: the new samples are added when the pending pyramid is installed
+	// 1.0 subtracted because the previous column is connected to the new samples.
+	invalidateHeaderTiles(tileXBase_ + firstSample * (1000.0 / *speechSamplerate_) * timeScale_ - 1.0);
+	if (spectrogramEnabled_) {
+		spectrogramTimer_.start();
+	}
+	updateOverview();
+	update();
+}
+
+// The view follows the playhead while it is visible.
+void
+ParameterWidget::setPlayheadTime(double time)
+{
+	const double viewEndTime = viewStartTime_ + viewDuration_;
+	if (playheadTime_ >= viewStartTime_ && playheadTime_ <= viewEndTime && time > viewEndTime) {
+		viewX_ = static_cast<int>(std::round(time * timeScale_));
+	}
+	playheadTime_ = time;
+
+	update();
+}
+
+void
+ParameterWidget::setSpectrogramEnabled(bool enabled)
+{
+	if (enabled == spectrogramEnabled_) return;
+	spectrogramEnabled_ = enabled;
+	calculateSpectrogram();
+	update();
+}
+
 void
 ParameterWidget::changeParameterSelection(unsigned int paramIndex, bool selected)
 {
@@ -420,6 +1104,7 @@ ParameterWidget::changeParameterSelection(unsigned int paramIndex, bool selected
 		}
 	}
 	emit mouseMoved(-1.0, 0.0);
+	updateOverview();
 	update();
 }
 
@@ -427,7 +1112,7 @@ void
 ParameterWidget::changeXZoom(double zoom)
 {
 	zoom = qBound(xZoomMin(), zoom, xZoomMax());
-	timeScale_ = DEFAULT_TIME_SCALE * zoom;
+	setTimeScale(DEFAULT_TIME_SCALE * zoom);
 
 	update();
 }
@@ -449,18 +1134,43 @@ ParameterWidget::getVerticalScrollbarValue(int value)
 	update();
 }
 
+// Slot.
 void
-ParameterWidget::getHorizontalScrollbarValue(int value)
+ParameterWidget::setViewStartTime(double startTime)
 {
-	horizontalScrollbarValue_ = value;
+	viewX_ = static_cast<int>(std::round(startTime * timeScale_));
 
 	update();
 }
 
+// Keeps the time at the left of the view.
+void
+ParameterWidget::setTimeScale(double timeScale)
+{
+	viewX_ = static_cast<int>(std::round(viewX_ * (timeScale / timeScale_)));
+	timeScale_ = timeScale;
+}
+
+// Limits the view to the content, and reports the visible time range.
+void
+ParameterWidget::updateView(double xBase)
+{
+	viewX_ = std::clamp(viewX_, 0, std::max(totalWidth_ - width(), 0));
+	const double startTime = viewX_ / timeScale_;
+	const double duration = std::max(width() - xBase, 0.0) / timeScale_;
+	if (startTime != viewStartTime_ || duration != viewDuration_) {
+		viewStartTime_ = startTime;
+		viewDuration_ = duration;
+		emit viewChanged(startTime, duration);
+	}
+}
+
 void
 ParameterWidget::handleModelUpdate()
 {
 	modelUpdated_ = true;
+	invalidateTiles(true, true);
+	updateOverview();
 }
 
 } // namespace GS
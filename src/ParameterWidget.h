@@ -18,8 +18,15 @@
 #ifndef PARAMETER_WIDGET_H
 #define PARAMETER_WIDGET_H
 
+#include <cstddef> /* std::size_t */
+#include <future>
+#include <map>
+#include <memory>
+#include <utility> /* pair */
 #include <vector>
 
+#include <QImage>
+#include <QTimer>
 #include <QWidget>
 
 
@@ -30,12 +37,15 @@ namespace VTMControlModel {
 class Model;
 class EventList;
 }
+class PeakPyramid;
+class Spectrogram;
+struct ParameterOverview;
 
 class ParameterWidget : public QWidget {
 	Q_OBJECT
 public:
 	explicit ParameterWidget(QWidget* parent=nullptr);
-	virtual ~ParameterWidget() = default;
+	virtual ~ParameterWidget();
 
 	virtual QSize sizeHint() const;
 	void updateData(
@@ -43,6 +53,15 @@ public:
 		const VTMControlModel::Model* model,
 		const std::vector<float>* speechSignal,
 		const double* speechSamplerate);
+	// Must be called when the content of the speech signal is modified.
+	void handleSpeechSignalUpdate();
+	// Must be called when samples are appended to the speech signal.
+	// The samples before firstSample must not have been modified.
+	void handleSpeechSignalAppend(std::size_t firstSample);
+	// time: ms - the playhead is hidden if the time is negative
+	void setPlayheadTime(double time);
+	// The spectrogram is shown below the parameter graphs.
+	void setSpectrogramEnabled(bool enabled);
 	void changeParameterSelection(unsigned int paramIndex, bool selected);
 	double xZoomMin() const { return 0.1; }
 	double xZoomMax() const { return 10.0; }
@@ -50,24 +69,58 @@ public:
 	double yZoomMax() const { return 10.0; }
 	void changeXZoom(double zoom);
 	void changeYZoom(double zoom);
+	// Envelopes of the entire utterance. It is replaced when overviewChanged() is emitted.
+	std::shared_ptr<const ParameterOverview> overview() const { return overview_; }
 public slots:
 	void getVerticalScrollbarValue(int value);
-	void getHorizontalScrollbarValue(int value);
 	void handleModelUpdate();
+	// Shows the time range that starts at startTime (ms).
+	void setViewStartTime(double startTime);
+private slots:
+	void prerenderTiles();
 signals:
 	void mouseMoved(double time, double value);
 	void zoomReset();
+	void overviewChanged();
+	// startTime, duration: ms
+	void viewChanged(double startTime, double duration);
 protected:
 	virtual void paintEvent(QPaintEvent* event);
 	virtual void mouseMoveEvent(QMouseEvent* event);
 	virtual void mouseDoubleClickEvent(QMouseEvent *event);
+	virtual void wheelEvent(QWheelEvent* event);
 private:
 	ParameterWidget(const ParameterWidget&) = delete;
 	ParameterWidget& operator=(const ParameterWidget&) = delete;
 	ParameterWidget(ParameterWidget&&) = delete;
 	ParameterWidget& operator=(ParameterWidget&&) = delete;
 
+	struct RuleSpan {
+		int time1; // ms
+		int time2; // ms
+		int number;
+	};
+
 	double getGraphBaseY(unsigned int index);
+	void updateTimeIndex();
+	// Returns the range of events [first, end) in [time1, time2], extended by one event on each side.
+	void getEventRange(double time1, double time2, std::size_t& first, std::size_t& end) const;
+	void buildPeakPyramid();
+	void drawSpeechSignal(QPainter& painter, const QRect& rect, double xBase);
+	void paintSpeechSignal(QPaintEvent* event);
+	void calculateSpectrogram();
+	const QImage& spectrogramImage();
+	double getSpectrogramTopY();
+	void updateOverview();
+	void setTimeScale(double timeScale);
+	void updateView(double xBase);
+	void setupTileLayout(double xBase, double xEnd, double headerBottomY);
+	void invalidateTiles(bool header, bool graphs);
+	void invalidateHeaderTiles(double x);
+	QImage tile(int layer, int column);
+	QImage createTileImage(double height) const;
+	QImage renderHeaderTile(int column);
+	QImage renderGraphTile(unsigned int paramIndex, int column);
 
 	const VTMControlModel::EventList* eventList_;
 	const VTMControlModel::Model* model_;
@@ -81,10 +134,42 @@ private:
 	int totalWidth_;
 	int totalHeight_;
 	int verticalScrollbarValue_;
-	int horizontalScrollbarValue_;
+	// Only the time range that starts at this x coordinate is shown.
+	// The widget does not grow with the duration of the utterance.
+	int viewX_;
+	double viewStartTime_; // ms
+	double viewDuration_; // ms
+	double playheadTime_; // ms
 	int textTotalHeight_;
 	std::vector<unsigned int> selectedParamList_;
+	// Time index.
+	bool timeIndexValid_;
+	bool timeIndexSorted_; // if false, all the events and rules are drawn
+	std::vector<double> eventTimeList_;
+	std::vector<int> eventPostureIndexList_; // -1 if the event is not a posture
 	std::vector<int> postureTimeList_;
+	std::vector<RuleSpan> ruleSpanList_;
+	std::shared_ptr<PeakPyramid> peakPyramid_; // nullptr while it is being built
+	unsigned int peakPyramidGeneration_;
+	bool peakPyramidPending_;
+	std::future<void> peakPyramidFuture_;
+	bool spectrogramEnabled_;
+	std::shared_ptr<const Spectrogram> spectrogram_; // nullptr while it is being calculated
+	unsigned int spectrogramGeneration_;
+	std::future<void> spectrogramFuture_;
+	std::map<double, QImage> spectrogramImageMap_; // key: time scale
+	QTimer spectrogramTimer_; // delays the calculation while the signal is being appended
+	std::shared_ptr<const ParameterOverview> overview_;
+	// Tile cache. Key: (layer, column). The layer is HEADER_LAYER or the parameter index.
+	std::map<std::pair<int, int>, QImage> tileMap_;
+	std::vector<std::pair<int, int>> prerenderList_;
+	QTimer prerenderTimer_;
+	double tileXBase_;
+	double tileXEnd_;
+	double tileTimeScale_;
+	double tileHeaderHeight_;
+	double tileGraphHeight_;
+	qreal tileDevicePixelRatio_;
 };
 
 } // namespace GS
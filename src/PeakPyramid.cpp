@@ -0,0 +1,122 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "PeakPyramid.h"
+
+#include <algorithm> /* max, min */
+
+#define BASE_BLOCK_SIZE 4
+
+
+
+namespace GS {
+
+PeakPyramid::PeakPyramid()
+		: signalSize_()
+{
+}
+
+void
+PeakPyramid::build(const std::vector<float>& signal)
+{
+	clear();
+	append(signal);
+}
+
+// Only the last peak of each level and the new peaks are calculated.
+void
+PeakPyramid::append(const std::vector<float>& signal)
+{
+	if (signal.size() <= signalSize_) return;
+	if (levelList_.empty()) levelList_.emplace_back();
+
+	// The last block may be incomplete.
+	std::size_t firstBlock = signalSize_ / BASE_BLOCK_SIZE;
+	signalSize_ = signal.size();
+
+	std::vector<Peak>& level0 = levelList_[0];
+	level0.resize((signal.size() + BASE_BLOCK_SIZE - 1U) / BASE_BLOCK_SIZE);
+	for (std::size_t i = firstBlock, size = level0.size(); i < size; ++i) {
+		const std::size_t first = i * BASE_BLOCK_SIZE;
+		const std::size_t end = std::min(first + BASE_BLOCK_SIZE, signal.size());
+		Peak p{signal[first], signal[first]};
+		for (std::size_t j = first + 1U; j < end; ++j) {
+			p.min = std::min(p.min, signal[j]);
+			p.max = std::max(p.max, signal[j]);
+		}
+		level0[i] = p;
+	}
+
+	for (std::size_t n = 1; levelList_[n - 1U].size() > 1U; ++n) {
+		firstBlock /= 2U;
+		if (n == levelList_.size()) levelList_.emplace_back();
+		const std::vector<Peak>& prev = levelList_[n - 1U];
+		std::vector<Peak>& next = levelList_[n];
+		next.resize((prev.size() + 1U) / 2U);
+		for (std::size_t i = firstBlock, size = next.size(); i < size; ++i) {
+			const Peak& a = prev[2U * i];
+			if (2U * i + 1U < prev.size()) {
+				const Peak& b = prev[2U * i + 1U];
+				next[i] = Peak{std::min(a.min, b.min), std::max(a.max, b.max)};
+			} else {
+				next[i] = a;
+			}
+		}
+	}
+}
+
+void
+PeakPyramid::clear()
+{
+	signalSize_ = 0;
+	levelList_.clear();
+}
+
+std::size_t
+PeakPyramid::baseBlockSize()
+{
+	return BASE_BLOCK_SIZE;
+}
+
+int
+PeakPyramid::selectLevel(double samplesPerPixel) const
+{
+	int level = -1;
+	for (std::size_t i = 0; i < levelList_.size(); ++i) {
+		if (blockSize(i) > samplesPerPixel) break;
+		level = i;
+	}
+	return level;
+}
+
+PeakPyramid::Peak
+PeakPyramid::peak(int level, std::size_t firstSample, std::size_t endSample) const
+{
+	const std::vector<Peak>& peakList = levelList_[level];
+	const std::size_t size = blockSize(level);
+	const std::size_t firstBlock = firstSample / size;
+	const std::size_t endBlock = std::min((endSample + size - 1U) / size, peakList.size());
+
+	Peak p = peakList[firstBlock];
+	for (std::size_t i = firstBlock + 1U; i < endBlock; ++i) {
+		p.min = std::min(p.min, peakList[i].min);
+		p.max = std::max(p.max, peakList[i].max);
+	}
+	return p;
+}
+
+} // namespace GS
@@ -0,0 +1,72 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef PEAK_PYRAMID_H
+#define PEAK_PYRAMID_H
+
+#include <cstddef> /* std::size_t */
+#include <vector>
+
+
+
+namespace GS {
+
+// Multi-resolution minimum/maximum envelope of a signal.
+//
+// Each peak of level 0 covers baseBlockSize() samples, and each peak of
+// level n + 1 covers two peaks of level n.
+class PeakPyramid {
+public:
+	struct Peak {
+		float min;
+		float max;
+	};
+
+	PeakPyramid();
+	~PeakPyramid() = default;
+
+	void build(const std::vector<float>& signal);
+	// Updates the pyramid after samples have been appended to the signal.
+	// The first signalSize() samples must not have been modified.
+	void append(const std::vector<float>& signal);
+	void clear();
+
+	static std::size_t baseBlockSize();
+	std::size_t signalSize() const { return signalSize_; }
+	std::size_t numberOfLevels() const { return levelList_.size(); }
+	std::size_t blockSize(std::size_t level) const { return baseBlockSize() << level; }
+	const std::vector<Peak>& level(std::size_t level) const { return levelList_[level]; }
+
+	// Returns the coarsest level whose peaks cover at most samplesPerPixel samples.
+	// Returns -1 if the samples must be used directly.
+	int selectLevel(double samplesPerPixel) const;
+	// Envelope of the samples in [firstSample, endSample), with the resolution of the level.
+	// The range must not be empty.
+	Peak peak(int level, std::size_t firstSample, std::size_t endSample) const;
+private:
+	PeakPyramid(const PeakPyramid&) = delete;
+	PeakPyramid& operator=(const PeakPyramid&) = delete;
+	PeakPyramid(PeakPyramid&&) = delete;
+	PeakPyramid& operator=(PeakPyramid&&) = delete;
+
+	std::size_t signalSize_;
+	std::vector<std::vector<Peak>> levelList_;
+};
+
+} // namespace GS
+
+#endif // PEAK_PYRAMID_H
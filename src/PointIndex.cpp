@@ -0,0 +1,77 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "PointIndex.h"
+
+#include <algorithm> /* lower_bound, sort */
+#include <cmath> /* abs */
+#include <cstddef> /* std::size_t */
+#include <limits>
+
+
+
+namespace GS {
+
+void
+PointIndex::sort()
+{
+	std::sort(pointList_.begin(), pointList_.end(),
+			[](const Point& p1, const Point& p2) { return p1.x < p2.x; });
+}
+
+// The search starts at the position of x, and goes in both directions
+// until |dx| is not smaller than the best distance.
+int
+PointIndex::nearest(double x, double y) const
+{
+	const auto iter = std::lower_bound(pointList_.begin(), pointList_.end(), x,
+						[](const Point& p, double value) { return p.x < value; });
+	const std::size_t pos = iter - pointList_.begin();
+
+	double minDistance = std::numeric_limits<double>::infinity();
+	int id = -1;
+	auto check = [&](const Point& p) {
+		const double distance = std::abs(p.x - x) + std::abs(p.y - y);
+		if (distance < minDistance || (distance == minDistance && p.id < id)) {
+			minDistance = distance;
+			id = p.id;
+		}
+	};
+	for (std::size_t i = pos; i < pointList_.size() && pointList_[i].x - x <= minDistance; ++i) {
+		check(pointList_[i]);
+	}
+	for (std::size_t i = pos; i > 0 && x - pointList_[i - 1U].x <= minDistance; --i) {
+		check(pointList_[i - 1U]);
+	}
+	return id;
+}
+
+int
+PointIndex::firstInRange(double x, double y, double maxDistance) const
+{
+	auto iter = std::lower_bound(pointList_.begin(), pointList_.end(), x - maxDistance,
+					[](const Point& p, double value) { return p.x < value; });
+	int id = -1;
+	for ( ; iter != pointList_.end() && iter->x <= x + maxDistance; ++iter) {
+		if (std::abs(iter->y - y) <= maxDistance && (id < 0 || iter->id < id)) {
+			id = iter->id;
+		}
+	}
+	return id;
+}
+
+} // namespace GS
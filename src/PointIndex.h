@@ -0,0 +1,56 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef POINT_INDEX_H
+#define POINT_INDEX_H
+
+#include <vector>
+
+
+
+namespace GS {
+
+// Index for hit-testing, with the points sorted by the x coordinate.
+class PointIndex {
+public:
+	PointIndex() = default;
+	~PointIndex() = default;
+
+	void clear() { pointList_.clear(); }
+	// id: identifier of the point, returned by the queries.
+	void add(double x, double y, int id) { pointList_.push_back(Point{x, y, id}); }
+	// Must be called after the points are added.
+	void sort();
+
+	// Returns the id of the point with the smallest |dx| + |dy|, or -1 if the index is empty.
+	int nearest(double x, double y) const;
+	// Returns the smallest id of the points with |dx| <= maxDistance and |dy| <= maxDistance,
+	// or -1 if there is no such point.
+	int firstInRange(double x, double y, double maxDistance) const;
+private:
+	struct Point {
+		double x;
+		double y;
+		int id;
+	};
+
+	std::vector<Point> pointList_;
+};
+
+} // namespace GS
+
+#endif // POINT_INDEX_H
@@ -0,0 +1,199 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "ReferenceModelCache.h"
+
+#include <fstream>
+#include <utility> /* move */
+
+#include "Controller.h"
+#include "Exception.h" /* THROW_EXCEPTION */
+#include "Index.h"
+#include "Model.h"
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+
+
+namespace {
+
+// FNV-1a.
+std::uint64_t
+fileContentHash(const std::string& filePath)
+{
+	std::ifstream in(filePath, std::ios_base::in | std::ios_base::binary);
+	if (!in) {
+		THROW_EXCEPTION(GS::ReferenceModelCacheException, "Could not open the file " << filePath << '.');
+	}
+	std::uint64_t hash = FNV_OFFSET_BASIS;
+	char buffer[65536];
+	while (in) {
+		in.read(buffer, sizeof buffer);
+		const std::streamsize n = in.gcount();
+		for (std::streamsize i = 0; i < n; ++i) {
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= FNV_PRIME;
+		}
+	}
+	return hash;
+}
+
+} // namespace
+
+namespace GS {
+
+ReferenceModelCache::Data::Data()
+		: modificationTime()
+		, contentHash()
+		, controllerKept()
+{
+}
+
+ReferenceModelCache::ReferenceModelCache()
+{
+}
+
+ReferenceModelCache::~ReferenceModelCache()
+{
+	clear();
+}
+
+void
+ReferenceModelCache::loadAsync(const std::string& filePath, std::shared_ptr<Index> index)
+{
+	waitForPendingLoad();
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		filePath_ = filePath;
+		index_ = index;
+	}
+	pendingLoad_ = std::async(std::launch::async, [this]() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		try {
+			update(filePath_, index_);
+		} catch (...) {
+			// The loading will be retried in get(), which will report the error.
+		}
+	});
+}
+
+void
+ReferenceModelCache::waitForPendingLoad()
+{
+	if (pendingLoad_.valid()) {
+		pendingLoad_.get();
+	}
+}
+
+ReferenceModelCache::Reference
+ReferenceModelCache::get(bool keepController)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (filePath_.empty() || !index_) {
+		THROW_EXCEPTION(ReferenceModelCacheException, "The reference model has not been configured.");
+	}
+	update(filePath_, index_);
+	if (data_->controllerKept) {
+		data_->reference.controller = createController(data_->index, data_->reference.model);
+	}
+	data_->controllerKept = keepController;
+	return data_->reference;
+}
+
+std::uint64_t
+ReferenceModelCache::contentHash()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (filePath_.empty()) {
+		THROW_EXCEPTION(ReferenceModelCacheException, "The reference model has not been configured.");
+	}
+	const std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(filePath_);
+	if (data_ && data_->filePath == filePath_ && data_->modificationTime == modificationTime) {
+		return data_->contentHash;
+	}
+	const std::uint64_t contentHash = fileContentHash(filePath_);
+	if (data_ && data_->filePath == filePath_ && data_->contentHash == contentHash) {
+		data_->modificationTime = modificationTime;
+	}
+	return contentHash;
+}
+
+ReferenceModelCache::Reference
+ReferenceModelCache::current()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return data_ ? data_->reference : Reference();
+}
+
+void
+ReferenceModelCache::clear()
+{
+	waitForPendingLoad();
+	std::lock_guard<std::mutex> lock(mutex_);
+	filePath_.clear();
+	index_.reset();
+	data_.reset();
+}
+
+// The controller references the model and the index, so they are kept alive
+// until the controller is destroyed.
+std::shared_ptr<VTMControlModel::Controller>
+ReferenceModelCache::createController(std::shared_ptr<Index> index, std::shared_ptr<VTMControlModel::Model> model)
+{
+	auto controller = std::make_unique<VTMControlModel::Controller>(*index, *model);
+	return std::shared_ptr<VTMControlModel::Controller>(controller.release(),
+		[index, model](VTMControlModel::Controller* c) { delete c; });
+}
+
+// Must be called with the mutex locked.
+void
+ReferenceModelCache::update(const std::string& filePath, std::shared_ptr<Index> index)
+{
+	const std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(filePath);
+	if (data_ && data_->filePath == filePath) {
+		if (data_->modificationTime != modificationTime) {
+			const std::uint64_t contentHash = fileContentHash(filePath);
+			if (contentHash != data_->contentHash) {
+				data_.reset(); // forces the reloading
+			} else {
+				data_->modificationTime = modificationTime;
+			}
+		}
+		if (data_ && data_->index != index) {
+			// Only the controller depends on the index.
+			data_->reference.controller = createController(index, data_->reference.model);
+			data_->controllerKept = false;
+			data_->index = index;
+		}
+		if (data_) return;
+	}
+
+	auto data = std::make_unique<Data>();
+	data->filePath = filePath;
+	data->index = index;
+	data->modificationTime = modificationTime;
+	data->contentHash = fileContentHash(filePath);
+	auto model = std::make_shared<VTMControlModel::Model>();
+	model->load(filePath);
+	data->reference.model = model;
+	data->reference.controller = createController(index, model);
+
+	data_ = std::move(data);
+}
+
+} // namespace GS
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef REFERENCE_MODEL_CACHE_H
+#define REFERENCE_MODEL_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+
+
+namespace GS {
+
+struct ReferenceModelCacheException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+class Index;
+namespace VTMControlModel {
+class Controller;
+class Model;
+}
+
+// Keeps the reference model (loaded from the model file) and its controller.
+//
+// The model is reloaded only when the content of the file changes
+// (the hash of the content is calculated when the modification time changes).
+// The objects are shared, so a reload does not invalidate the references held
+// by a running job or by the GUI.
+// get() and current() may be called from any thread.
+// loadAsync() and clear() must be called from the same thread.
+class ReferenceModelCache {
+public:
+	struct Reference {
+		std::shared_ptr<VTMControlModel::Model> model;
+		std::shared_ptr<VTMControlModel::Controller> controller; // keeps the model and the index alive
+	};
+
+	ReferenceModelCache();
+	~ReferenceModelCache();
+
+	// Loads the model in a background thread.
+	// Errors are reported only in the next call to get().
+	void loadAsync(const std::string& filePath, std::shared_ptr<Index> index);
+
+	// Reloads the model if the file has changed. If a background load is running,
+	// the call blocks until it ends (the load holds the mutex).
+	// If keepController is true, the caller keeps the event list of the
+	// returned controller (to display it or to cache it), and the next call
+	// returns another controller.
+	Reference get(bool keepController=false);
+
+	// Returns the hash of the current content of the file, which identifies
+	// the model that the next call to get() will return. The model is not
+	// reloaded. The hash is calculated only if the modification time has changed.
+	std::uint64_t contentHash();
+
+	// Returns the objects of the last call to get() (may be null).
+	// Does not check the file.
+	Reference current();
+
+	void clear();
+
+	// Creates another controller for the model, when the event list of the
+	// shared controller must be kept.
+	static std::shared_ptr<VTMControlModel::Controller> createController(
+				std::shared_ptr<Index> index, std::shared_ptr<VTMControlModel::Model> model);
+private:
+	struct Data {
+		std::string filePath;
+		std::shared_ptr<Index> index;
+		std::filesystem::file_time_type modificationTime;
+		std::uint64_t contentHash;
+		Reference reference;
+		bool controllerKept; // the controller in reference has been returned with keepController = true
+
+		Data();
+	};
+
+	ReferenceModelCache(const ReferenceModelCache&) = delete;
+	ReferenceModelCache& operator=(const ReferenceModelCache&) = delete;
+	ReferenceModelCache(ReferenceModelCache&&) = delete;
+	ReferenceModelCache& operator=(ReferenceModelCache&&) = delete;
+
+	void waitForPendingLoad();
+	void update(const std::string& filePath, std::shared_ptr<Index> index);
+
+	std::mutex mutex_; // not used by pendingLoad_
+	std::string filePath_;
+	std::shared_ptr<Index> index_;
+	std::future<void> pendingLoad_;
+	std::unique_ptr<Data> data_;
+};
+
+} // namespace GS
+
+#endif // REFERENCE_MODEL_CACHE_H
@@ -125,6 +125,8 @@ RuleManagerWindow::on_removeButton_clicked()
 	setupRulesList();
 	ui_->rulesTable->setCurrentItem(nullptr);
 	selectedRule_ = nullptr;
+
+	emit ruleChanged();
 }
 
 void
@@ -176,6 +178,7 @@ RuleManagerWindow::on_addButton_clicked()
 	ui_->rulesTable->setCurrentItem(nullptr);
 	ui_->rulesTable->setCurrentCell(insertRow, 0);
 
+	emit ruleChanged();
 	emit categoryReferenceChanged();
 }
 
@@ -223,6 +226,7 @@ RuleManagerWindow::on_updateButton_clicked()
 	ui_->rulesTable->setCurrentItem(nullptr);
 	ui_->rulesTable->setCurrentCell(currRow, 0);
 
+	emit ruleChanged();
 	emit categoryReferenceChanged();
 }
 
@@ -241,6 +245,8 @@ RuleManagerWindow::on_moveUpButton_clicked()
 
 	setupRulesList();
 	ui_->rulesTable->setCurrentCell(currRow - 1, 0);
+
+	emit ruleChanged();
 }
 
 void
@@ -258,6 +264,8 @@ RuleManagerWindow::on_moveDownButton_clicked()
 
 	setupRulesList();
 	ui_->rulesTable->setCurrentCell(currRow + 1, 0);
+
+	emit ruleChanged();
 }
 
 void
@@ -47,6 +47,7 @@ public:
 
 	void resetModel(VTMControlModel::Model* model);
 signals:
+	void ruleChanged();
 	void categoryReferenceChanged();
 	void transitionReferenceChanged();
 	void specialTransitionReferenceChanged();
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef SCOPED_TIMER_H
+#define SCOPED_TIMER_H
+
+#include <chrono>
+
+
+
+namespace GS {
+
+// Adds the elapsed time (in seconds) to *result when the object is destroyed.
+// If result is null, the timer does nothing.
+class ScopedTimer {
+public:
+	explicit ScopedTimer(double* result)
+			: result_(result)
+	{
+		if (result_) {
+			start_ = std::chrono::steady_clock::now();
+		}
+	}
+
+	~ScopedTimer()
+	{
+		if (result_) {
+			*result_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+		}
+	}
+private:
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+	ScopedTimer(ScopedTimer&&) = delete;
+	ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+	double* result_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace GS
+
+#endif // SCOPED_TIMER_H
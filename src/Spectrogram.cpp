@@ -0,0 +1,104 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "Spectrogram.h"
+
+#include <algorithm> /* max, min */
+#include <cmath> /* ceil, cos, log2, log10, pow */
+
+#include "SignalDFT.h"
+
+#define FRAME_DURATION (0.025) /* s */
+#define OVERLAP_FACTOR 4 /* frameSize / hopSize */
+#define DYNAMIC_RANGE (80.0) /* dB */
+
+
+
+namespace GS {
+
+Spectrogram::Spectrogram()
+		: sampleRate_(1.0)
+		, signalSize_()
+		, frameSize_(2)
+		, hopSize_(1)
+		, numberOfFrames_()
+{
+}
+
+void
+Spectrogram::clear()
+{
+	signalSize_ = 0;
+	numberOfFrames_ = 0;
+	levelList_.clear();
+}
+
+double
+Spectrogram::dynamicRange()
+{
+	return DYNAMIC_RANGE;
+}
+
+void
+Spectrogram::calculate(const std::vector<float>& signal, double sampleRate)
+{
+	clear();
+	if (signal.empty() || sampleRate <= 0.0) return;
+
+	sampleRate_ = sampleRate;
+	signalSize_ = signal.size();
+	// Power of two, to use the fast algorithm.
+	frameSize_ = std::size_t{1} << static_cast<unsigned int>(std::ceil(std::log2(FRAME_DURATION * sampleRate)));
+	hopSize_ = std::max<std::size_t>(frameSize_ / OVERLAP_FACTOR, 1);
+	numberOfFrames_ = (signal.size() + hopSize_ - 1U) / hopSize_;
+	const std::size_t numBins = numberOfBins();
+
+	std::vector<float> window(frameSize_);
+	for (std::size_t i = 0; i < frameSize_; ++i) {
+		window[i] = 0.5 - 0.5 * std::cos((2.0 * M_PI * i) / (frameSize_ - 1U)); // Hann
+	}
+
+	SignalDFT dft(frameSize_);
+	std::vector<float> magnitude(numberOfFrames_ * numBins);
+	float maxMagnitude = 0.0;
+	for (std::size_t i = 0; i < numberOfFrames_; ++i) {
+		const std::size_t first = i * hopSize_;
+		const std::size_t end = std::min(first + frameSize_, signal.size());
+		float* m = &magnitude[i * numBins];
+		dft.execute(&signal[first], window.data(), end - first, m); // the last frames are padded
+		maxMagnitude = std::max(maxMagnitude, *std::max_element(m, m + numBins));
+	}
+
+	levelList_.resize(magnitude.size());
+	if (maxMagnitude <= 0.0f) {
+		std::fill(levelList_.begin(), levelList_.end(), 0);
+		return;
+	}
+	// Magnitude below which the level is zero.
+	const float minMagnitude = maxMagnitude * std::pow(10.0, -DYNAMIC_RANGE / 20.0);
+	const double coef = 255.0 / DYNAMIC_RANGE;
+	for (std::size_t i = 0, size = magnitude.size(); i < size; ++i) {
+		if (magnitude[i] <= minMagnitude) {
+			levelList_[i] = 0;
+		} else {
+			const double level = 20.0 * std::log10(magnitude[i] / maxMagnitude) + DYNAMIC_RANGE;
+			levelList_[i] = static_cast<unsigned char>(std::min(level * coef, 255.0));
+		}
+	}
+}
+
+} // namespace GS
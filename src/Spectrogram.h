@@ -0,0 +1,67 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <cstddef> /* std::size_t */
+#include <vector>
+
+
+
+namespace GS {
+
+// Short-time magnitude spectrum of a signal, with overlapping Hann windows.
+//
+// The levels are in dB relative to the maximum, mapped from
+// [-dynamicRange(), 0] to [0, 255].
+class Spectrogram {
+public:
+	Spectrogram();
+	~Spectrogram() = default;
+
+	void calculate(const std::vector<float>& signal, double sampleRate);
+	void clear();
+
+	static double dynamicRange();
+	double sampleRate() const { return sampleRate_; }
+	double signalDuration() const { return signalSize_ / sampleRate_; } // s
+	std::size_t frameSize() const { return frameSize_; }
+	std::size_t hopSize() const { return hopSize_; }
+	std::size_t numberOfFrames() const { return numberOfFrames_; }
+	std::size_t numberOfBins() const { return frameSize_ / 2U + 1U; }
+	// Time (s) of the center of the frame.
+	double frameTime(std::size_t frame) const { return (frame * hopSize_ + 0.5 * frameSize_) / sampleRate_; }
+	double binFrequency(std::size_t bin) const { return bin * sampleRate_ / frameSize_; }
+	const unsigned char* frame(std::size_t frame) const { return &levelList_[frame * numberOfBins()]; }
+private:
+	Spectrogram(const Spectrogram&) = delete;
+	Spectrogram& operator=(const Spectrogram&) = delete;
+	Spectrogram(Spectrogram&&) = delete;
+	Spectrogram& operator=(Spectrogram&&) = delete;
+
+	double sampleRate_;
+	std::size_t signalSize_;
+	std::size_t frameSize_;
+	std::size_t hopSize_;
+	std::size_t numberOfFrames_;
+	std::vector<unsigned char> levelList_;
+};
+
+} // namespace GS
+
+#endif // SPECTROGRAM_H
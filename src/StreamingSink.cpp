@@ -0,0 +1,269 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "StreamingSink.h"
+
+#include <algorithm> /* min */
+#include <cerrno>
+#include <cstdio> /* remove */
+#include <iostream>
+
+#include "JackClient.h"
+#include "JackConfig.h"
+#include "JackRingbuffer.h"
+#include "Log.h"
+#include "WAVWriter.h"
+
+#define VTM_PARAM_CHUNK_FILE_SUFFIX ".chunk"
+
+
+
+namespace {
+
+using namespace GS;
+
+extern "C" {
+
+/*******************************************************************************
+ * The process callback for this JACK application is called in a
+ * special realtime thread once for each audio cycle.
+ */
+int
+streaming_jack_process_callback(jack_nframes_t nframes, void* arg)
+{
+	return static_cast<JackStreamingSink*>(arg)->callback(nframes);
+}
+
+/*******************************************************************************
+ * JACK calls this function if the server ever shuts down or
+ * decides to disconnect the client.
+ */
+void
+streaming_jack_shutdown_callback(void* arg)
+{
+	if (Log::debugEnabled) std::cout << "[JackStreamingSink] streaming_jack_shutdown_callback()" << std::endl;
+
+	static_cast<JackStreamingSink*>(arg)->stop();
+}
+
+} /* extern "C" */
+
+} /* namespace */
+
+//==============================================================================
+
+namespace GS {
+
+WAVStreamingSink::WAVStreamingSink(const std::string& wavFilePath, const std::string& vtmParamFilePath)
+		: wavFilePath_(wavFilePath)
+		, vtmParamFilePath_(vtmParamFilePath)
+{
+	if (!vtmParamFilePath_.empty()) {
+		vtmParamChunkFilePath_ = vtmParamFilePath_ + VTM_PARAM_CHUNK_FILE_SUFFIX;
+	}
+}
+
+WAVStreamingSink::~WAVStreamingSink()
+{
+	if (!vtmParamChunkFilePath_.empty()) {
+		std::remove(vtmParamChunkFilePath_.c_str());
+	}
+}
+
+void
+WAVStreamingSink::start(double sampleRate)
+{
+	wavWriter_ = std::make_unique<WAVWriter>(wavFilePath_, sampleRate);
+	if (!vtmParamFilePath_.empty()) {
+		vtmParamFile_.open(vtmParamFilePath_, std::ios_base::binary);
+		if (!vtmParamFile_) {
+			THROW_EXCEPTION(StreamingSinkException, "Could not open the file " << vtmParamFilePath_ << '.');
+		}
+	}
+}
+
+void
+WAVStreamingSink::appendParameterChunk()
+{
+	if (!vtmParamFile_.is_open()) return;
+
+	std::ifstream in(vtmParamChunkFilePath_, std::ios_base::binary);
+	if (!in) {
+		THROW_EXCEPTION(StreamingSinkException, "Could not open the file " << vtmParamChunkFilePath_ << '.');
+	}
+	if (in.peek() != std::ifstream::traits_type::eof()) {
+		vtmParamFile_ << in.rdbuf();
+	}
+	if (!vtmParamFile_) {
+		THROW_EXCEPTION(StreamingSinkException, "Could not write to the file " << vtmParamFilePath_ << '.');
+	}
+}
+
+void
+WAVStreamingSink::writeAudio(const float* samples, std::size_t n)
+{
+	if (!wavWriter_) {
+		THROW_EXCEPTION(StreamingSinkException, "The sink has not been started.");
+	}
+	wavWriter_->write(samples, n);
+}
+
+void
+WAVStreamingSink::finish()
+{
+	if (wavWriter_) {
+		wavWriter_->close();
+		wavWriter_.reset();
+	}
+	if (vtmParamFile_.is_open()) {
+		vtmParamFile_.close();
+		if (!vtmParamFile_) {
+			THROW_EXCEPTION(StreamingSinkException, "Could not write to the file " << vtmParamFilePath_ << '.');
+		}
+	}
+}
+
+//==============================================================================
+
+JackStreamingSink::JackStreamingSink(double bufferDuration)
+		: bufferDuration_(bufferDuration)
+		, jackOutputPort_()
+		, waiting_()
+{
+	if (sem_init(&callbackSemaphore_, 0, 0) != 0) {
+		THROW_EXCEPTION(StreamingSinkException, "Could not create the semaphore.");
+	}
+}
+
+JackStreamingSink::~JackStreamingSink()
+{
+	stop();
+	jackClient_.reset();
+	sem_destroy(&callbackSemaphore_);
+}
+
+void
+JackStreamingSink::start(double sampleRate)
+{
+	const std::size_t ringbufferSize = static_cast<std::size_t>(bufferDuration_ * sampleRate)
+						* sizeof(jack_default_audio_sample_t);
+	ringbuffer_ = std::make_unique<JackRingbuffer>(ringbufferSize);
+
+	jackClient_ = std::make_unique<JackClient>(JackConfig::clientNamePlayer().c_str());
+	jackClient_->setProcessCallback(streaming_jack_process_callback, this);
+	jackClient_->setShutdownCallback(streaming_jack_shutdown_callback, this);
+
+	jack_port_t* port = jackClient_->registerPort("output", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+
+	jack_nframes_t jackSampleRate = jackClient_->getSampleRate();
+	if (jackSampleRate != static_cast<jack_nframes_t>(sampleRate + 0.5)) {
+		THROW_EXCEPTION(JackClientException, "Sampling rate mismatch (JACK: " << jackSampleRate
+				<< " GamaTTS: " << sampleRate << ").");
+	}
+	jackOutputPort_ = port;
+
+	jackClient_->activate();
+
+	JackPorts ports;
+	jackClient_->getPorts(JackConfig::destinationPortNameRegexp().c_str(), NULL, JackPortIsInput, ports);
+	if (ports.list == NULL) {
+		THROW_EXCEPTION(JackClientException, "No playback ports.");
+	}
+	for (std::size_t i = 0; i < 2 && ports.list[i]; ++i) {
+		jackClient_->connect(JackClient::portName(port), ports.list[i]);
+	}
+}
+
+void
+JackStreamingSink::writeAudio(const float* samples, std::size_t n)
+{
+	if (!ringbuffer_) {
+		THROW_EXCEPTION(StreamingSinkException, "The sink has not been started.");
+	}
+	const char* data = reinterpret_cast<const char*>(samples);
+	std::size_t size = n * sizeof(jack_default_audio_sample_t);
+	while (size > 0) {
+		if (!jackOutputPort_) {
+			THROW_EXCEPTION(StreamingSinkException, "The JACK client has been stopped.");
+		}
+		const std::size_t readSpace = ringbuffer_->readSpace();
+		// Write only whole samples.
+		const std::size_t space = ringbuffer_->writeSpace() / sizeof(jack_default_audio_sample_t)
+						* sizeof(jack_default_audio_sample_t);
+		if (space == 0) {
+			waitForCallback(readSpace);
+			continue;
+		}
+		const std::size_t written = ringbuffer_->write(data, std::min(size, space));
+		data += written;
+		size -= written;
+	}
+}
+
+void
+JackStreamingSink::finish()
+{
+	if (ringbuffer_) {
+		std::size_t readSpace;
+		while (jackOutputPort_ && (readSpace = ringbuffer_->readSpace()) > 0) {
+			waitForCallback(readSpace);
+		}
+	}
+	stop();
+}
+
+// Blocks until the callback has read from the ring buffer, or the client
+// has been stopped. readSpace is the value seen by the caller.
+void
+JackStreamingSink::waitForCallback(std::size_t readSpace)
+{
+	waiting_.store(true, std::memory_order_seq_cst);
+	// The callback may have run before the flag was set.
+	if (jackOutputPort_ && ringbuffer_->readSpace() >= readSpace) {
+		while (sem_wait(&callbackSemaphore_) != 0 && errno == EINTR) {}
+	}
+	waiting_.store(false, std::memory_order_relaxed);
+}
+
+int
+JackStreamingSink::callback(jack_nframes_t nframes)
+{
+	jack_port_t* port = jackOutputPort_.load();
+	if (!port) return 1; // end
+	jack_default_audio_sample_t* out =
+		static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer(port, nframes));
+
+	const std::size_t size = nframes * sizeof(jack_default_audio_sample_t);
+	const std::size_t read = ringbuffer_->read(reinterpret_cast<char*>(out), size);
+	// Underrun: fill with silence.
+	for (std::size_t i = read / sizeof(jack_default_audio_sample_t); i < nframes; ++i) {
+		out[i] = 0.0;
+	}
+	if (read > 0 && waiting_.load(std::memory_order_seq_cst)) {
+		sem_post(&callbackSemaphore_);
+	}
+	return 0;
+}
+
+void
+JackStreamingSink::stop()
+{
+	jackOutputPort_ = nullptr;
+	sem_post(&callbackSemaphore_);
+}
+
+} // namespace GS
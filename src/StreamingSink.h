@@ -0,0 +1,125 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef STREAMING_SINK_H
+#define STREAMING_SINK_H
+
+#include <atomic>
+#include <cstddef> /* std::size_t */
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <semaphore.h>
+
+#include <jack/jack.h>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+class JackClient;
+class JackRingbuffer;
+class WAVWriter;
+
+struct StreamingSinkException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Receives the output of StreamingSynthesis, one chunk at a time.
+class StreamingSink {
+public:
+	StreamingSink() = default;
+	virtual ~StreamingSink() = default;
+
+	virtual void start(double /*sampleRate*/) {}
+	// If the path is not empty, the controller writes the VTM parameters of
+	// each chunk to this file, and then appendParameterChunk() is called.
+	virtual std::string parameterChunkFilePath() const { return std::string(); }
+	virtual void appendParameterChunk() {}
+	virtual void writeAudio(const float* samples, std::size_t n) = 0;
+	// Called after the last chunk.
+	virtual void finish() {}
+private:
+	StreamingSink(const StreamingSink&) = delete;
+	StreamingSink& operator=(const StreamingSink&) = delete;
+	StreamingSink(StreamingSink&&) = delete;
+	StreamingSink& operator=(StreamingSink&&) = delete;
+};
+
+// Discards the data.
+class NullStreamingSink : public StreamingSink {
+public:
+	NullStreamingSink() = default;
+	virtual ~NullStreamingSink() = default;
+
+	virtual void writeAudio(const float* /*samples*/, std::size_t /*n*/) {}
+};
+
+// Writes the audio to a WAVE file and, optionally, the VTM parameters to a text file.
+// The parameter file is the concatenation of the files written by the controller.
+class WAVStreamingSink : public StreamingSink {
+public:
+	// If vtmParamFilePath is empty, the parameters are not saved.
+	WAVStreamingSink(const std::string& wavFilePath, const std::string& vtmParamFilePath);
+	virtual ~WAVStreamingSink();
+
+	virtual void start(double sampleRate);
+	virtual std::string parameterChunkFilePath() const { return vtmParamChunkFilePath_; }
+	virtual void appendParameterChunk();
+	virtual void writeAudio(const float* samples, std::size_t n);
+	virtual void finish();
+private:
+	std::string wavFilePath_;
+	std::string vtmParamFilePath_;
+	std::string vtmParamChunkFilePath_;
+	std::unique_ptr<WAVWriter> wavWriter_;
+	std::ofstream vtmParamFile_;
+};
+
+// Plays the audio using JACK.
+// writeAudio() blocks while the ring buffer is full. The JACK callback
+// wakes it up after reading from the buffer.
+class JackStreamingSink : public StreamingSink {
+public:
+	explicit JackStreamingSink(double bufferDuration=4.0 /* s */);
+	virtual ~JackStreamingSink();
+
+	virtual void start(double sampleRate);
+	virtual void writeAudio(const float* samples, std::size_t n);
+	// Waits until the end of the playback.
+	virtual void finish();
+
+	int callback(jack_nframes_t nframes);
+	void stop();
+private:
+	void waitForCallback(std::size_t readSpace);
+
+	double bufferDuration_;
+	std::unique_ptr<JackRingbuffer> ringbuffer_;
+	std::unique_ptr<JackClient> jackClient_;
+	std::atomic<jack_port_t*> jackOutputPort_;
+	std::atomic_bool waiting_;
+	sem_t callbackSemaphore_;
+};
+
+} // namespace GS
+
+#endif // STREAMING_SINK_H
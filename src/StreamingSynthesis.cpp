@@ -0,0 +1,134 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "StreamingSynthesis.h"
+
+#include <algorithm> /* max */
+#include <sstream>
+
+#include "Controller.h"
+#include "StreamingSink.h"
+
+#define CHUNK_MARKER "/c"
+#define TONE_GROUP_MARKER "//"
+
+
+
+namespace GS {
+
+StreamingSynthesis::StreamingSynthesis(VTMControlModel::Controller& controller, StreamingSink& sink,
+					std::size_t maxLookAhead)
+		: controller_(controller)
+		, sink_(sink)
+		, maxLookAhead_(maxLookAhead)
+		, started_()
+		, outputGain_()
+		, stats_()
+{
+}
+
+StreamingSynthesis::~StreamingSynthesis()
+{
+}
+
+void
+StreamingSynthesis::write(const std::string& phoneticStringPart)
+{
+	std::istringstream in(phoneticStringPart);
+	std::string token;
+	while (in >> token) {
+		if (token == CHUNK_MARKER) {
+			if (!chunk_.empty()) {
+				synthesizeChunk(chunk_);
+				chunk_.clear();
+			}
+			continue;
+		}
+		if (!chunk_.empty()) chunk_ += ' ';
+		chunk_ += token;
+		if (chunk_.size() > maxLookAhead_) {
+			splitLongChunk();
+		}
+	}
+}
+
+void
+StreamingSynthesis::finish()
+{
+	if (!chunk_.empty()) {
+		synthesizeChunk(chunk_);
+		chunk_.clear();
+	}
+	if (started_) {
+		sink_.finish();
+		started_ = false;
+	}
+}
+
+// Synthesizes the tone groups before the last tone group boundary.
+void
+StreamingSynthesis::splitLongChunk()
+{
+	const std::size_t pos = chunk_.rfind(" " TONE_GROUP_MARKER " ");
+	if (pos == std::string::npos || pos == 0) {
+		THROW_EXCEPTION(StreamingSynthesisException, "The phonetic string has a chunk longer than "
+				<< maxLookAhead_ << " bytes without tone group boundaries.");
+	}
+	// The boundary ends the first part.
+	synthesizeChunk(chunk_.substr(0, pos + 3));
+	chunk_.erase(0, pos + 4);
+}
+
+void
+StreamingSynthesis::synthesizeChunk(const std::string& chunk)
+{
+	const std::string phoneticString = CHUNK_MARKER " " + chunk + " " CHUNK_MARKER;
+	const std::string vtmParamFilePath = sink_.parameterChunkFilePath();
+	buffer_.clear();
+	controller_.synthesizePhoneticStringToBuffer(phoneticString,
+							vtmParamFilePath.empty() ? nullptr : vtmParamFilePath.c_str(),
+							buffer_);
+
+	if (!started_) {
+		sink_.start(controller_.outputSampleRate());
+		started_ = true;
+	}
+	if (!vtmParamFilePath.empty()) {
+		sink_.appendParameterChunk();
+	}
+
+	// The controller has scaled the chunk to its own peak.
+	const float chunkScale = controller_.outputScale();
+	if (chunkScale > 0.0f) {
+		if (outputGain_ == 0.0f || chunkScale < outputGain_) {
+			outputGain_ = chunkScale;
+		}
+		const float gain = outputGain_ / chunkScale;
+		if (gain != 1.0f) {
+			for (float& sample : buffer_) {
+				sample *= gain;
+			}
+		}
+	}
+	sink_.writeAudio(buffer_.data(), buffer_.size());
+
+	++stats_.numberOfChunks;
+	stats_.numberOfSamples += buffer_.size();
+	stats_.maxChunkSize = std::max(stats_.maxChunkSize, chunk.size());
+}
+
+} // namespace GS
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef STREAMING_SYNTHESIS_H
+#define STREAMING_SYNTHESIS_H
+
+#include <cstddef> /* std::size_t */
+#include <string>
+#include <vector>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+namespace VTMControlModel {
+class Controller;
+}
+class StreamingSink;
+
+struct StreamingSynthesisException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Synthesizes a phonetic string of any length with bounded memory.
+//
+// The phonetic string is received in parts. Each complete chunk (delimited
+// by /c) is synthesized as soon as it is available, and the VTM parameters
+// and the audio are sent to the sink. Only one chunk is kept in memory.
+//
+// The output gain is set by the first chunk and is only reduced when a
+// later chunk would clip. The chunks start and end with silence, so the
+// gain changes happen during silence.
+class StreamingSynthesis {
+public:
+	struct Statistics {
+		std::size_t numberOfChunks;
+		std::size_t numberOfSamples;
+		std::size_t maxChunkSize; // bytes of phonetic string
+	};
+
+	// maxLookAhead: maximum size of the pending phonetic string (bytes).
+	// If a chunk is longer, it is split at the last tone group boundary (//).
+	StreamingSynthesis(VTMControlModel::Controller& controller, StreamingSink& sink,
+				std::size_t maxLookAhead=64 * 1024);
+	~StreamingSynthesis();
+
+	// The part must end at a token boundary.
+	void write(const std::string& phoneticStringPart);
+	// Synthesizes the pending chunk and finishes the sink.
+	void finish();
+
+	const Statistics& statistics() const { return stats_; }
+private:
+	StreamingSynthesis(const StreamingSynthesis&) = delete;
+	StreamingSynthesis& operator=(const StreamingSynthesis&) = delete;
+	StreamingSynthesis(StreamingSynthesis&&) = delete;
+	StreamingSynthesis& operator=(StreamingSynthesis&&) = delete;
+
+	void synthesizeChunk(const std::string& chunk);
+	void splitLongChunk();
+
+	VTMControlModel::Controller& controller_;
+	StreamingSink& sink_;
+	const std::size_t maxLookAhead_;
+	bool started_;
+	std::string chunk_; // tokens after the last chunk marker
+	std::vector<float> buffer_;
+	float outputGain_; // 0: not set
+	Statistics stats_;
+};
+
+} // namespace GS
+
+#endif // STREAMING_SYNTHESIS_H
@@ -17,9 +17,16 @@
 
 #include "Synthesis.h"
 
+#include <string>
+
 #include "Index.h"
 #include "Controller.h"
+#include "ModelSnapshot.h"
+#include "ParallelSynthesis.h"
 #include "ParameterModificationSynthesis.h"
+#include "ReferenceModelCache.h"
+#include "SynthesisCache.h"
+#include "TextParserService.h"
 
 
 
@@ -27,10 +34,21 @@ namespace GS {
 
 Synthesis::Synthesis(const AppConfig& appConfigRef)
 	: appConfig(appConfigRef)
+	, model()
+	, textParserService()
+	, index()
 	, vtmController()
+	, vtmControllerShared()
+	, vtmControllerUsesModelCopy()
+	, vtmParamList()
 	, paramModifSynth()
-	, refModel()
-	, refVtmController()
+	, referenceModelCache(std::make_unique<ReferenceModelCache>())
+	, parallelSynthesis()
+	, modelSnapshot()
+	, cache(std::make_unique<SynthesisCache>())
+	, modelRevision()
+	, configuration()
+	, fixedIntonation()
 {
 }
 
@@ -41,11 +59,20 @@ Synthesis::~Synthesis()
 void
 Synthesis::clear()
 {
-	refVtmController.reset();
-	refModel.reset();
+	parallelSynthesis.reset();
+	modelSnapshot.reset();
+	cache->clear(); // the entries may contain controllers
+	referenceModelCache->clear();
 	paramModifSynth.reset();
+	vtmParamList.reset();
 	vtmController.reset();
+	vtmControllerShared = false;
+	vtmControllerUsesModelCopy = false;
 	index.reset();
+	textParserService.reset();
+	configuration.reset();
+	fixedIntonation = FixedIntonationParameters();
+	model = nullptr;
 }
 
 void
@@ -55,13 +82,46 @@ Synthesis::setup(VTMControlModel::Model* model)
 		clear();
 		return;
 	}
+	++modelRevision;
+	parallelSynthesis.reset();
+	modelSnapshot.reset();
+	cache->clear(); // the controllers of the entries may use the previous model
 	try {
-		index = std::make_unique<Index>(appConfig.projectDir.toStdString());
-		vtmController = std::make_unique<VTMControlModel::Controller>(*index, *model);
+		const std::string projectDir = appConfig.projectDir.toStdString();
+		if (!textParserService || textParserService->projectDir() != projectDir) {
+			textParserService = std::make_unique<TextParserService>(projectDir);
+		} else {
+			textParserService->checkForUpdates();
+		}
+		index = textParserService->index();
+		this->model = model;
+		vtmController = createController();
+		vtmControllerShared = false;
+		vtmControllerUsesModelCopy = false;
+		vtmParamList.reset();
+		configuration = std::make_shared<const VTMControlModel::Configuration>(
+					vtmController->vtmControlModelConfiguration());
+		fixedIntonation = FixedIntonationParameters(); // the new event list does not use them
 	} catch (...) {
 		clear();
 		throw;
 	}
 }
 
+std::shared_ptr<VTMControlModel::Controller>
+Synthesis::createController()
+{
+	std::shared_ptr<Index> indexPtr = index;
+	auto controller = std::make_unique<VTMControlModel::Controller>(*indexPtr, *model);
+	return std::shared_ptr<VTMControlModel::Controller>(controller.release(),
+		[indexPtr](VTMControlModel::Controller* c) { delete c; });
+}
+
+void
+Synthesis::loadReferenceModel()
+{
+	if (!index) return;
+	referenceModelCache->loadAsync(appConfig.dataFilePath.toStdString(), index);
+}
+
 } // namespace GS
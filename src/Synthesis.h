@@ -19,6 +19,7 @@
 #define SYNTHESIS_H
 
 #include <memory>
+#include <vector>
 
 #include "AppConfig.h"
 #include <QString>
@@ -28,20 +29,62 @@
 namespace GS {
 
 class Index;
+class ModelSnapshot;
 
 namespace VTMControlModel {
 class Controller;
 class Model;
+struct Configuration;
 }
+class ParallelSynthesis;
 class ParameterModificationSynthesis;
+class ReferenceModelCache;
+class SynthesisCache;
+class TextParserService;
+
+// Intonation parameters that replace the ones of the configuration
+// (EventList::setFixedIntonationParameters()).
+struct FixedIntonationParameters {
+	bool enabled;
+	double notionalPitch;
+	double pretonicPitchRange;
+	double pretonicPerturbationRange;
+	double tonicPitchRange;
+	double tonicPerturbationRange;
+
+	FixedIntonationParameters()
+		: enabled()
+		, notionalPitch()
+		, pretonicPitchRange()
+		, pretonicPerturbationRange()
+		, tonicPitchRange()
+		, tonicPerturbationRange()
+	{
+	}
+};
 
 struct Synthesis {
 	const AppConfig& appConfig;
-	std::unique_ptr<Index> index;
-	std::unique_ptr<VTMControlModel::Controller> vtmController;
+	VTMControlModel::Model* model; // not owned
+	std::unique_ptr<TextParserService> textParserService;
+	std::shared_ptr<Index> index; // shared with textParserService
+	std::shared_ptr<VTMControlModel::Controller> vtmController; // may be shared with the entries of the cache
+	bool vtmControllerShared; // vtmController is in the cache, its event list must be kept
+	bool vtmControllerUsesModelCopy; // vtmController came from a speculative result
+	// VTM parameters of the last parallel synthesis. The controller keeps only the parameters
+	// of the last chunk. Null if vtmController->vtmParameterList() is complete.
+	std::shared_ptr<const std::vector<std::vector<float>>> vtmParamList;
 	std::unique_ptr<ParameterModificationSynthesis> paramModifSynth;
-	std::unique_ptr<VTMControlModel::Model> refModel;
-	std::unique_ptr<VTMControlModel::Controller> refVtmController;
+	std::unique_ptr<ReferenceModelCache> referenceModelCache;
+	std::unique_ptr<ParallelSynthesis> parallelSynthesis; // created by SynthesisWorker when needed
+	std::shared_ptr<const ModelSnapshot> modelSnapshot; // created by SynthesisWorker when needed
+	std::unique_ptr<SynthesisCache> cache;
+	unsigned int modelRevision; // incremented when the model is modified
+	// Settings of the synthesis jobs. They are owned by the GUI thread, and copied
+	// into each job when it is submitted. The configuration is replaced, not modified,
+	// so the jobs can share it.
+	std::shared_ptr<const VTMControlModel::Configuration> configuration;
+	FixedIntonationParameters fixedIntonation;
 
 	explicit Synthesis(const AppConfig& appConfigRef);
 	~Synthesis();
@@ -52,6 +95,12 @@ struct Synthesis {
 
 	void clear();
 	void setup(VTMControlModel::Model* model);
+	// Creates a controller for the model. It keeps the index alive.
+	// Must be called after setup().
+	std::shared_ptr<VTMControlModel::Controller> createController();
+	// Loads the reference model from appConfig.dataFilePath in a background thread.
+	// Must be called after setup().
+	void loadReferenceModel();
 };
 
 } // namespace GS
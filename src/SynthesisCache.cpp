@@ -0,0 +1,197 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "SynthesisCache.h"
+
+#include <iterator> /* prev */
+
+#define DEFAULT_MAX_MEMORY_SIZE (256U * 1024U * 1024U)
+#define DEFAULT_MAX_NUMBER_OF_CONTROLLERS 16U
+#define CONTROLLER_MEMORY_SIZE (1024U * 1024U) /* estimate: state of the controller and of the VTM */
+
+
+
+namespace GS {
+
+SynthesisCache::SynthesisCache()
+		: memorySize_()
+		, maxMemorySize_(DEFAULT_MAX_MEMORY_SIZE)
+		, numberOfControllers_()
+		, maxNumberOfControllers_(DEFAULT_MAX_NUMBER_OF_CONTROLLERS)
+		, hits_()
+		, misses_()
+		, evictions_()
+{
+}
+
+std::shared_ptr<const SynthesisCache::Entry>
+SynthesisCache::find(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto iter = map_.find(key);
+	if (iter == map_.end()) {
+		++misses_;
+		return nullptr;
+	}
+	++hits_;
+
+	list_.splice(list_.begin(), list_, iter->second);
+	return iter->second->second;
+}
+
+bool
+SynthesisCache::contains(const std::string& key) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return map_.find(key) != map_.end();
+}
+
+void
+SynthesisCache::insert(const std::string& key, std::shared_ptr<const Entry> entry)
+{
+	if (!entry || !entry->audio || !entry->vtmParamList) return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto iter = map_.find(key);
+	if (iter != map_.end()) {
+		List::iterator item = iter->second;
+		map_.erase(iter);
+		erase(item);
+	}
+
+	const std::size_t size = memorySize(key, *entry);
+	if (size > maxMemorySize_) return;
+
+	if (entry->controller) ++numberOfControllers_;
+	list_.emplace_front(key, std::move(entry));
+	map_[key] = list_.begin();
+	memorySize_ += size;
+
+	evict();
+}
+
+void
+SynthesisCache::removeController(const VTMControlModel::Controller* controller)
+{
+	if (!controller) return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto iter = list_.begin(); iter != list_.end(); ) {
+		if (iter->second->controller.get() == controller) {
+			map_.erase(iter->first);
+			iter = erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+void
+SynthesisCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	map_.clear();
+	list_.clear();
+	memorySize_ = 0;
+	numberOfControllers_ = 0;
+}
+
+void
+SynthesisCache::setMaxMemorySize(std::size_t size)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	maxMemorySize_ = size;
+	evict();
+}
+
+void
+SynthesisCache::setMaxNumberOfControllers(std::size_t n)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	maxNumberOfControllers_ = n;
+	evict();
+}
+
+SynthesisCache::Statistics
+SynthesisCache::statistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Statistics stats;
+	stats.hits = hits_;
+	stats.misses = misses_;
+	stats.evictions = evictions_;
+	stats.numberOfEntries = list_.size();
+	stats.memorySize = memorySize_;
+	stats.maxMemorySize = maxMemorySize_;
+	stats.numberOfControllers = numberOfControllers_;
+	return stats;
+}
+
+std::size_t
+SynthesisCache::memorySize(const std::string& key, const Entry& entry)
+{
+	std::size_t size = sizeof(Entry) + key.size() + entry.audio->size() * sizeof(float);
+	std::size_t paramListSize = 0;
+	for (const auto& frame : *entry.vtmParamList) {
+		paramListSize += sizeof(frame) + frame.size() * sizeof(float);
+	}
+	size += paramListSize;
+	if (entry.controller) {
+		// Estimate: the controller keeps another copy of the parameters, and the event list.
+		size += 2 * paramListSize + CONTROLLER_MEMORY_SIZE + entry.modelMemorySize;
+	}
+	return size;
+}
+
+// The mutex must be locked. The item must have been removed from the map.
+SynthesisCache::List::iterator
+SynthesisCache::erase(List::iterator item)
+{
+	memorySize_ -= memorySize(item->first, *item->second);
+	if (item->second->controller) --numberOfControllers_;
+	return list_.erase(item);
+}
+
+// The mutex must be locked.
+void
+SynthesisCache::evict()
+{
+	while (memorySize_ > maxMemorySize_ && !list_.empty()) {
+		auto item = std::prev(list_.end());
+		map_.erase(item->first);
+		erase(item);
+		++evictions_;
+	}
+	// The least recently used entries that hold a controller.
+	for (auto iter = list_.end(); numberOfControllers_ > maxNumberOfControllers_ && iter != list_.begin(); ) {
+		--iter;
+		if (iter->second->controller) {
+			map_.erase(iter->first);
+			iter = erase(iter);
+			++evictions_;
+		}
+	}
+}
+
+} // namespace GS
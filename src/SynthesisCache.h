@@ -0,0 +1,115 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef SYNTHESIS_CACHE_H
+#define SYNTHESIS_CACHE_H
+
+#include <cstddef> /* std::size_t */
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility> /* pair */
+#include <vector>
+
+
+
+namespace GS {
+
+namespace VTMControlModel {
+class Controller;
+class Model;
+}
+
+// LRU cache of synthesis results.
+//
+// The key must identify everything that affects the result (phonetic string,
+// configuration, model revision, ...).
+// This class is thread-safe.
+class SynthesisCache {
+public:
+	struct Entry {
+		std::shared_ptr<const std::vector<float>> audio; // not null
+		std::shared_ptr<const std::vector<std::vector<float>>> vtmParamList; // not null
+		double outputSampleRate;
+		double vtmInternalSampleRate;
+		double controlRate;
+		// Controller whose event list has been used in the synthesis (may be null).
+		// It becomes Synthesis::vtmController (or the displayed reference controller)
+		// when the result is played, so the event list is not generated again.
+		std::shared_ptr<VTMControlModel::Controller> controller;
+		std::shared_ptr<VTMControlModel::Model> referenceModel; // not null if the controller uses the reference model
+		bool modelCopy; // the controller uses its own copy of the model (speculative result)
+		std::size_t modelMemorySize; // estimate of the memory used by the copy of the model (bytes)
+	};
+
+	struct Statistics {
+		unsigned long hits;
+		unsigned long misses;
+		unsigned long evictions;
+		std::size_t numberOfEntries;
+		std::size_t memorySize;    // bytes
+		std::size_t maxMemorySize; // bytes
+		std::size_t numberOfControllers; // entries that hold a controller
+	};
+
+	SynthesisCache();
+	~SynthesisCache() = default;
+
+	// Returns nullptr if the key is not in the cache.
+	std::shared_ptr<const Entry> find(const std::string& key);
+	// Does not change the statistics or the order of the entries.
+	bool contains(const std::string& key) const;
+	// Entries larger than the memory limit are not stored.
+	void insert(const std::string& key, std::shared_ptr<const Entry> entry);
+	// Removes the entries that use the controller.
+	// Must be called before the event list of the controller is modified.
+	void removeController(const VTMControlModel::Controller* controller);
+	void clear();
+	void setMaxMemorySize(std::size_t size);
+	// Each controller keeps its event list and the state of the VTM alive,
+	// and possibly a copy of the model.
+	void setMaxNumberOfControllers(std::size_t n);
+	Statistics statistics() const;
+private:
+	typedef std::list<std::pair<std::string, std::shared_ptr<const Entry>>> List;
+
+	SynthesisCache(const SynthesisCache&) = delete;
+	SynthesisCache& operator=(const SynthesisCache&) = delete;
+	SynthesisCache(SynthesisCache&&) = delete;
+	SynthesisCache& operator=(SynthesisCache&&) = delete;
+
+	static std::size_t memorySize(const std::string& key, const Entry& entry);
+	List::iterator erase(List::iterator item);
+	void evict();
+
+	mutable std::mutex mutex_;
+	List list_; // the most recently used entry is the first
+	std::unordered_map<std::string, List::iterator> map_;
+	std::size_t memorySize_;
+	std::size_t maxMemorySize_;
+	std::size_t numberOfControllers_;
+	std::size_t maxNumberOfControllers_;
+	unsigned long hits_;
+	unsigned long misses_;
+	unsigned long evictions_;
+};
+
+} // namespace GS
+
+#endif // SYNTHESIS_CACHE_H
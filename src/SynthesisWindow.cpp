@@ -17,30 +17,65 @@
 
 #include "SynthesisWindow.h"
 
+#include <algorithm> /* max, min */
 #include <cmath> /* rint */
+#include <exception>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility> /* move */
 
+#include <QDateTime>
+#include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QProcess>
 #include <QScrollBar>
 #include <QString>
 #include <QStringList>
+#include <QTextStream>
 
 #include "AudioWorker.h"
 #include "Controller.h"
 #include "Index.h"
 #include "Model.h"
+#include "ModelSnapshot.h"
+#include "ParallelSynthesis.h"
 #include "PhoneticStringParser.h"
+#include "ReferenceModelCache.h"
+#include "ScopedTimer.h"
 #include "Synthesis.h"
-#include "TextParser.h"
+#include "SynthesisCache.h"
+#include "TextParserService.h"
 #include "ui_SynthesisWindow.h"
+#include "VTMParameterFile.h"
 
-#define VTM_PARAM_FILE_NAME "generated__vtm_param.txt"
+#define VTM_PARAM_FILE_NAME "generated__vtm_param.vtmp"
+#define TIMING_LOG_FILE_NAME "generated__synthesis_timing.log"
+#define TIMING_LOG_MAX_SIZE (1024 * 1024)
+#define TIMING_PANEL_MAX_LINES 200
+#define SPECULATIVE_SYNTHESIS_DELAY_MS 400
+#define PLAYBACK_UPDATE_INTERVAL_MS 50
 
 
 
+namespace {
+
+// Adjusts the sample rate because the Controller rounds the control period.
+double
+adjustedSpeechSampleRate(double outputSampleRate, double vtmInternalSampleRate, double controlRate)
+{
+	const double controlPeriod = vtmInternalSampleRate / controlRate;
+	const double roundedControlPeriod = std::rint(controlPeriod);
+	const double sampleRate = outputSampleRate * (roundedControlPeriod / controlPeriod);
+	qDebug("Adjusted speech sample rate: %f", sampleRate);
+	return sampleRate;
+}
+
+} // namespace
+
 namespace GS {
 
 SynthesisWindow::SynthesisWindow(QWidget* parent)
@@ -49,7 +84,22 @@ SynthesisWindow::SynthesisWindow(QWidget* parent)
 		, model_()
 		, synthesis_()
 		, audioWorker_()
+		, synthesisWorker_()
+		, speculativeWorker_()
 		, speechSamplerate_()
+		, numberOfActiveJobs_()
+		, numberOfSubmittedJobs_()
+		, firstValidJobId_()
+		, previewJobId_()
+		, phoneticStringSynthesized_()
+		, referenceSynthesized_()
+		, audioPlaying_()
+		, textParserTime_()
+		, speculativeJobActive_()
+		, speculativeJobId_()
+		, waitingForSpeculativeJob_()
+		, numberOfSpeculativeResults_()
+		, numberOfUsedSpeculativeResults_()
 {
 	ui_->setupUi(this);
 
@@ -78,11 +128,20 @@ SynthesisWindow::SynthesisWindow(QWidget* parent)
 
 	ui_->parameterScrollArea->setBackgroundRole(QPalette::Base);
 
+	ui_->timingTextEdit->setMaximumBlockCount(TIMING_PANEL_MAX_LINES);
+	ui_->timingTextEdit->setVisible(false);
+
+	ui_->synthesisProgressBar->setFormat(tr("Synthesis: %v/%m"));
+	updateProgress();
+	updateCacheStatus();
+
 	connect(ui_->textLineEdit   , &QLineEdit::returnPressed   , ui_->parseButton, &QPushButton::click);
 	connect(ui_->parameterWidget, &ParameterWidget::mouseMoved, this            , &SynthesisWindow::updateMouseTracking);
 	connect(ui_->parameterWidget, &ParameterWidget::zoomReset , this            , &SynthesisWindow::resetZoom);
-	connect(ui_->parameterScrollArea->verticalScrollBar()  , &QScrollBar::valueChanged, ui_->parameterWidget, &ParameterWidget::getVerticalScrollbarValue);
-	connect(ui_->parameterScrollArea->horizontalScrollBar(), &QScrollBar::valueChanged, ui_->parameterWidget, &ParameterWidget::getHorizontalScrollbarValue);
+	connect(ui_->parameterScrollArea->verticalScrollBar(), &QScrollBar::valueChanged, ui_->parameterWidget, &ParameterWidget::getVerticalScrollbarValue);
+	connect(ui_->parameterWidget        , &ParameterWidget::overviewChanged  , this                        , &SynthesisWindow::updateParameterOverview);
+	connect(ui_->parameterWidget        , &ParameterWidget::viewChanged      , ui_->parameterOverviewWidget, &ParameterOverviewWidget::setView);
+	connect(ui_->parameterOverviewWidget, &ParameterOverviewWidget::viewMoved, ui_->parameterWidget        , &ParameterWidget::setViewStartTime);
 
 	audioWorker_ = new AudioWorker;
 	audioWorker_->moveToThread(&audioThread_);
@@ -95,10 +154,58 @@ SynthesisWindow::SynthesisWindow(QWidget* parent)
 	connect(audioWorker_ , &AudioWorker::errorOccurred,
 			this        , &SynthesisWindow::handleAudioError);
 	audioThread_.start();
+
+	synthesisWorker_ = new SynthesisWorker;
+	synthesisWorker_->moveToThread(&synthesisThread_);
+	connect(&synthesisThread_, &QThread::finished,
+			synthesisWorker_, &SynthesisWorker::deleteLater);
+	connect(synthesisWorker_ , &SynthesisWorker::jobStarted,
+			this            , &SynthesisWindow::handleSynthesisJobStarted);
+	connect(synthesisWorker_ , &SynthesisWorker::jobFinished,
+			this            , &SynthesisWindow::handleSynthesisJobFinished);
+	connect(synthesisWorker_ , &SynthesisWorker::jobFailed,
+			this            , &SynthesisWindow::handleSynthesisJobFailed);
+	connect(synthesisWorker_ , &SynthesisWorker::jobCancelled,
+			this            , &SynthesisWindow::handleSynthesisJobCancelled);
+	connect(synthesisWorker_ , &SynthesisWorker::audioBlockReady,
+			this            , &SynthesisWindow::handleSynthesisAudioBlock);
+	synthesisThread_.start();
+
+	// The speculative jobs do not delay the jobs requested by the user.
+	speculativeWorker_ = new SynthesisWorker;
+	speculativeWorker_->moveToThread(&speculativeThread_);
+	connect(&speculativeThread_, &QThread::finished,
+			speculativeWorker_, &SynthesisWorker::deleteLater);
+	connect(speculativeWorker_ , &SynthesisWorker::jobFinished,
+			this              , &SynthesisWindow::handleSpeculativeJobFinished);
+	connect(speculativeWorker_ , &SynthesisWorker::jobFailed,
+			this              , &SynthesisWindow::handleSpeculativeJobFailed);
+	connect(speculativeWorker_ , &SynthesisWorker::jobCancelled,
+			this              , &SynthesisWindow::handleSpeculativeJobCancelled);
+	speculativeThread_.start(QThread::IdlePriority);
+
+	speculativeTimer_.setSingleShot(true);
+	speculativeTimer_.setInterval(SPECULATIVE_SYNTHESIS_DELAY_MS);
+	connect(&speculativeTimer_, &QTimer::timeout, this, &SynthesisWindow::startSpeculativeSynthesis);
+	connect(ui_->phoneticStringTextEdit, &QPlainTextEdit::textChanged,
+			this, &SynthesisWindow::restartSpeculativeSynthesis);
+	connect(ui_->tempoSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+			this, &SynthesisWindow::restartSpeculativeSynthesis);
+
+	playbackTimer_.setInterval(PLAYBACK_UPDATE_INTERVAL_MS);
+	connect(&playbackTimer_, &QTimer::timeout, this, &SynthesisWindow::updatePlayback);
 }
 
 SynthesisWindow::~SynthesisWindow()
 {
+	synthesisWorker_->cancelAll();
+	synthesisThread_.quit();
+	synthesisThread_.wait();
+
+	speculativeWorker_->cancelAll();
+	speculativeThread_.quit();
+	speculativeThread_.wait();
+
 	audioThread_.quit();
 	audioThread_.wait();
 }
@@ -106,10 +213,16 @@ SynthesisWindow::~SynthesisWindow()
 void
 SynthesisWindow::clear()
 {
+	stopSynthesis();
+	synthesisWorker_->setSynthesis(nullptr);
+
 	ui_->parameterTableWidget->setRowCount(0);
 	ui_->parameterWidget->updateData(nullptr, nullptr, nullptr, nullptr);
+	displayedReference_ = ReferenceModelCache::Reference();
 	synthesis_ = nullptr;
 	model_ = nullptr;
+	unusedSpeculativeKeySet_.clear();
+	updateCacheStatus();
 }
 
 void
@@ -120,10 +233,40 @@ SynthesisWindow::setup(VTMControlModel::Model* model, Synthesis* synthesis)
 		return;
 	}
 
+	stopSynthesis();
+
 	model_ = model;
 	synthesis_ = synthesis;
+	synthesisWorker_->setSynthesis(synthesis);
+	unusedSpeculativeKeySet_.clear();
 
 	setupParameterWidget(false);
+	updateCacheStatus();
+}
+
+void
+SynthesisWindow::stopSynthesis()
+{
+	synthesisWorker_->cancelAll();
+	synthesisWorker_->waitUntilIdle();
+
+	// The signals of the old jobs may still be in the event queue.
+	firstValidJobId_ = synthesisWorker_->nextJobId();
+	pendingPlaybackResult_.reset();
+	phoneticStringSynthesized_ = false;
+	previewJobId_ = 0;
+	pendingCacheEntry_.reset();
+	speculativeTimer_.stop();
+	// The speculative worker uses only the objects in the jobs, it is not necessary to wait.
+	speculativeWorker_->cancelAll();
+	speculativeJobActive_ = false;
+	waitingForSpeculativeJob_ = false;
+	speculativeModelSnapshot_.reset(); // the model may be replaced
+	if (numberOfActiveJobs_ > 0) {
+		numberOfActiveJobs_ = 0;
+		emit synthesisFinished();
+	}
+	updateProgress();
 }
 
 void
@@ -136,18 +279,16 @@ SynthesisWindow::on_parseButton_clicked()
 	if (text.trimmed().isEmpty()) {
 		return;
 	}
-	disableProcessingButtons();
 
 	try {
-		Index index{synthesis_->appConfig.projectDir.toStdString()};
-		auto textParser = TextParser::TextParser::getInstance(
-					index,
-					synthesis_->vtmController->vtmControlModelConfiguration().phoStrFormat);
-		std::string phoneticString = textParser->parse(text.toUtf8().constData());
+		textParserTime_ = 0.0;
+		ScopedTimer timer(ui_->timingCheckBox->isChecked() ? &textParserTime_ : nullptr);
+		std::string phoneticString = synthesis_->textParserService->parse(
+						text.toUtf8().constData(),
+						*synthesis_->configuration);
 		ui_->phoneticStringTextEdit->setPlainText(phoneticString.c_str());
 	} catch (const Exception& exc) {
 		QMessageBox::critical(this, tr("Error"), exc.what());
-		enableProcessingButtons();
 		return;
 	}
 
@@ -165,47 +306,15 @@ SynthesisWindow::on_referenceButton_clicked()
 		return;
 	}
 
-	emit synthesisStarted();
-	disableProcessingButtons();
-
-	try {
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
-		}
-
-		synthesis_->refModel = std::make_unique<VTMControlModel::Model>();
-		synthesis_->refModel->load(synthesis_->appConfig.dataFilePath.toStdString());
-		if (synthesis_->refModel->parameterList().size() != model_->parameterList().size()) {
-			QMessageBox::critical(this, tr("Error"), "The reference model has not the same number of parameters as the current model.");
-			enableProcessingButtons();
-			emit synthesisFinished();
-			return;
-		}
-
-		synthesis_->refVtmController = std::make_unique<VTMControlModel::Controller>(
-							*synthesis_->index,
-							*synthesis_->refModel);
-		VTMControlModel::Configuration& config = synthesis_->refVtmController->vtmControlModelConfiguration();
-		config.tempo = ui_->tempoSpinBox->value();
-
-		audioWorker_->player().fillBuffer([&](std::vector<float>& buffer) {
-			synthesis_->refVtmController->synthesizePhoneticStringToBuffer(
-								phoneticString.toStdString(),
-								saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-								buffer);
-		});
-
-		setupParameterWidget(true);
-
-		emit playAudioRequested(synthesis_->refVtmController->outputSampleRate());
-		emit textSynthesized();
-	} catch (const Exception& exc) {
-		QMessageBox::critical(this, tr("Error"), exc.what());
-		enableProcessingButtons();
-		emit synthesisFinished();
-	}
+	SynthesisJob job = createJob(SynthesisJob::Type::phoneticStringToBuffer);
+	job.reference = true;
+	job.tempo = ui_->tempoSpinBox->value();
+	job.phoneticString = phoneticString.toStdString();
+	job.vtmParamFilePath = vtmParamFilePath().toStdString();
+	job.numberOfParameters = model_->parameterList().size();
+	job.cacheKey = cacheKey(job);
+	if (playFromCache(job)) return;
+	submitJob(job);
 }
 
 void
@@ -219,35 +328,19 @@ SynthesisWindow::on_synthesizeButton_clicked()
 		return;
 	}
 
-	emit synthesisStarted();
-	disableProcessingButtons();
-
-	try {
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
-		}
-
-		VTMControlModel::Configuration& config = synthesis_->vtmController->vtmControlModelConfiguration();
-		config.tempo = ui_->tempoSpinBox->value();
-
-		audioWorker_->player().fillBuffer([&](std::vector<float>& buffer) {
-			synthesis_->vtmController->synthesizePhoneticStringToBuffer(
-							phoneticString.toStdString().c_str(),
-							saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-							buffer);
-		});
-
-		setupParameterWidget(false);
-
-		emit playAudioRequested(synthesis_->vtmController->outputSampleRate());
-		emit textSynthesized();
-	} catch (const Exception& exc) {
-		QMessageBox::critical(this, tr("Error"), exc.what());
-		enableProcessingButtons();
-		emit synthesisFinished();
+	SynthesisJob job = createJob(SynthesisJob::Type::phoneticStringToBuffer);
+	job.tempo = ui_->tempoSpinBox->value();
+	job.phoneticString = phoneticString.toStdString();
+	job.vtmParamFilePath = vtmParamFilePath().toStdString();
+	job.cacheKey = cacheKey(job);
+	if (speculativeJobActive_ && !job.cacheKey.empty() && job.cacheKey == speculativeJobKey_) {
+		// The result will be available soon.
+		waitingForSpeculativeJob_ = true;
+		waitingJob_ = job;
+		return;
 	}
+	if (playFromCache(job)) return;
+	submitPhoneticStringJob(job);
 }
 
 void
@@ -265,33 +358,51 @@ SynthesisWindow::on_synthesizeToFileButton_clicked()
 		return;
 	}
 
-	emit synthesisStarted();
-	disableProcessingButtons();
-
-	try {
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
-		}
-
-		VTMControlModel::Configuration& config = synthesis_->vtmController->vtmControlModelConfiguration();
-		config.tempo = ui_->tempoSpinBox->value();
+	SynthesisJob job = createJob(SynthesisJob::Type::phoneticStringToFile);
+	job.tempo = ui_->tempoSpinBox->value();
+	job.phoneticString = phoneticString.toStdString();
+	job.vtmParamFilePath = vtmParamFilePath().toStdString();
+	job.wavFilePath = filePath.toStdString();
+	job.cacheKey = cacheKey(job);
+	submitPhoneticStringJob(job);
+}
 
-		synthesis_->vtmController->synthesizePhoneticStringToFile(
-						phoneticString.toStdString(),
-						saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-						filePath.toStdString().c_str());
+void
+SynthesisWindow::on_cancelButton_clicked()
+{
+	synthesisWorker_->cancelAll();
+	pendingPlaybackResult_.reset();
+	waitingForSpeculativeJob_ = false;
+}
 
-		setupParameterWidget(false);
+void
+SynthesisWindow::on_parallelCheckBox_toggled(bool checked)
+{
+	ui_->verifyParallelCheckBox->setEnabled(checked);
+}
 
-		emit textSynthesized();
-	} catch (const Exception& exc) {
-		QMessageBox::critical(this, tr("Error"), exc.what());
+void
+SynthesisWindow::on_speculativeCheckBox_toggled(bool checked)
+{
+	if (checked) {
+		restartSpeculativeSynthesis();
+	} else {
+		speculativeTimer_.stop();
+		cancelSpeculativeSynthesis();
 	}
+	updateCacheStatus();
+}
 
-	enableProcessingButtons();
-	emit synthesisFinished();
+void
+SynthesisWindow::on_spectrogramCheckBox_toggled(bool checked)
+{
+	ui_->parameterWidget->setSpectrogramEnabled(checked);
+}
+
+void
+SynthesisWindow::on_timingCheckBox_toggled(bool checked)
+{
+	ui_->timingTextEdit->setVisible(checked);
 }
 
 // Slot.
@@ -301,38 +412,12 @@ SynthesisWindow::synthesizeWithManualIntonation()
 	if (!synthesis_) {
 		return;
 	}
+	// The intonation has been saved to the event list.
+	synthesis_->cache->removeController(synthesis_->vtmController.get());
 
-	emit synthesisStarted();
-	disableProcessingButtons();
-
-	try {
-		auto& eventList = synthesis_->vtmController->eventList();
-		if (eventList.list().empty()) {
-			return;
-		}
-		eventList.clearMacroIntonation();
-		eventList.prepareMacroIntonationInterpolation();
-
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
-		}
-
-		audioWorker_->player().fillBuffer([&](std::vector<float>& buffer) {
-			synthesis_->vtmController->synthesizeFromEventListToBuffer(
-							saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-							buffer);
-		});
-
-		setupParameterWidget(false);
-
-		emit playAudioRequested(synthesis_->vtmController->outputSampleRate());
-	} catch (const Exception& exc) {
-		QMessageBox::critical(this, tr("Error"), exc.what());
-		enableProcessingButtons();
-		emit synthesisFinished();
-	}
+	SynthesisJob job = createJob(SynthesisJob::Type::eventListToBuffer);
+	job.vtmParamFilePath = vtmParamFilePath().toStdString();
+	submitJob(job);
 }
 
 // Slot.
@@ -342,36 +427,13 @@ SynthesisWindow::synthesizeToFileWithManualIntonation(QString filePath)
 	if (!synthesis_) {
 		return;
 	}
+	// The intonation has been saved to the event list.
+	synthesis_->cache->removeController(synthesis_->vtmController.get());
 
-	emit synthesisStarted();
-	disableProcessingButtons();
-
-	try {
-		auto& eventList = synthesis_->vtmController->eventList();
-		if (eventList.list().empty()) {
-			return;
-		}
-		eventList.clearMacroIntonation();
-		eventList.prepareMacroIntonationInterpolation();
-
-		QString vtmParamFilePath;
-		bool saveVTMParam = ui_->saveVTMParamCheckBox->isChecked();
-		if (saveVTMParam) {
-			vtmParamFilePath = synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
-		}
-
-		synthesis_->vtmController->synthesizeFromEventListToFile(
-						saveVTMParam ? vtmParamFilePath.toStdString().c_str() : nullptr,
-						filePath.toStdString().c_str());
-
-		setupParameterWidget(false);
-
-	} catch (const Exception& exc) {
-		QMessageBox::critical(this, tr("Error"), exc.what());
-	}
-
-	enableProcessingButtons();
-	emit synthesisFinished();
+	SynthesisJob job = createJob(SynthesisJob::Type::eventListToFile);
+	job.vtmParamFilePath = vtmParamFilePath().toStdString();
+	job.wavFilePath = filePath.toStdString();
+	submitJob(job);
 }
 
 void
@@ -411,6 +473,13 @@ SynthesisWindow::setupParameterTable()
 	ui_->parameterWidget->handleModelUpdate();
 }
 
+// Slot.
+void
+SynthesisWindow::updateParameterOverview()
+{
+	ui_->parameterOverviewWidget->setOverview(ui_->parameterWidget->overview());
+}
+
 // Slot.
 void
 SynthesisWindow::updateMouseTracking(double time, double value)
@@ -428,25 +497,237 @@ SynthesisWindow::updateMouseTracking(double time, double value)
 void
 SynthesisWindow::handleAudioError(QString msg)
 {
+	// AudioWorker::finished will be emitted next.
 	QMessageBox::critical(this, tr("Error"), msg);
-
-	enableProcessingButtons();
-	emit synthesisFinished();
 }
 
 // Slot.
 void
 SynthesisWindow::handleAudioFinished()
 {
-	if (synthesis_->refVtmController) {
-		setSpeechSignal(*synthesis_->refVtmController);
-	} else {
-		setSpeechSignal(*synthesis_->vtmController);
+	audioPlaying_ = false;
+	playbackTimer_.stop();
+	if (playbackResult_) {
+		if (playbackResult_->measureTime) {
+			playbackResult_->timing.audioStartTime = audioWorker_->player().startupTime();
+			reportTiming(*playbackResult_);
+		}
+		appendSpeechSignal(playbackResult_->audio->size());
+		ui_->parameterWidget->setPlayheadTime(-1.0);
+		playbackResult_.reset();
 	}
 	ui_->parameterWidget->update();
 
-	enableProcessingButtons();
-	emit synthesisFinished();
+	if (pendingPlaybackResult_) {
+		startPlayback(std::move(pendingPlaybackResult_));
+		pendingPlaybackResult_.reset();
+	}
+}
+
+// Slot.
+//
+// Shows the part of the speech signal that has been played.
+void
+SynthesisWindow::updatePlayback()
+{
+	if (!playbackResult_) return;
+
+	appendSpeechSignal(audioWorker_->player().playbackPosition());
+	if (speechSamplerate_ > 0.0) {
+		ui_->parameterWidget->setPlayheadTime(speechSignal_.size() * (1000.0 / speechSamplerate_)); // convert to ms
+	}
+}
+
+// Slot.
+void
+SynthesisWindow::handleSynthesisJobStarted(unsigned int jobId, unsigned int /*numberOfPendingJobs*/)
+{
+	if (jobId < firstValidJobId_) return;
+
+	updateProgress();
+}
+
+// Slot.
+void
+SynthesisWindow::handleSynthesisJobFinished(GS::SynthesisResultPtr result)
+{
+	if (result->jobId < firstValidJobId_) return;
+
+	if (result->type == SynthesisJob::Type::phoneticStringToBuffer ||
+			result->type == SynthesisJob::Type::phoneticStringToFile) {
+		phoneticStringSynthesized_ = true;
+	}
+	referenceSynthesized_ = result->reference;
+	if (result->reference) {
+		// Kept while it is displayed, because the reference model may be reloaded.
+		displayedReference_ = result->referenceObjects;
+	}
+
+	if (result->type == SynthesisJob::Type::phoneticStringToBuffer && !result->cacheKey.empty()) {
+		insertIntoCache(*result);
+		updateCacheStatus();
+	}
+
+	if (result->parallel && result->parallelStatistics.verified) {
+		QMessageBox::information(this, tr("Parallel synthesis"),
+			tr("Segments: %1\nMaximum difference from the serial synthesis: %2\nSize difference: %3 samples")
+				.arg(result->parallelStatistics.numberOfSegments)
+				.arg(result->parallelStatistics.maxError)
+				.arg(result->parallelStatistics.sizeDifference));
+	}
+
+	if (result->type == SynthesisJob::Type::phoneticStringToBuffer ||
+			result->type == SynthesisJob::Type::eventListToBuffer) {
+		// The timing will be reported at the end of the playback.
+		if (audioPlaying_) {
+			// AudioPlayer::setBuffer would block until the end of the playback.
+			pendingPlaybackResult_ = result;
+		} else {
+			startPlayback(result);
+		}
+	} else {
+		if (result->measureTime) reportTiming(*result);
+	}
+
+	finishJob(result->jobId);
+}
+
+// Slot.
+void
+SynthesisWindow::handleSynthesisJobFailed(unsigned int jobId, QString msg)
+{
+	if (jobId < firstValidJobId_) return;
+
+	QMessageBox::critical(this, tr("Error"), msg);
+
+	finishJob(jobId);
+}
+
+// Slot.
+void
+SynthesisWindow::handleSynthesisJobCancelled(unsigned int jobId)
+{
+	if (jobId < firstValidJobId_) return;
+
+	finishJob(jobId);
+}
+
+// Slot.
+//
+// Shows the speech signal of the current job while it is being synthesized.
+// The signal is shown again from the start when the playback begins.
+void
+SynthesisWindow::handleSynthesisAudioBlock(GS::SynthesisAudioBlockPtr block)
+{
+	if (block->jobId < firstValidJobId_ || numberOfActiveJobs_ == 0 || playbackResult_) return;
+
+	if (block->jobId != previewJobId_) {
+		previewJobId_ = block->jobId;
+		clearSpeechSignal();
+		speechSamplerate_ = adjustedSpeechSampleRate(block->outputSampleRate, block->vtmInternalSampleRate,
+								block->controlRate);
+		ui_->parameterWidget->updateData(nullptr, nullptr, &speechSignal_, &speechSamplerate_);
+		ui_->parameterWidget->setViewStartTime(0.0);
+	}
+	const std::size_t first = speechSignal_.size();
+	if (block->firstSample != first) return; // the blocks are emitted in order
+
+	const std::size_t size = first + block->samples.size();
+	if (size > speechSignal_.capacity()) {
+		speechSignal_.reserve(std::max({size, block->expectedSize, 2U * speechSignal_.capacity()}));
+	}
+	speechSignal_.insert(speechSignal_.end(), block->samples.begin(), block->samples.end());
+	ui_->parameterWidget->handleSpeechSignalAppend(first);
+	ui_->parameterWidget->setPlayheadTime(speechSignal_.size() * (1000.0 / speechSamplerate_)); // convert to ms
+}
+
+// Slot.
+void
+SynthesisWindow::handleSpeculativeJobFinished(GS::SynthesisResultPtr result)
+{
+	if (!speculativeJobActive_ || result->jobId != speculativeJobId_) return;
+
+	finishSpeculativeJob(std::move(result));
+}
+
+// Slot.
+//
+// Errors will be reported if the user requests the synthesis.
+void
+SynthesisWindow::handleSpeculativeJobFailed(unsigned int jobId, QString /*msg*/)
+{
+	if (!speculativeJobActive_ || jobId != speculativeJobId_) return;
+
+	finishSpeculativeJob(nullptr);
+}
+
+// Slot.
+void
+SynthesisWindow::handleSpeculativeJobCancelled(unsigned int jobId)
+{
+	if (!speculativeJobActive_ || jobId != speculativeJobId_) return;
+
+	finishSpeculativeJob(nullptr);
+}
+
+// Slot.
+void
+SynthesisWindow::restartSpeculativeSynthesis()
+{
+	if (!ui_->speculativeCheckBox->isChecked()) return;
+
+	cancelSpeculativeSynthesis();
+	speculativeTimer_.start();
+}
+
+// Slot.
+//
+// Synthesizes the current phonetic string with the speculative controller
+// and stores the result in the cache.
+void
+SynthesisWindow::startSpeculativeSynthesis()
+{
+	if (!synthesis_ || !ui_->speculativeCheckBox->isChecked()) {
+		return;
+	}
+	if (numberOfActiveJobs_ > 0 || speculativeJobActive_) {
+		// The jobs of the user have priority.
+		speculativeTimer_.start();
+		return;
+	}
+	QString phoneticString = ui_->phoneticStringTextEdit->toPlainText();
+	if (phoneticString.trimmed().isEmpty()) {
+		return;
+	}
+
+	SynthesisJob job = createJob(SynthesisJob::Type::phoneticStringToBuffer);
+	job.tempo = ui_->tempoSpinBox->value();
+	job.phoneticString = phoneticString.toStdString();
+	job.cacheKey = cacheKey(job);
+	if (job.cacheKey.empty() || synthesis_->cache->contains(job.cacheKey)) {
+		return;
+	}
+
+	// The model is saved here, because it is modified in this thread.
+	// The speculative worker loads its copy of the model from the snapshot.
+	try {
+		if (!speculativeModelSnapshot_ ||
+				speculativeModelSnapshot_->modelRevision() != synthesis_->modelRevision) {
+			speculativeModelSnapshot_.reset();
+			speculativeModelSnapshot_ = std::make_shared<const ModelSnapshot>(*model_, synthesis_->modelRevision);
+		}
+	} catch (const std::exception& exc) {
+		qWarning("Could not save the model for the speculative synthesis: %s", exc.what());
+		speculativeModelSnapshot_.reset();
+		return;
+	}
+
+	job.speculative = true;
+	job.index = synthesis_->index;
+	job.modelSnapshot = speculativeModelSnapshot_;
+	speculativeJobKey_ = job.cacheKey;
+	speculativeJobId_ = speculativeWorker_->submit(job);
+	speculativeJobActive_ = true;
 }
 
 void
@@ -463,17 +744,24 @@ SynthesisWindow::clearSpeechSignal()
 	speechSamplerate_ = 0.0;
 }
 
+// Appends the samples [speechSignal_.size(), end) of the current playback to the speech signal.
+// The samples that have already been appended are not copied again.
 void
-SynthesisWindow::setSpeechSignal(VTMControlModel::Controller& controller)
+SynthesisWindow::appendSpeechSignal(std::size_t end)
 {
-	audioWorker_->player().copyBuffer(speechSignal_);
-
-	// Adjust the sample rate because the Controller rounds the control period.
-	const double controlPeriod = controller.vtmInternalSampleRate() /
-					controller.vtmControlModelConfiguration().controlRate;
-	const double roundedControlPeriod = std::rint(controlPeriod);
-	speechSamplerate_ = controller.outputSampleRate() * (roundedControlPeriod / controlPeriod);
-	qDebug("Adjusted speech sample rate: %f", speechSamplerate_);
+	const SynthesisResult& result = *playbackResult_;
+	const std::vector<float>& audio = *result.audio;
+	end = std::min(end, audio.size());
+	const std::size_t first = speechSignal_.size();
+	if (end <= first) return;
+
+	if (first == 0) {
+		speechSignal_.reserve(audio.size());
+		speechSamplerate_ = adjustedSpeechSampleRate(result.outputSampleRate, result.vtmInternalSampleRate,
+								result.controlRate);
+	}
+	speechSignal_.insert(speechSignal_.end(), audio.begin() + first, audio.begin() + end);
+	ui_->parameterWidget->handleSpeechSignalAppend(first);
 }
 
 void
@@ -503,17 +791,433 @@ void
 SynthesisWindow::setupParameterWidget(bool reference)
 {
 	clearSpeechSignal();
-	if (reference) {
-		ui_->parameterWidget->updateData(&synthesis_->refVtmController->eventList(), synthesis_->refModel.get(),
+	if (!reference) displayedReference_ = ReferenceModelCache::Reference();
+	if (displayedReference_.controller) {
+		ui_->parameterWidget->updateData(&displayedReference_.controller->eventList(),
+							displayedReference_.model.get(),
 							&speechSignal_, &speechSamplerate_);
 	} else {
 		ui_->parameterWidget->updateData(&synthesis_->vtmController->eventList(), model_,
 							&speechSignal_, &speechSamplerate_);
-		synthesis_->refVtmController.reset();
-		synthesis_->refModel.reset();
 	}
 	setupParameterTable();
 	ui_->parameterWidget->update();
 }
 
+// The settings are copied, so they can be changed while the job is in the queue.
+SynthesisJob
+SynthesisWindow::createJob(SynthesisJob::Type type)
+{
+	SynthesisJob job;
+	job.type = type;
+	job.modelRevision = synthesis_->modelRevision;
+	job.configuration = synthesis_->configuration;
+	job.fixedIntonation = synthesis_->fixedIntonation;
+	return job;
+}
+
+QString
+SynthesisWindow::vtmParamFilePath()
+{
+	if (!ui_->saveVTMParamCheckBox->isChecked()) {
+		return QString();
+	}
+	return synthesis_->appConfig.projectDir + VTM_PARAM_FILE_NAME;
+}
+
+// Identifies everything except the phonetic string that affects the result.
+// Returns an empty string if the result must not be reused.
+std::string
+SynthesisWindow::configurationKey(const SynthesisJob& job)
+{
+	if (job.type != SynthesisJob::Type::phoneticStringToBuffer &&
+			job.type != SynthesisJob::Type::phoneticStringToFile) {
+		return std::string();
+	}
+
+	const VTMControlModel::Configuration& config = *job.configuration;
+	if (config.randomIntonation) {
+		// Each synthesis produces a different result.
+		return std::string();
+	}
+
+	std::ostringstream key;
+	key.precision(std::numeric_limits<double>::max_digits10);
+	key << synthesis_->modelRevision
+		<< ' ' << job.reference
+		<< ' ' << job.tempo
+		<< ' ' << config.controlRate
+		<< ' ' << config.microIntonation
+		<< ' ' << config.macroIntonation
+		<< ' ' << config.smoothIntonation
+		<< ' ' << config.intonationDrift
+		<< ' ' << config.driftDeviation
+		<< ' ' << config.driftLowpassCutoff
+		<< ' ' << config.notionalPitch
+		<< ' ' << config.pretonicPitchRange
+		<< ' ' << config.pretonicPerturbationRange
+		<< ' ' << config.tonicPitchRange
+		<< ' ' << config.tonicPerturbationRange;
+	const FixedIntonationParameters& fixedIntonation = job.fixedIntonation;
+	key << ' ' << fixedIntonation.enabled;
+	if (fixedIntonation.enabled) {
+		key << ' ' << fixedIntonation.notionalPitch
+			<< ' ' << fixedIntonation.pretonicPitchRange
+			<< ' ' << fixedIntonation.pretonicPerturbationRange
+			<< ' ' << fixedIntonation.tonicPitchRange
+			<< ' ' << fixedIntonation.tonicPerturbationRange;
+	}
+	if (job.reference) {
+		// The reference model is loaded from the file.
+		try {
+			key << ' ' << synthesis_->referenceModelCache->contentHash();
+		} catch (const std::exception&) {
+			// The worker will report the error.
+			return std::string();
+		}
+	}
+	return key.str();
+}
+
+// Returns an empty string if the result must not be cached.
+std::string
+SynthesisWindow::cacheKey(const SynthesisJob& job)
+{
+	std::string key = configurationKey(job);
+	if (key.empty()) return key;
+	return key + '\n' + job.phoneticString;
+}
+
+// Plays the cached audio, if available.
+bool
+SynthesisWindow::playFromCache(const SynthesisJob& job)
+{
+	if (job.cacheKey.empty()) return false;
+
+	std::shared_ptr<const SynthesisCache::Entry> entry = synthesis_->cache->find(job.cacheKey);
+	if (entry && unusedSpeculativeKeySet_.erase(job.cacheKey) > 0) {
+		++numberOfUsedSpeculativeResults_;
+	}
+	updateCacheStatus();
+	if (!entry) return false;
+
+	if (!job.vtmParamFilePath.empty()) {
+		try {
+			VTMParameterFile::writeBinary(job.vtmParamFilePath, entry->controlRate,
+							VTMParameterFile::parameterNameList(*model_), *entry->vtmParamList);
+		} catch (const std::exception& exc) {
+			QMessageBox::critical(this, tr("Error"), exc.what());
+		}
+	}
+
+	if (entry->controller) {
+		useCachedController(entry);
+	}
+
+	auto result = std::make_shared<SynthesisResult>();
+	result->jobId = 0;
+	result->type = job.type;
+	result->reference = job.reference;
+	result->audio = entry->audio; // shared
+	result->outputSampleRate = entry->outputSampleRate;
+	result->vtmInternalSampleRate = entry->vtmInternalSampleRate;
+	result->controlRate = entry->controlRate;
+	if (audioPlaying_) {
+		pendingPlaybackResult_ = result;
+	} else {
+		startPlayback(result);
+	}
+	return true;
+}
+
+// Shows the event list of the cached result. If there are active jobs,
+// the controller is replaced when they end.
+void
+SynthesisWindow::useCachedController(std::shared_ptr<const SynthesisCache::Entry> entry)
+{
+	pendingCacheEntry_.reset();
+	if (numberOfActiveJobs_ > 0) {
+		pendingCacheEntry_ = std::move(entry);
+		return;
+	}
+
+	if (entry->referenceModel) {
+		if (referenceSynthesized_ && displayedReference_.controller == entry->controller) return;
+	} else {
+		if (!referenceSynthesized_ && synthesis_->vtmController == entry->controller) return;
+	}
+	const bool replaced = setCachedController(*entry);
+	setupParameterWidget(referenceSynthesized_);
+	if (replaced) {
+		emit eventListReplaced();
+		emit textSynthesized();
+	}
+}
+
+// Returns true if Synthesis::vtmController has been replaced.
+// The worker must be idle.
+bool
+SynthesisWindow::setCachedController(const SynthesisCache::Entry& entry)
+{
+	referenceSynthesized_ = static_cast<bool>(entry.referenceModel);
+	if (referenceSynthesized_) {
+		displayedReference_.model = entry.referenceModel;
+		displayedReference_.controller = entry.controller;
+		return false;
+	}
+	if (synthesis_->vtmController == entry.controller) return false;
+	synthesis_->vtmController = entry.controller;
+	synthesis_->vtmControllerShared = true;
+	synthesis_->vtmControllerUsesModelCopy = entry.modelCopy;
+	synthesis_->vtmParamList = entry.vtmParamList;
+	return true;
+}
+
+void
+SynthesisWindow::updateCacheStatus()
+{
+	if (!synthesis_) {
+		ui_->cacheStatusLabel->clear();
+		return;
+	}
+	const SynthesisCache::Statistics stats = synthesis_->cache->statistics();
+	QString status = tr("Cache: %1 hits, %2 misses, %3 MiB").arg(stats.hits).arg(stats.misses)
+					.arg(stats.memorySize / (1024.0 * 1024.0), 0, 'f', 1);
+	if (ui_->speculativeCheckBox->isChecked() || numberOfSpeculativeResults_ > 0) {
+		status += tr(" - Background: %1/%2 used, %3 s discarded")
+				.arg(numberOfUsedSpeculativeResults_).arg(numberOfSpeculativeResults_)
+				.arg(speculativeWorker_->discardedSpeculativeCpuTime(), 0, 'f', 2);
+	}
+	ui_->cacheStatusLabel->setText(status);
+}
+
+void
+SynthesisWindow::insertIntoCache(SynthesisResult& result)
+{
+	auto entry = std::make_shared<SynthesisCache::Entry>();
+	entry->audio = result.audio; // shared
+	entry->vtmParamList = std::move(result.vtmParamList);
+	entry->outputSampleRate = result.outputSampleRate;
+	entry->vtmInternalSampleRate = result.vtmInternalSampleRate;
+	entry->controlRate = result.controlRate;
+	entry->controller = std::move(result.controller);
+	if (result.reference && entry->controller) {
+		entry->referenceModel = result.referenceObjects.model;
+	}
+	entry->modelCopy = result.speculative;
+	entry->modelMemorySize = result.modelMemorySize;
+	synthesis_->cache->insert(result.cacheKey, std::move(entry));
+}
+
+// Does not cancel the job if the user is waiting for its result.
+void
+SynthesisWindow::cancelSpeculativeSynthesis()
+{
+	if (speculativeJobActive_ && !waitingForSpeculativeJob_) {
+		speculativeWorker_->cancelAll();
+	}
+}
+
+// result is nullptr if the job has failed or has been cancelled.
+void
+SynthesisWindow::finishSpeculativeJob(SynthesisResultPtr result)
+{
+	speculativeJobActive_ = false;
+	if (result) {
+		++numberOfSpeculativeResults_;
+		insertIntoCache(*result);
+		unusedSpeculativeKeySet_.insert(result->cacheKey);
+	}
+	updateCacheStatus();
+
+	if (waitingForSpeculativeJob_) {
+		waitingForSpeculativeJob_ = false;
+		SynthesisJob job = std::move(waitingJob_);
+		waitingJob_ = SynthesisJob();
+		if (playFromCache(job)) return;
+		submitPhoneticStringJob(job);
+	}
+}
+
+void
+SynthesisWindow::submitJob(SynthesisJob job)
+{
+	cancelSpeculativeSynthesis();
+	pendingCacheEntry_.reset(); // the job will change the controller
+	job.measureTime = ui_->timingCheckBox->isChecked();
+	job.textParserTime = textParserTime_;
+	textParserTime_ = 0.0;
+
+	if (numberOfActiveJobs_ == 0) {
+		// The worker will modify the event list.
+		ui_->parameterWidget->updateData(nullptr, nullptr, nullptr, nullptr);
+		displayedReference_ = ReferenceModelCache::Reference();
+		numberOfSubmittedJobs_ = 0;
+		emit synthesisStarted();
+	}
+	selectController(job);
+	++numberOfActiveJobs_;
+	++numberOfSubmittedJobs_;
+
+	synthesisWorker_->submit(job);
+	updateProgress();
+}
+
+// Selects the controller of the job. The controllers whose event list is
+// in the cache are not modified by the worker.
+void
+SynthesisWindow::selectController(SynthesisJob& job)
+{
+	if (job.reference) {
+		// The event list of the reference controller will be displayed.
+		job.keepReferenceController = true;
+		return;
+	}
+	if ((job.type == SynthesisJob::Type::phoneticStringToBuffer ||
+			job.type == SynthesisJob::Type::phoneticStringToFile) &&
+			(synthesis_->vtmControllerShared || synthesis_->vtmControllerUsesModelCopy)) {
+		// The controller is in the cache, or it came from a speculative
+		// result and uses an old copy of the model.
+		synthesis_->vtmController = synthesis_->createController();
+		synthesis_->vtmControllerShared = false;
+		synthesis_->vtmControllerUsesModelCopy = false;
+	}
+	job.controller = synthesis_->vtmController;
+	if (job.type == SynthesisJob::Type::phoneticStringToBuffer && !job.cacheKey.empty()) {
+		// The result will be cached with the controller.
+		synthesis_->vtmControllerShared = true;
+	}
+}
+
+// Uses the parallel synthesis if it is enabled and the phonetic string has more than one chunk.
+// The incremental synthesis also uses ParallelSynthesis, which keeps the chunks of the
+// previous synthesis.
+void
+SynthesisWindow::submitPhoneticStringJob(SynthesisJob job)
+{
+	const bool incremental = ui_->incrementalCheckBox->isChecked();
+	if ((!ui_->parallelCheckBox->isChecked() && !incremental) ||
+			ParallelSynthesis::splitPhoneticString(job.phoneticString).size() < 2) {
+		submitJob(job);
+		return;
+	}
+	job.parallel = true;
+	job.verifyParallel = ui_->parallelCheckBox->isChecked() && ui_->verifyParallelCheckBox->isChecked();
+	if (incremental) {
+		job.segmentReuseKey = configurationKey(job);
+	}
+	submitJob(job);
+}
+
+void
+SynthesisWindow::finishJob(unsigned int /*jobId*/)
+{
+	if (numberOfActiveJobs_ == 0) return;
+
+	if (--numberOfActiveJobs_ == 0) {
+		// The worker is idle, the controllers can be accessed again.
+		previewJobId_ = 0;
+		if (pendingCacheEntry_) {
+			if (setCachedController(*pendingCacheEntry_)) {
+				phoneticStringSynthesized_ = true;
+			}
+			pendingCacheEntry_.reset();
+		}
+		setupParameterWidget(referenceSynthesized_);
+		emit synthesisFinished();
+		if (phoneticStringSynthesized_) {
+			phoneticStringSynthesized_ = false;
+			emit textSynthesized();
+		}
+	}
+	updateProgress();
+}
+
+void
+SynthesisWindow::startPlayback(SynthesisResultPtr result)
+{
+	// The samples in result are appended to the speech signal during the playback.
+	audioWorker_->player().setBuffer(result->audio);
+	playbackResult_ = std::move(result);
+	audioPlaying_ = true;
+	clearSpeechSignal();
+	ui_->parameterWidget->handleSpeechSignalUpdate();
+	playbackTimer_.start();
+
+	emit playAudioRequested(playbackResult_->outputSampleRate);
+}
+
+void
+SynthesisWindow::updateProgress()
+{
+	const bool busy = numberOfActiveJobs_ > 0;
+	ui_->synthesisProgressBar->setVisible(busy);
+	ui_->cancelButton->setEnabled(busy);
+	if (busy) {
+		ui_->synthesisProgressBar->setMaximum(numberOfSubmittedJobs_);
+		ui_->synthesisProgressBar->setValue(numberOfSubmittedJobs_ - numberOfActiveJobs_);
+	}
+}
+
+void
+SynthesisWindow::reportTiming(const SynthesisResult& result)
+{
+	if (!ui_->timingCheckBox->isChecked()) return;
+
+	const SynthesisTiming& t = result.timing;
+	auto ms = [](double s) { return QString::number(s * 1.0e3, 'f', 1); };
+
+	QString typeName;
+	switch (result.type) {
+	case SynthesisJob::Type::phoneticStringToBuffer: typeName = result.reference ? "reference" : "synthesis"; break;
+	case SynthesisJob::Type::phoneticStringToFile:   typeName = "synthesis_to_file"; break;
+	case SynthesisJob::Type::eventListToBuffer:      typeName = "manual_intonation"; break;
+	case SynthesisJob::Type::eventListToFile:        typeName = "manual_intonation_to_file"; break;
+	}
+
+	QStringList fields;
+	fields << QDateTime::currentDateTime().toString(Qt::ISODate) << typeName;
+	if (t.textParserTime > 0.0)           fields << "text_parser_ms=" + ms(t.textParserTime);
+	fields << "queue_ms=" + ms(t.queueTime);
+	if (t.referenceModelLoadTime > 0.0)   fields << "reference_model_load_ms=" + ms(t.referenceModelLoadTime);
+	if (t.eventListPreparationTime > 0.0) fields << "event_list_preparation_ms=" + ms(t.eventListPreparationTime);
+	fields << "controller_ms=" + ms(t.controllerTime);
+	if (t.audioStartTime > 0.0)           fields << "audio_start_ms=" + ms(t.audioStartTime);
+	if (result.parallel) {
+		fields << "segments=" + QString::number(result.parallelStatistics.numberOfSegments)
+			<< "reused_segments=" + QString::number(result.parallelStatistics.numberOfReusedSegments)
+			<< "reused_joins=" + QString::number(result.parallelStatistics.numberOfReusedJoins);
+	}
+	if (t.audioDuration > 0.0) {
+		fields << "audio_s=" + QString::number(t.audioDuration, 'f', 3)
+			<< "rtf=" + QString::number(t.controllerTime / t.audioDuration, 'f', 3);
+	}
+
+	const QString line = fields.join(' ');
+	ui_->timingTextEdit->appendPlainText(line);
+	appendToTimingLog(line);
+}
+
+// When the file reaches the maximum size, it is renamed to *.1 and a new file is created.
+void
+SynthesisWindow::appendToTimingLog(const QString& line)
+{
+	if (!synthesis_) return;
+
+	const QString filePath = synthesis_->appConfig.projectDir + TIMING_LOG_FILE_NAME;
+	if (QFileInfo(filePath).size() > TIMING_LOG_MAX_SIZE) {
+		const QString oldFilePath = filePath + ".1";
+		QFile::remove(oldFilePath);
+		QFile::rename(filePath, oldFilePath);
+	}
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+		qWarning("Could not open the file %s.", qPrintable(filePath));
+		return;
+	}
+	QTextStream out(&file);
+	out << line << '\n';
+}
+
 } // namespace GS
@@ -19,12 +19,18 @@
 #define SYNTHESIS_WINDOW_H
 
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <QString>
 #include <QThread>
+#include <QTimer>
 #include <QWidget>
 
+#include "SynthesisCache.h"
+#include "SynthesisWorker.h"
+
 
 
 namespace Ui {
@@ -48,11 +54,16 @@ public:
 
 	void clear();
 	void setup(VTMControlModel::Model* model, Synthesis* synthesis);
+
+	// Cancels the synthesis jobs and waits for the worker.
+	// Must be called before the controllers in Synthesis are replaced.
+	void stopSynthesis();
 signals:
 	void textSynthesized();
 	void playAudioRequested(double sampleRate);
 	void synthesisStarted();
 	void synthesisFinished();
+	void eventListReplaced(); // Synthesis::vtmController has been replaced by a cached controller
 public slots:
 	void setupParameterTable();
 	void synthesizeWithManualIntonation();
@@ -64,13 +75,30 @@ private slots:
 	void on_referenceButton_clicked();
 	void on_synthesizeButton_clicked();
 	void on_synthesizeToFileButton_clicked();
+	void on_cancelButton_clicked();
+	void on_parallelCheckBox_toggled(bool checked);
+	void on_speculativeCheckBox_toggled(bool checked);
+	void on_spectrogramCheckBox_toggled(bool checked);
+	void on_timingCheckBox_toggled(bool checked);
 	void on_parameterTableWidget_cellChanged(int row, int column);
 	void on_xZoomSpinBox_valueChanged(double d);
 	void on_yZoomSpinBox_valueChanged(double d);
 	void updateMouseTracking(double time, double value);
+	void updateParameterOverview();
 	void handleAudioError(QString msg);
 	void handleAudioFinished();
+	void handleSynthesisJobStarted(unsigned int jobId, unsigned int numberOfPendingJobs);
+	void handleSynthesisJobFinished(GS::SynthesisResultPtr result);
+	void handleSynthesisJobFailed(unsigned int jobId, QString msg);
+	void handleSynthesisJobCancelled(unsigned int jobId);
+	void handleSynthesisAudioBlock(GS::SynthesisAudioBlockPtr block);
+	void handleSpeculativeJobFinished(GS::SynthesisResultPtr result);
+	void handleSpeculativeJobFailed(unsigned int jobId, QString msg);
+	void handleSpeculativeJobCancelled(unsigned int jobId);
+	void restartSpeculativeSynthesis();
+	void startSpeculativeSynthesis();
 	void resetZoom();
+	void updatePlayback();
 private:
 	SynthesisWindow(const SynthesisWindow&) = delete;
 	SynthesisWindow& operator=(const SynthesisWindow&) = delete;
@@ -78,17 +106,65 @@ private:
 	SynthesisWindow& operator=(SynthesisWindow&&) = delete;
 
 	void clearSpeechSignal();
-	void setSpeechSignal(VTMControlModel::Controller& controller);
+	void appendSpeechSignal(std::size_t end);
 	void setProcessingButtonsEnabled(bool enabled);
 	void setupParameterWidget(bool reference=false);
+	SynthesisJob createJob(SynthesisJob::Type type);
+	QString vtmParamFilePath();
+	std::string configurationKey(const SynthesisJob& job);
+	std::string cacheKey(const SynthesisJob& job);
+	bool playFromCache(const SynthesisJob& job);
+	void useCachedController(std::shared_ptr<const SynthesisCache::Entry> entry);
+	bool setCachedController(const SynthesisCache::Entry& entry);
+	void updateCacheStatus();
+	void submitJob(SynthesisJob job);
+	void selectController(SynthesisJob& job);
+	void submitPhoneticStringJob(SynthesisJob job);
+	void finishJob(unsigned int jobId);
+	void startPlayback(SynthesisResultPtr result);
+	void updateProgress();
+	void insertIntoCache(SynthesisResult& result);
+	void cancelSpeculativeSynthesis();
+	void finishSpeculativeJob(SynthesisResultPtr result);
+	void reportTiming(const SynthesisResult& result);
+	void appendToTimingLog(const QString& line);
 
 	std::unique_ptr<Ui::SynthesisWindow> ui_;
 	VTMControlModel::Model* model_;
 	Synthesis* synthesis_;
 	QThread audioThread_;
 	AudioWorker* audioWorker_;
+	QThread synthesisThread_;
+	SynthesisWorker* synthesisWorker_;
+	QThread speculativeThread_;
+	SynthesisWorker* speculativeWorker_; // executes only the speculative jobs
 	std::vector<float> speechSignal_;
 	double speechSamplerate_;
+
+	unsigned int numberOfActiveJobs_;
+	unsigned int numberOfSubmittedJobs_; // since the worker became busy
+	unsigned int firstValidJobId_; // results of older jobs are ignored
+	unsigned int previewJobId_; // job whose audio blocks are in the speech signal (0: none)
+	bool phoneticStringSynthesized_;
+	bool referenceSynthesized_;
+	ReferenceModelCache::Reference displayedReference_; // objects of the last reference synthesis
+	bool audioPlaying_;
+	SynthesisResultPtr playbackResult_;
+	SynthesisResultPtr pendingPlaybackResult_; // waiting for the end of the current playback
+	std::shared_ptr<const SynthesisCache::Entry> pendingCacheEntry_; // its controller will be used when the jobs end
+	double textParserTime_; // s - will be reported with the next job
+
+	QTimer speculativeTimer_; // debounces the edits of the phonetic string
+	QTimer playbackTimer_; // shows the played part of the speech signal
+	std::shared_ptr<const ModelSnapshot> speculativeModelSnapshot_;
+	bool speculativeJobActive_; // only one speculative job is submitted at a time
+	unsigned int speculativeJobId_;
+	std::string speculativeJobKey_;
+	bool waitingForSpeculativeJob_; // the user requested the result of the active speculative job
+	SynthesisJob waitingJob_;
+	std::unordered_set<std::string> unusedSpeculativeKeySet_; // cached results that have not been played
+	unsigned int numberOfSpeculativeResults_;
+	unsigned int numberOfUsedSpeculativeResults_;
 };
 
 } // namespace GS
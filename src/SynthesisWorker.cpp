@@ -0,0 +1,452 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "SynthesisWorker.h"
+
+#include <algorithm> /* max */
+#include <exception>
+#include <functional>
+#include <time.h> /* clock_gettime */
+#include <utility> /* move */
+
+#include "Controller.h"
+#include "EventList.h"
+#include "Exception.h"
+#include "Index.h"
+#include "Model.h"
+#include "ModelSnapshot.h"
+#include "ParallelSynthesis.h"
+#include "ReferenceModelCache.h"
+#include "ScopedTimer.h"
+#include "Synthesis.h"
+#include "Trace.h"
+#include "VTMParameterFile.h"
+#include "VTMUtil.h"
+#include "WAVWriter.h"
+
+
+
+namespace {
+
+// ns.
+std::uint64_t
+threadCpuTime()
+{
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+	return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000U + ts.tv_nsec;
+}
+
+// Applies the settings that were copied into the job when it was submitted.
+// The tempo of the event lists is not changed.
+void
+configureController(const GS::SynthesisJob& job, GS::VTMControlModel::Controller& controller)
+{
+	GS::VTMControlModel::Configuration& config = controller.vtmControlModelConfiguration();
+	const double tempo = config.tempo;
+	config = *job.configuration;
+	if (job.type == GS::SynthesisJob::Type::phoneticStringToBuffer ||
+			job.type == GS::SynthesisJob::Type::phoneticStringToFile) {
+		config.tempo = job.tempo;
+	} else {
+		config.tempo = tempo;
+	}
+
+	const GS::FixedIntonationParameters& fixedIntonation = job.fixedIntonation;
+	GS::VTMControlModel::EventList& eventList = controller.eventList();
+	if (fixedIntonation.enabled) {
+		eventList.setFixedIntonationParameters(
+					fixedIntonation.notionalPitch,
+					fixedIntonation.pretonicPitchRange,
+					fixedIntonation.pretonicPerturbationRange,
+					fixedIntonation.tonicPitchRange,
+					fixedIntonation.tonicPerturbationRange);
+		eventList.setUseFixedIntonationParameters(true);
+	} else {
+		eventList.setUseFixedIntonationParameters(false);
+	}
+}
+
+} // namespace
+
+namespace GS {
+
+SynthesisWorker::SynthesisWorker(QObject* parent)
+		: QObject(parent)
+		, synthesis_()
+		, running_()
+		, nextJobId_(1)
+		, generation_()
+		, discardedSpeculativeCpuTime_()
+		, speculativeModel_()
+		, speculativeController_()
+		, speculativeControllerShared_()
+		, speculativeIndex_()
+		, speculativeModelRevision_()
+{
+	qRegisterMetaType<GS::SynthesisResultPtr>("GS::SynthesisResultPtr");
+	qRegisterMetaType<GS::SynthesisAudioBlockPtr>("GS::SynthesisAudioBlockPtr");
+
+	connect(this, &SynthesisWorker::jobSubmitted,
+			this, &SynthesisWorker::processJobs, Qt::QueuedConnection);
+}
+
+unsigned int
+SynthesisWorker::submit(const SynthesisJob& job)
+{
+	unsigned int id;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		id = nextJobId_++;
+		queue_.push_back(QueueItem{id, generation_.load(), job});
+		if (job.measureTime) {
+			queue_.back().job.submitTime = std::chrono::steady_clock::now();
+		}
+	}
+	emit jobSubmitted();
+	return id;
+}
+
+void
+SynthesisWorker::cancelAll()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	++generation_;
+}
+
+double
+SynthesisWorker::discardedSpeculativeCpuTime() const
+{
+	return discardedSpeculativeCpuTime_.load() * 1.0e-9;
+}
+
+void
+SynthesisWorker::waitUntilIdle()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	idleCondition_.wait(lock, [&]() { return queue_.empty() && !running_; });
+}
+
+unsigned int
+SynthesisWorker::nextJobId()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return nextJobId_;
+}
+
+// Slot.
+void
+SynthesisWorker::processJobs()
+{
+	if (Trace::enabled()) Trace::setThreadName("synthesis_worker");
+
+	for (;;) {
+		QueueItem item;
+		unsigned int numberOfPendingJobs;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (queue_.empty()) {
+				running_ = false;
+				idleCondition_.notify_all();
+				return;
+			}
+			item = std::move(queue_.front());
+			queue_.pop_front();
+			numberOfPendingJobs = queue_.size();
+			running_ = true;
+		}
+
+		if (isCancelled(item)) {
+			emit jobCancelled(item.id);
+			continue;
+		}
+		emit jobStarted(item.id, numberOfPendingJobs);
+
+		auto result = std::make_shared<SynthesisResult>();
+		result->jobId = item.id;
+		result->measureTime = item.job.measureTime;
+		if (item.job.measureTime) {
+			result->timing.textParserTime = item.job.textParserTime;
+			result->timing.queueTime = std::chrono::duration<double>(
+							std::chrono::steady_clock::now() - item.job.submitTime).count();
+		}
+		const std::uint64_t cpuTime0 = item.job.speculative ? threadCpuTime() : 0;
+		try {
+			TraceSpan span(item.job.speculative ? "speculative_synthesis_job" : "synthesis_job", "synthesis");
+			execute(item.job, *result);
+		} catch (const std::exception& exc) {
+			if (item.job.speculative) {
+				discardedSpeculativeCpuTime_ += threadCpuTime() - cpuTime0;
+			}
+			emit jobFailed(item.id, QString(exc.what()));
+			continue;
+		}
+		if (item.job.speculative) {
+			const std::uint64_t cpuTime = threadCpuTime() - cpuTime0;
+			result->cpuTime = cpuTime * 1.0e-9;
+			if (isCancelled(item)) {
+				discardedSpeculativeCpuTime_ += cpuTime;
+			}
+		}
+
+		if (isCancelled(item)) {
+			emit jobCancelled(item.id);
+			continue;
+		}
+		emit jobFinished(result);
+	}
+}
+
+bool
+SynthesisWorker::isCancelled(const QueueItem& item) const
+{
+	return item.generation != generation_;
+}
+
+void
+SynthesisWorker::execute(const SynthesisJob& job, SynthesisResult& result)
+{
+	if (!job.speculative && (!synthesis_ || (!job.reference && !job.controller))) {
+		THROW_EXCEPTION(InvalidValueException, "The synthesis has not been configured.");
+	}
+	if (!job.reference && !job.configuration) {
+		THROW_EXCEPTION(InvalidValueException, "The job has no configuration.");
+	}
+	SynthesisTiming& timing = result.timing;
+	const bool measureTime = job.measureTime;
+	const bool phoneticString = job.type == SynthesisJob::Type::phoneticStringToBuffer ||
+					job.type == SynthesisJob::Type::phoneticStringToFile;
+	// The intonation drift continues from one chunk to the next,
+	// so the chunks cannot be synthesized independently.
+	const bool parallel = job.parallel && !job.reference && phoneticString &&
+				!job.speculative && !job.configuration->intonationDrift;
+
+	VTMControlModel::Controller* controller = nullptr;
+	const VTMControlModel::Model* model = nullptr;
+	if (job.speculative) {
+		if (!job.index || !job.modelSnapshot || job.type != SynthesisJob::Type::phoneticStringToBuffer ||
+				!job.vtmParamFilePath.empty()) {
+			THROW_EXCEPTION(InvalidValueException, "Invalid speculative job.");
+		}
+		TraceSpan span("speculative_controller_setup", "synthesis");
+		controller = &speculativeController(job);
+	} else if (job.reference) {
+		TraceSpan span("reference_model_load", "synthesis");
+		ScopedTimer timer(measureTime ? &timing.referenceModelLoadTime : nullptr);
+		// The result keeps the objects alive, even if the model is reloaded.
+		result.referenceObjects = synthesis_->referenceModelCache->get(job.keepReferenceController);
+		controller = result.referenceObjects.controller.get();
+		model = result.referenceObjects.model.get();
+		if (model->parameterList().size() != job.numberOfParameters) {
+			THROW_EXCEPTION(InvalidValueException,
+				"The reference model has not the same number of parameters as the current model.");
+		}
+		// The reference controller keeps its own configuration.
+		controller->vtmControlModelConfiguration().tempo = job.tempo;
+	} else {
+		controller = job.controller.get();
+		model = synthesis_->model;
+	}
+	if (!job.reference) {
+		configureController(job, *controller);
+	}
+
+	auto audio = std::make_shared<std::vector<float>>();
+	if (parallel) {
+		TraceSpan span("parallel_synthesis", "synthesis");
+		ScopedTimer timer(measureTime ? &timing.controllerTime : nullptr);
+		ParallelSynthesis& parallelSynth = parallelSynthesis(job.modelRevision);
+		auto vtmParamList = std::make_shared<std::vector<std::vector<float>>>();
+		std::function<void(const std::vector<float>&, std::size_t, std::size_t)> progress;
+		float maxValue = 0.0;
+		if (job.type == SynthesisJob::Type::phoneticStringToBuffer) {
+			// The final scale depends on the entire audio, the blocks use
+			// the scale of the samples that have been published.
+			progress = [&](const std::vector<float>& partialAudio, std::size_t firstSample, std::size_t expectedSize) {
+				auto block = std::make_shared<SynthesisAudioBlock>();
+				block->jobId = result.jobId;
+				block->firstSample = firstSample;
+				block->expectedSize = expectedSize;
+				block->samples.assign(partialAudio.begin() + firstSample, partialAudio.end());
+				maxValue = std::max(maxValue, VTM::Util::maximumAbsoluteValue(block->samples));
+				const float scale = VTM::Util::calculateOutputScale(maxValue);
+				for (float& sample : block->samples) {
+					sample *= scale;
+				}
+				block->outputSampleRate = controller->outputSampleRate();
+				block->vtmInternalSampleRate = controller->vtmInternalSampleRate();
+				block->controlRate = controller->vtmControlModelConfiguration().controlRate;
+				emit audioBlockReady(std::move(block));
+			};
+		}
+		parallelSynth.synthesize([&](VTMControlModel::Controller& c) { configureController(job, c); },
+						*controller, job.phoneticString, job.segmentReuseKey, job.verifyParallel,
+						progress, *audio, *vtmParamList);
+		result.parallel = true;
+		result.parallelStatistics = parallelSynth.statistics();
+		if (!job.vtmParamFilePath.empty()) {
+			VTMParameterFile::writeBinary(job.vtmParamFilePath, controller->vtmControlModelConfiguration().controlRate,
+							VTMParameterFile::parameterNameList(*model), *vtmParamList);
+		}
+		if (job.type == SynthesisJob::Type::phoneticStringToFile) {
+			WAVWriter writer(job.wavFilePath, controller->outputSampleRate());
+			writer.write(audio->data(), audio->size());
+			writer.close();
+			audio->clear();
+		}
+		synthesis_->vtmParamList = std::move(vtmParamList);
+	} else {
+		switch (job.type) {
+		case SynthesisJob::Type::phoneticStringToBuffer:
+			{
+				TraceSpan span("controller", "synthesis");
+				ScopedTimer timer(measureTime ? &timing.controllerTime : nullptr);
+				controller->synthesizePhoneticStringToBuffer(job.phoneticString, nullptr, *audio);
+			}
+			break;
+		case SynthesisJob::Type::phoneticStringToFile:
+			{
+				TraceSpan span("controller", "synthesis");
+				ScopedTimer timer(measureTime ? &timing.controllerTime : nullptr);
+				controller->synthesizePhoneticStringToFile(job.phoneticString, nullptr, job.wavFilePath.c_str());
+			}
+			break;
+		case SynthesisJob::Type::eventListToBuffer:
+		case SynthesisJob::Type::eventListToFile:
+			{
+				auto& eventList = controller->eventList();
+				if (eventList.list().empty()) {
+					THROW_EXCEPTION(InvalidValueException, "The event list is empty.");
+				}
+				{
+					TraceSpan span("event_list_preparation", "synthesis");
+					ScopedTimer timer(measureTime ? &timing.eventListPreparationTime : nullptr);
+					eventList.clearMacroIntonation();
+					eventList.prepareMacroIntonationInterpolation();
+				}
+				TraceSpan span("controller_from_event_list", "synthesis");
+				ScopedTimer timer(measureTime ? &timing.controllerTime : nullptr);
+				if (job.type == SynthesisJob::Type::eventListToBuffer) {
+					controller->synthesizeFromEventListToBuffer(nullptr, *audio);
+				} else {
+					controller->synthesizeFromEventListToFile(nullptr, job.wavFilePath.c_str());
+				}
+			}
+			break;
+		}
+		if (!job.vtmParamFilePath.empty()) {
+			// The controller writes only the text format.
+			VTMParameterFile::writeBinary(job.vtmParamFilePath, controller->vtmControlModelConfiguration().controlRate,
+							VTMParameterFile::parameterNameList(*model), controller->vtmParameterList());
+		}
+		if (!job.reference && !job.speculative) {
+			synthesis_->vtmParamList.reset(); // the parameters of the controller are complete
+		}
+	}
+
+	result.type = job.type;
+	result.reference = job.reference;
+	result.speculative = job.speculative;
+	result.cacheKey = job.cacheKey;
+	if (!job.cacheKey.empty() && job.type == SynthesisJob::Type::phoneticStringToBuffer) {
+		if (parallel) {
+			result.vtmParamList = synthesis_->vtmParamList;
+		} else {
+			result.vtmParamList = std::make_shared<const std::vector<std::vector<float>>>(
+							controller->vtmParameterList());
+		}
+		if (job.reference) {
+			result.controller = result.referenceObjects.controller;
+		} else if (job.speculative) {
+			result.controller = speculativeController_;
+			speculativeControllerShared_ = true;
+			result.modelMemorySize = job.modelSnapshot->size();
+		} else {
+			result.controller = job.controller;
+		}
+	}
+	if (job.type == SynthesisJob::Type::phoneticStringToBuffer ||
+			job.type == SynthesisJob::Type::eventListToBuffer) {
+		result.audio = std::move(audio);
+	}
+	result.outputSampleRate = controller->outputSampleRate();
+	if (measureTime && result.audio) {
+		timing.audioDuration = result.audio->size() / result.outputSampleRate;
+	}
+	result.vtmInternalSampleRate = controller->vtmInternalSampleRate();
+	result.controlRate = controller->vtmControlModelConfiguration().controlRate;
+}
+
+// The copies of the model are updated when the model is modified.
+ParallelSynthesis&
+SynthesisWorker::parallelSynthesis(unsigned int modelRevision)
+{
+	std::unique_ptr<ParallelSynthesis>& parallelSynth = synthesis_->parallelSynthesis;
+	if (!parallelSynth ||
+			parallelSynth->modelRevision() != modelRevision ||
+			parallelSynth->index() != synthesis_->index) {
+		TraceSpan span("parallel_synthesis_setup", "synthesis");
+		parallelSynth.reset();
+		parallelSynth = std::make_unique<ParallelSynthesis>(synthesis_->index, modelSnapshot(modelRevision));
+	}
+	return *parallelSynth;
+}
+
+// The model is not modified while there are jobs in the queue,
+// so the revision of the job identifies its state.
+std::shared_ptr<const ModelSnapshot>
+SynthesisWorker::modelSnapshot(unsigned int modelRevision)
+{
+	std::shared_ptr<const ModelSnapshot>& snapshot = synthesis_->modelSnapshot;
+	if (!snapshot || snapshot->modelRevision() != modelRevision) {
+		TraceSpan span("model_snapshot", "synthesis");
+		snapshot.reset();
+		snapshot = std::make_shared<const ModelSnapshot>(*synthesis_->model, modelRevision);
+	}
+	return snapshot;
+}
+
+// The model is loaded from the snapshot in the thread of the worker, once per
+// model revision. A new controller is created if the current one has been returned in a result.
+// All the speculative controllers of a revision share the model. Only the synthesis
+// of a phonetic string modifies the model (formula symbols), and a controller
+// adopted from the cache is replaced before it synthesizes a phonetic string,
+// so these syntheses are executed only by this worker, one at a time.
+VTMControlModel::Controller&
+SynthesisWorker::speculativeController(const SynthesisJob& job)
+{
+	if (!speculativeModel_ ||
+			speculativeModelRevision_ != job.modelSnapshot->modelRevision() ||
+			speculativeIndex_ != job.index) {
+		speculativeController_.reset();
+		speculativeModel_.reset();
+		speculativeModel_ = job.modelSnapshot->createModel();
+		speculativeIndex_ = job.index;
+		speculativeModelRevision_ = job.modelSnapshot->modelRevision();
+	}
+	if (!speculativeController_ || speculativeControllerShared_) {
+		std::shared_ptr<VTMControlModel::Model> model = speculativeModel_;
+		std::shared_ptr<Index> index = speculativeIndex_;
+		auto controller = std::make_unique<VTMControlModel::Controller>(*index, *model);
+		speculativeController_ = std::shared_ptr<VTMControlModel::Controller>(controller.release(),
+			[index, model](VTMControlModel::Controller* c) { delete c; });
+		speculativeControllerShared_ = false;
+	}
+	return *speculativeController_;
+}
+
+} // namespace GS
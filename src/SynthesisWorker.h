@@ -0,0 +1,222 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef SYNTHESIS_WORKER_H
+#define SYNTHESIS_WORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+
+#include "ParallelSynthesis.h"
+#include "ReferenceModelCache.h"
+#include "Synthesis.h"
+
+
+
+namespace GS {
+
+// Durations in seconds.
+struct SynthesisTiming {
+	double textParserTime;
+	double queueTime;
+	double referenceModelLoadTime;
+	double eventListPreparationTime; // manual intonation
+	double controllerTime;
+	double audioStartTime;           // JACK client startup in AudioPlayer
+	double audioDuration;
+
+	SynthesisTiming()
+		: textParserTime()
+		, queueTime()
+		, referenceModelLoadTime()
+		, eventListPreparationTime()
+		, controllerTime()
+		, audioStartTime()
+		, audioDuration()
+	{
+	}
+};
+
+struct SynthesisJob {
+	enum class Type {
+		phoneticStringToBuffer,
+		phoneticStringToFile,
+		eventListToBuffer,
+		eventListToFile
+	};
+
+	Type type;
+	bool reference;                     // use the reference model (Synthesis::referenceModelCache)
+	std::shared_ptr<const VTMControlModel::Configuration> configuration; // copied from Synthesis (not used if reference == true)
+	FixedIntonationParameters fixedIntonation; // copied from Synthesis (not used if reference == true)
+	unsigned int modelRevision;         // copied from Synthesis
+	double tempo;                       // used only with phonetic strings
+	std::string phoneticString;
+	std::string vtmParamFilePath;       // if empty, the VTM parameters will not be saved
+	std::string wavFilePath;            // used only with the "to file" types
+	std::size_t numberOfParameters;     // used only if reference == true
+	bool keepReferenceController;       // the event list of the reference controller will be kept (used only if reference == true)
+	std::shared_ptr<VTMControlModel::Controller> controller; // copied from Synthesis (not used if reference or speculative == true)
+	std::string cacheKey;               // if empty, the result will not be cached
+	bool parallel;                      // use ParallelSynthesis (only with phonetic strings, if reference == false)
+	bool verifyParallel;                // compare the parallel synthesis with the serial synthesis
+	std::string segmentReuseKey;        // if not empty, ParallelSynthesis reuses the unchanged segments
+	bool speculative;                   // prepares the cache, using a copy of the model (only phoneticStringToBuffer)
+	std::shared_ptr<Index> index;       // used only if speculative == true
+	std::shared_ptr<const ModelSnapshot> modelSnapshot; // used only if speculative == true
+	bool measureTime;
+	double textParserTime;              // s - measured before the submission
+	std::chrono::steady_clock::time_point submitTime; // set by SynthesisWorker::submit() if measureTime == true
+
+	SynthesisJob()
+		: type(Type::phoneticStringToBuffer)
+		, reference()
+		, modelRevision()
+		, tempo(1.0)
+		, numberOfParameters()
+		, keepReferenceController()
+		, parallel()
+		, verifyParallel()
+		, speculative()
+		, measureTime()
+		, textParserTime()
+	{
+	}
+};
+
+struct SynthesisResult {
+	unsigned int jobId;
+	SynthesisJob::Type type;
+	bool reference;
+	ReferenceModelCache::Reference referenceObjects; // valid only if reference == true
+	std::string cacheKey;
+	std::shared_ptr<const std::vector<float>> audio; // null with the "to file" types - shared with the cache and the player
+	std::shared_ptr<const std::vector<std::vector<float>>> vtmParamList; // set only if cacheKey is not empty
+	std::shared_ptr<VTMControlModel::Controller> controller; // its event list was used (may be null)
+							// if speculative == true, it uses a copy of the model
+	std::size_t modelMemorySize; // estimate of the memory used by the copy of the model (bytes)
+	bool measureTime;
+	SynthesisTiming timing; // valid only if measureTime == true
+	bool parallel;
+	ParallelSynthesis::Statistics parallelStatistics; // valid only if parallel == true
+	bool speculative;
+	double cpuTime; // s - measured only if speculative == true
+	double outputSampleRate;
+	double vtmInternalSampleRate;
+	double controlRate;
+};
+
+typedef std::shared_ptr<SynthesisResult> SynthesisResultPtr;
+
+// Audio published during a parallel synthesis, before the end of the job.
+struct SynthesisAudioBlock {
+	unsigned int jobId;
+	std::size_t firstSample;
+	std::size_t expectedSize; // estimate of the final number of samples
+	std::vector<float> samples; // uses a provisional scale
+	double outputSampleRate;
+	double vtmInternalSampleRate;
+	double controlRate;
+};
+
+typedef std::shared_ptr<const SynthesisAudioBlock> SynthesisAudioBlockPtr;
+
+// Executes the synthesis jobs in the thread that owns the object.
+//
+// While a job is in the queue, its controller must not be accessed by
+// other threads. The worker does not modify Synthesis::vtmController,
+// the controller of each job is selected by the GUI thread.
+//
+// The speculative jobs use only the objects in the job and a controller
+// owned by the worker, so they can be executed by another worker, in a
+// thread with a lower priority.
+class SynthesisWorker : public QObject {
+	Q_OBJECT
+public:
+	explicit SynthesisWorker(QObject* parent=nullptr);
+	virtual ~SynthesisWorker() = default;
+
+	// Must be called only when the worker is idle.
+	// Not needed if the worker executes only speculative jobs.
+	void setSynthesis(Synthesis* synthesis) { synthesis_ = synthesis; }
+
+	// These functions are thread-safe.
+	unsigned int submit(const SynthesisJob& job); // returns the job id
+	void cancelAll(); // the pending jobs are dropped and the result of the current job is discarded
+	void waitUntilIdle();
+	unsigned int nextJobId();
+	// CPU time used by the speculative jobs that were cancelled or have failed (s).
+	double discardedSpeculativeCpuTime() const;
+signals:
+	void jobSubmitted();
+	void jobStarted(unsigned int jobId, unsigned int numberOfPendingJobs);
+	void jobFinished(GS::SynthesisResultPtr result);
+	void audioBlockReady(GS::SynthesisAudioBlockPtr block); // may be emitted by other threads
+	void jobFailed(unsigned int jobId, QString msg);
+	void jobCancelled(unsigned int jobId);
+private slots:
+	void processJobs();
+private:
+	struct QueueItem {
+		unsigned int id;
+		unsigned int generation;
+		SynthesisJob job;
+	};
+
+	SynthesisWorker(const SynthesisWorker&) = delete;
+	SynthesisWorker& operator=(const SynthesisWorker&) = delete;
+	SynthesisWorker(SynthesisWorker&&) = delete;
+	SynthesisWorker& operator=(SynthesisWorker&&) = delete;
+
+	bool isCancelled(const QueueItem& item) const;
+	void execute(const SynthesisJob& job, SynthesisResult& result);
+	ParallelSynthesis& parallelSynthesis(unsigned int modelRevision);
+	std::shared_ptr<const ModelSnapshot> modelSnapshot(unsigned int modelRevision);
+	VTMControlModel::Controller& speculativeController(const SynthesisJob& job);
+
+	Synthesis* synthesis_;
+	std::mutex mutex_;
+	std::condition_variable idleCondition_;
+	std::deque<QueueItem> queue_;
+	bool running_;
+	unsigned int nextJobId_;
+	std::atomic<unsigned int> generation_;
+	std::atomic<std::uint64_t> discardedSpeculativeCpuTime_; // ns
+	std::shared_ptr<VTMControlModel::Model> speculativeModel_; // copy of the model, shared by the speculative controllers
+	std::shared_ptr<VTMControlModel::Controller> speculativeController_; // keeps the copy of the model alive
+	bool speculativeControllerShared_; // speculativeController_ has been returned in a result
+	std::shared_ptr<Index> speculativeIndex_;
+	unsigned int speculativeModelRevision_;
+};
+
+} // namespace GS
+
+Q_DECLARE_METATYPE(GS::SynthesisResultPtr)
+Q_DECLARE_METATYPE(GS::SynthesisAudioBlockPtr)
+
+#endif // SYNTHESIS_WORKER_H
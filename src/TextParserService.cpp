@@ -0,0 +1,118 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "TextParserService.h"
+
+#include <iostream>
+#include <system_error>
+
+#include "Controller.h"
+#include "Index.h"
+#include "Log.h"
+#include "TextParser.h"
+
+#define GENERATED_FILE_PREFIX "generated__"
+
+
+
+namespace GS {
+
+TextParserService::TextParserService(const std::string& projectDir)
+		: projectDir_(projectDir)
+		, textParserPhoStrFormat_()
+		, modificationTime_()
+{
+}
+
+TextParserService::~TextParserService()
+{
+}
+
+void
+TextParserService::checkForUpdates()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const std::filesystem::file_time_type modificationTime = lastModificationTime();
+	if (index_ && modificationTime == modificationTime_) {
+		return;
+	}
+	load(modificationTime);
+}
+
+std::shared_ptr<Index>
+TextParserService::index()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!index_) load(lastModificationTime());
+	return index_;
+}
+
+std::string
+TextParserService::parse(const std::string& text, const VTMControlModel::Configuration& config)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!index_) load(lastModificationTime());
+	const int phoStrFormat = static_cast<int>(config.phoStrFormat);
+	if (!textParser_ || phoStrFormat != textParserPhoStrFormat_) {
+		textParser_ = TextParser::TextParser::getInstance(*index_, config.phoStrFormat);
+		textParserPhoStrFormat_ = phoStrFormat;
+	}
+	return textParser_->parse(text.c_str());
+}
+
+// The mutex must be locked.
+void
+TextParserService::load(std::filesystem::file_time_type modificationTime)
+{
+	if (Log::debugEnabled) {
+		std::cout << "[TextParserService] Loading the index from " << projectDir_ << std::endl;
+	}
+
+	// The index is shared, so it is replaced instead of modified.
+	textParser_.reset();
+	index_ = std::make_shared<Index>(projectDir_);
+	modificationTime_ = modificationTime;
+}
+
+// Returns the modification time of the newest file in the project directory.
+// The files generated by the editor are ignored.
+std::filesystem::file_time_type
+TextParserService::lastModificationTime() const
+{
+	namespace fs = std::filesystem;
+
+	fs::file_time_type lastTime{};
+	std::error_code ec;
+	for (fs::recursive_directory_iterator iter(projectDir_, ec), end; !ec && iter != end; iter.increment(ec)) {
+		std::error_code fileEc;
+		if (!iter->is_regular_file(fileEc)) continue;
+		const fs::path& path = iter->path();
+		if (path.filename().string().rfind(GENERATED_FILE_PREFIX, 0) == 0) continue;
+		if (path.extension() == ".wav") continue;
+
+		const fs::file_time_type t = iter->last_write_time(fileEc);
+		if (!fileEc && t > lastTime) {
+			lastTime = t;
+		}
+	}
+	return lastTime;
+}
+
+} // namespace GS
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef TEXT_PARSER_SERVICE_H
+#define TEXT_PARSER_SERVICE_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+
+namespace GS {
+
+class Index;
+namespace TextParser {
+class TextParser;
+}
+namespace VTMControlModel {
+struct Configuration;
+}
+
+// Keeps the index and the text parser of a project loaded.
+//
+// They are reloaded by checkForUpdates() if a file in the project directory
+// has been modified. The index must not be modified.
+// This class is thread-safe.
+class TextParserService {
+public:
+	explicit TextParserService(const std::string& projectDir);
+	~TextParserService();
+
+	const std::string& projectDir() const { return projectDir_; }
+
+	// Scans the project directory. Called when the model or the configuration is reloaded.
+	void checkForUpdates();
+
+	std::shared_ptr<Index> index();
+
+	// The parser is recreated if the phonetic string format
+	// in the configuration has changed.
+	std::string parse(const std::string& text, const VTMControlModel::Configuration& config);
+private:
+	TextParserService(const TextParserService&) = delete;
+	TextParserService& operator=(const TextParserService&) = delete;
+	TextParserService(TextParserService&&) = delete;
+	TextParserService& operator=(TextParserService&&) = delete;
+
+	void load(std::filesystem::file_time_type modificationTime);
+	std::filesystem::file_time_type lastModificationTime() const;
+
+	const std::string projectDir_;
+	std::mutex mutex_;
+	std::shared_ptr<Index> index_;
+	std::shared_ptr<TextParser::TextParser> textParser_;
+	int textParserPhoStrFormat_;
+	std::filesystem::file_time_type modificationTime_;
+};
+
+} // namespace GS
+
+#endif // TEXT_PARSER_SERVICE_H
@@ -0,0 +1,283 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "Trace.h"
+
+#include <condition_variable>
+#include <cstdlib> /* getenv */
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility> /* swap */
+#include <vector>
+
+#include "Exception.h"
+
+#define TRACE_FILE_ENV_VAR "GAMATTS_EDITOR_TRACE_FILE"
+#define EVENT_BUFFER_CAPACITY 16384
+#define FLUSH_INTERVAL_MS 250
+
+
+
+namespace {
+
+struct Event {
+	const char* name;
+	const char* category;
+	std::int64_t startTime; // ns
+	std::int64_t endTime;   // ns
+};
+
+struct ThreadBuffer {
+	std::mutex mutex;
+	std::vector<Event> eventList;
+	std::string threadName;
+	unsigned int threadId;
+	std::atomic<unsigned int> numberOfDroppedEvents;
+	bool threadNameChanged;
+
+	explicit ThreadBuffer(unsigned int id)
+			: threadId(id)
+			, numberOfDroppedEvents()
+			, threadNameChanged()
+	{
+		eventList.reserve(EVENT_BUFFER_CAPACITY);
+	}
+};
+
+std::mutex bufferListMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> bufferList; // the buffers are never removed
+thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+std::mutex controlMutex; // serializes start() and stop()
+std::mutex flushMutex;
+std::condition_variable flushCondition;
+bool stopFlushThread;
+std::thread flushThread;
+std::ofstream traceFile;
+bool firstTraceEvent;
+
+ThreadBuffer&
+currentThreadBuffer()
+{
+	if (!threadBuffer) {
+		std::lock_guard<std::mutex> lock(bufferListMutex);
+		threadBuffer = std::make_shared<ThreadBuffer>(bufferList.size() + 1U);
+		bufferList.push_back(threadBuffer);
+	}
+	return *threadBuffer;
+}
+
+void
+writeString(std::ostream& out, const std::string& s)
+{
+	out << '"';
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			out << '\\' << c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			out << ' ';
+		} else {
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+void
+beginTraceEvent(std::ostream& out)
+{
+	if (firstTraceEvent) {
+		firstTraceEvent = false;
+	} else {
+		out << ",\n";
+	}
+}
+
+// Called only by the flush thread (or by stop() after the thread has finished).
+void
+flushBuffers()
+{
+	std::vector<std::shared_ptr<ThreadBuffer>> list;
+	{
+		std::lock_guard<std::mutex> lock(bufferListMutex);
+		list = bufferList;
+	}
+
+	std::vector<Event> eventList;
+	for (auto& buffer : list) {
+		// Allocate outside the lock.
+		std::vector<Event> newEventList;
+		newEventList.reserve(EVENT_BUFFER_CAPACITY);
+
+		std::string threadName;
+		bool threadNameChanged;
+		unsigned int numberOfDroppedEvents;
+		{
+			std::lock_guard<std::mutex> lock(buffer->mutex);
+			std::swap(buffer->eventList, newEventList);
+			threadNameChanged = buffer->threadNameChanged;
+			buffer->threadNameChanged = false;
+			if (threadNameChanged) threadName = buffer->threadName;
+			numberOfDroppedEvents = buffer->numberOfDroppedEvents.exchange(0);
+		}
+		eventList = std::move(newEventList);
+
+		if (threadNameChanged) {
+			beginTraceEvent(traceFile);
+			traceFile << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->threadId
+				<< R"(,"args":{"name":)";
+			writeString(traceFile, threadName);
+			traceFile << "}}";
+		}
+		for (const Event& e : eventList) {
+			beginTraceEvent(traceFile);
+			traceFile << R"({"name":")" << e.name
+				<< R"(","cat":")" << e.category
+				<< R"(","ph":"X","ts":)" << e.startTime * 1.0e-3
+				<< R"(,"dur":)" << (e.endTime - e.startTime) * 1.0e-3
+				<< R"(,"pid":1,"tid":)" << buffer->threadId << '}';
+		}
+		if (numberOfDroppedEvents > 0 && !eventList.empty()) {
+			beginTraceEvent(traceFile);
+			traceFile << R"({"name":"dropped_events","ph":"i","s":"t","ts":)" << eventList.back().endTime * 1.0e-3
+				<< R"(,"pid":1,"tid":)" << buffer->threadId
+				<< R"(,"args":{"count":)" << numberOfDroppedEvents << "}}";
+		}
+	}
+	traceFile.flush();
+}
+
+} // namespace
+
+namespace GS {
+
+std::atomic_bool Trace::enabled_{false};
+std::atomic<std::int64_t> Trace::startTime_{0};
+
+void
+Trace::startFromEnvironment()
+{
+	const char* filePath = std::getenv(TRACE_FILE_ENV_VAR);
+	if (filePath && *filePath) {
+		start(filePath);
+	}
+}
+
+void
+Trace::start(const char* filePath)
+{
+	std::lock_guard<std::mutex> controlLock(controlMutex);
+	if (enabled_) {
+		THROW_EXCEPTION(TraceException, "The trace has already been started.");
+	}
+
+	traceFile.open(filePath, std::ios_base::out | std::ios_base::binary);
+	if (!traceFile) {
+		THROW_EXCEPTION(TraceException, "Could not create the file " << filePath << '.');
+	}
+	traceFile << std::fixed << std::setprecision(3);
+	traceFile << "{\"traceEvents\":[\n";
+	firstTraceEvent = true;
+
+	// Discard the events of a previous recording.
+	{
+		std::lock_guard<std::mutex> lock(bufferListMutex);
+		for (auto& buffer : bufferList) {
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			buffer->eventList.clear();
+			buffer->numberOfDroppedEvents = 0;
+			buffer->threadNameChanged = !buffer->threadName.empty();
+		}
+	}
+
+	startTime_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		stopFlushThread = false;
+	}
+	flushThread = std::thread(&Trace::flushThreadFunc);
+	enabled_ = true;
+}
+
+void
+Trace::stop()
+{
+	std::lock_guard<std::mutex> controlLock(controlMutex);
+	if (!enabled_) return;
+	enabled_ = false;
+
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		stopFlushThread = true;
+	}
+	flushCondition.notify_one();
+	flushThread.join();
+
+	flushBuffers();
+	traceFile << "\n]}\n";
+	traceFile.close();
+}
+
+void
+Trace::addEvent(const char* name, const char* category, std::int64_t startTime, std::int64_t endTime)
+{
+	if (!enabled()) return;
+
+	ThreadBuffer& buffer = currentThreadBuffer();
+	std::unique_lock<std::mutex> lock(buffer.mutex, std::try_to_lock);
+	if (!lock.owns_lock()) {
+		// The buffer is being flushed.
+		++buffer.numberOfDroppedEvents;
+		return;
+	}
+	if (buffer.eventList.size() == buffer.eventList.capacity()) {
+		++buffer.numberOfDroppedEvents;
+		return;
+	}
+	buffer.eventList.push_back(Event{name, category, startTime, endTime});
+}
+
+void
+Trace::setThreadName(const char* name)
+{
+	ThreadBuffer& buffer = currentThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	if (buffer.threadName == name) return;
+	buffer.threadName = name;
+	buffer.threadNameChanged = true;
+}
+
+void
+Trace::flushThreadFunc()
+{
+	std::unique_lock<std::mutex> lock(flushMutex);
+	while (!stopFlushThread) {
+		flushCondition.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+		if (stopFlushThread) break;
+		lock.unlock();
+		flushBuffers();
+		lock.lock();
+	}
+}
+
+} // namespace GS
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+
+
+namespace GS {
+
+struct TraceException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Records spans in the Chrome trace event format (can be opened in
+// chrome://tracing or https://ui.perfetto.dev).
+//
+// Each thread stores its events in its own buffer. A background thread
+// moves the events to the file periodically. The names and categories
+// must be string literals (only the pointers are stored).
+//
+// In the realtime threads, recording an event does not allocate memory
+// or wait for locks (the events are dropped if the buffer is full or busy).
+// The only exception is the first event of each thread, which allocates
+// the buffer.
+class Trace {
+public:
+	// Starts the recording, if the environment variable GAMATTS_EDITOR_TRACE_FILE is set.
+	static void startFromEnvironment();
+	static void start(const char* filePath);
+	// Writes the remaining events and closes the file.
+	static void stop();
+
+	static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+	// Time since the start of the recording, in nanoseconds.
+	static std::int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count()
+				- startTime_.load(std::memory_order_relaxed);
+	}
+	static void addEvent(const char* name, const char* category, std::int64_t startTime, std::int64_t endTime);
+	// Sets the name of the current thread in the trace.
+	static void setThreadName(const char* name);
+private:
+	Trace() = delete;
+	~Trace() = delete;
+	Trace(const Trace&) = delete;
+	Trace& operator=(const Trace&) = delete;
+	Trace(Trace&&) = delete;
+	Trace& operator=(Trace&&) = delete;
+
+	static void flushThreadFunc();
+
+	static std::atomic_bool enabled_;
+	static std::atomic<std::int64_t> startTime_;
+};
+
+// Records the lifetime of the object as a span.
+// Does nothing if the recording has not been started.
+class TraceSpan {
+public:
+	explicit TraceSpan(const char* name, const char* category="editor")
+			: name_(name)
+			, category_(category)
+			, startTime_(Trace::enabled() ? Trace::now() : -1)
+	{
+	}
+
+	~TraceSpan()
+	{
+		if (startTime_ >= 0) {
+			Trace::addEvent(name_, category_, startTime_, Trace::now());
+		}
+	}
+private:
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+	TraceSpan(TraceSpan&&) = delete;
+	TraceSpan& operator=(TraceSpan&&) = delete;
+
+	const char* name_;
+	const char* category_;
+	std::int64_t startTime_;
+};
+
+} // namespace GS
+
+#endif // TRACE_H
@@ -23,13 +23,14 @@
 #include "TransitionWidget.h"
 
 #include <array>
-#include <cmath> /* fabs */
 
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPointF>
 #include <QRectF>
 
+#include "Trace.h"
+
 #define MARGIN                       (20.0)
 #define MARKER_SIZE                  (3.5)
 #define TEXT_MARGIN                  (10.0)
@@ -97,11 +98,18 @@ TransitionWidget::TransitionWidget(QWidget* parent)
 		, mark2_()
 		, mark3_()
 		, selectedPointIndex_(-1)
+		, hoveredPointIndex_(-1)
+		, pointIndexValid_()
+		, pointIndexLeftMargin_()
+		, pointIndexYStep_()
+		, pointIndexGraphWidth_()
 {
 	QPalette pal;
 	pal.setColor(QPalette::Window, Qt::white);
 	setPalette(pal);
 	setAutoFillBackground(true);
+
+	setMouseTracking(true);
 }
 
 void
@@ -114,6 +122,8 @@ TransitionWidget::clear()
 	mark3_ = 0.0;
 	ruleDuration_ = 0.0;
 	selectedPointIndex_ = -1;
+	hoveredPointIndex_ = -1;
+	pointIndexValid_ = false;
 
 	update();
 }
@@ -134,6 +144,8 @@ TransitionWidget::updateData(VTMControlModel::Transition::Type transitionType,
 	mark3_          = mark3;
 
 	dataUpdated_ = true;
+	pointIndexValid_ = false;
+	hoveredPointIndex_ = -1;
 	update();
 }
 
@@ -148,6 +160,8 @@ TransitionWidget::setSelectedPointIndex(int index)
 void
 TransitionWidget::paintEvent(QPaintEvent*)
 {
+	TraceSpan span("TransitionWidget::paintEvent", "paint");
+
 	if (pointList_ == nullptr) {
 		return;
 	}
@@ -313,20 +327,23 @@ TransitionWidget::paintEvent(QPaintEvent*)
 			}
 		}
 
-		// Selected point.
-		if (selectedPointIndex_ >= 0 && static_cast<std::size_t>(selectedPointIndex_) < pointList_->size()) {
+		// Selected point and point under the mouse cursor.
+		if ((selectedPointIndex_ >= 0 && static_cast<std::size_t>(selectedPointIndex_) < pointList_->size()) ||
+				hoveredPointIndex_ >= 0) {
 			int i = 0;
 			for (const auto& point : *pointList_) {
 				if (static_cast<int>(point.type) > static_cast<int>(transitionType_)) continue;
-				if (i == selectedPointIndex_) {
+				if (i == selectedPointIndex_ || i == hoveredPointIndex_) {
 					double px = timeToX(point.time);
 					double py = valueToY(point.value);
+					painter.setPen(i == selectedPointIndex_ ? Qt::black : Qt::gray);
 					painter.drawRect(QRectF(
 						 QPointF(px - SELECTION_SIZE, py - SELECTION_SIZE),
 						 QPointF(px + SELECTION_SIZE, py + SELECTION_SIZE)));
 				}
 				++i;
 			}
+			painter.setPen(pen);
 		}
 	}
 }
@@ -393,26 +410,62 @@ TransitionWidget::mousePressEvent(QMouseEvent* event)
 
 	qDebug("TransitionWidget::mousePressEvent");
 
-	unsigned int i = 0;
-	for (const auto& point : *pointList_) {
-		if (static_cast<int>(point.type) > static_cast<int>(transitionType_)) continue;
+#ifdef USING_QT6
+	QPointF pos = event->position();
+#else
+	QPointF pos = event->localPos();
+#endif
+	updatePointIndex();
+	const int pointIndex = pointIndex_.firstInRange(pos.x(), pos.y(), POINT_SELECTION_MAX_DISTANCE);
+	if (pointIndex >= 0) {
+		emit pointSelected(pointIndex);
+	}
+}
+
+void
+TransitionWidget::mouseMoveEvent(QMouseEvent* event)
+{
+	if (pointList_ == nullptr) return;
 
-		const double x = timeToX(point.time);
-		const double y = valueToY(point.value);
 #ifdef USING_QT6
-		const double absDx = std::fabs(x - event->position().x());
-		const double absDy = std::fabs(y - event->position().y());
+	QPointF pos = event->position();
 #else
-		const double absDx = std::fabs(x - event->x());
-		const double absDy = std::fabs(y - event->y());
+	QPointF pos = event->localPos();
 #endif
-		if (absDx <= POINT_SELECTION_MAX_DISTANCE && absDy <= POINT_SELECTION_MAX_DISTANCE) {
-			emit pointSelected(i);
-			break;
-		}
+	updatePointIndex();
+	const int pointIndex = pointIndex_.firstInRange(pos.x(), pos.y(), POINT_SELECTION_MAX_DISTANCE);
+	if (pointIndex != hoveredPointIndex_) {
+		hoveredPointIndex_ = pointIndex;
+		setCursor(pointIndex >= 0 ? Qt::PointingHandCursor : Qt::ArrowCursor);
+		update();
+	}
+}
+
+// Rebuilds the index if the points or the scales have changed.
+// The id of each point is its index among the points that are visible
+// for the transition type.
+void
+TransitionWidget::updatePointIndex()
+{
+	if (pointIndexValid_ && leftMargin_ == pointIndexLeftMargin_ &&
+			yStep_ == pointIndexYStep_ && graphWidth_ == pointIndexGraphWidth_) {
+		return;
+	}
 
-		++i;
+	pointIndex_.clear();
+	if (pointList_) {
+		int i = 0;
+		for (const auto& point : *pointList_) {
+			if (static_cast<int>(point.type) > static_cast<int>(transitionType_)) continue;
+			pointIndex_.add(timeToX(point.time), valueToY(point.value), i++);
+		}
 	}
+	pointIndex_.sort();
+
+	pointIndexValid_ = true;
+	pointIndexLeftMargin_ = leftMargin_;
+	pointIndexYStep_ = yStep_;
+	pointIndexGraphWidth_ = graphWidth_;
 }
 
 void
@@ -22,6 +22,7 @@
 
 #include <QWidget>
 
+#include "PointIndex.h"
 #include "Transition.h"
 #include "TransitionPoint.h"
 
@@ -53,6 +54,7 @@ protected:
 	virtual void resizeEvent(QResizeEvent* event);
 	virtual void mouseDoubleClickEvent(QMouseEvent* event);
 	virtual void mousePressEvent(QMouseEvent* event);
+	virtual void mouseMoveEvent(QMouseEvent* event);
 private:
 	TransitionWidget(const TransitionWidget&) = delete;
 	TransitionWidget& operator=(const TransitionWidget&) = delete;
@@ -60,6 +62,7 @@ private:
 	TransitionWidget& operator=(TransitionWidget&&) = delete;
 
 	void updateScales();
+	void updatePointIndex();
 	double valueToY(double value);
 	double timeToX(double time);
 	double yToValue(double y);
@@ -82,6 +85,12 @@ private:
 	float mark2_;
 	float mark3_;
 	int selectedPointIndex_;
+	int hoveredPointIndex_;
+	PointIndex pointIndex_; // positions of the visible points in widget coordinates
+	bool pointIndexValid_;
+	double pointIndexLeftMargin_;
+	double pointIndexYStep_;
+	double pointIndexGraphWidth_;
 };
 
 } // namespace GS
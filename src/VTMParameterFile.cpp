@@ -0,0 +1,218 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "VTMParameterFile.h"
+
+#include <cstdint>
+#include <cstring> /* memcmp, memcpy */
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h> /* open */
+#include <sys/mman.h> /* mmap, munmap, madvise */
+#include <sys/stat.h> /* fstat */
+#include <unistd.h> /* close */
+
+#include "Model.h"
+
+#define BINARY_MAGIC "GSVTMPAR"
+#define BINARY_MAGIC_SIZE 8
+#define BINARY_BYTE_ORDER_MARK 0x01020304U
+#define BINARY_VERSION 1U
+#define BINARY_DATA_ALIGNMENT 16U
+#define BINARY_WRITE_BUFFER_SIZE (1024 * 1024)
+
+
+
+namespace {
+
+template<typename T>
+void
+writeValue(std::ostream& out, T value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Returns false if there are not enough data.
+template<typename T>
+bool
+readValue(const char*& p, const char* end, T& value)
+{
+	if (static_cast<std::size_t>(end - p) < sizeof(T)) return false;
+	std::memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+	return true;
+}
+
+} // namespace
+
+namespace GS {
+
+void
+VTMParameterFile::writeBinary(const std::string& filePath, double controlRate,
+				const std::vector<std::string>& paramNameList,
+				const std::vector<std::vector<float>>& paramList)
+{
+	const std::size_t numParam = paramNameList.size();
+	for (const auto& frame : paramList) {
+		if (frame.size() != numParam) {
+			THROW_EXCEPTION(VTMParameterFileException, "Invalid number of parameters in a frame: "
+						<< frame.size() << " (expected: " << numParam << ").");
+		}
+	}
+
+	std::uint64_t headerSize = BINARY_MAGIC_SIZE + 4 + 4 + 8 + 8 + 4 + 4 + 8;
+	for (const auto& name : paramNameList) {
+		headerSize += 4 + name.size();
+	}
+	const std::uint64_t dataOffset = (headerSize + BINARY_DATA_ALIGNMENT - 1U) / BINARY_DATA_ALIGNMENT * BINARY_DATA_ALIGNMENT;
+
+	std::vector<char> buffer(BINARY_WRITE_BUFFER_SIZE);
+	std::ofstream out;
+	out.rdbuf()->pubsetbuf(buffer.data(), buffer.size()); // must be called before open()
+	out.open(filePath, std::ios_base::binary);
+	if (!out) {
+		THROW_EXCEPTION(VTMParameterFileException, "Could not open the file " << filePath << '.');
+	}
+
+	out.write(BINARY_MAGIC, BINARY_MAGIC_SIZE);
+	writeValue<std::uint32_t>(out, BINARY_BYTE_ORDER_MARK);
+	writeValue<std::uint32_t>(out, BINARY_VERSION);
+	writeValue<std::uint64_t>(out, dataOffset);
+	writeValue<double>(out, controlRate);
+	writeValue<std::uint32_t>(out, numParam);
+	writeValue<std::uint32_t>(out, 0);
+	writeValue<std::uint64_t>(out, paramList.size());
+	for (const auto& name : paramNameList) {
+		writeValue<std::uint32_t>(out, name.size());
+		out.write(name.data(), name.size());
+	}
+	for (std::uint64_t i = headerSize; i < dataOffset; ++i) {
+		out.put('\0');
+	}
+	for (const auto& frame : paramList) {
+		out.write(reinterpret_cast<const char*>(frame.data()), numParam * sizeof(float));
+	}
+
+	out.close();
+	if (!out) {
+		THROW_EXCEPTION(VTMParameterFileException, "Could not write to the file " << filePath << '.');
+	}
+}
+
+std::vector<std::string>
+VTMParameterFile::parameterNameList(const VTMControlModel::Model& model)
+{
+	std::vector<std::string> nameList;
+	for (const auto& param : model.parameterList()) {
+		nameList.push_back(param.name());
+	}
+	return nameList;
+}
+
+MappedVTMParameterFile::MappedVTMParameterFile(const std::string& filePath)
+		: data_(MAP_FAILED)
+		, size_()
+		, controlRate_()
+		, numberOfFrames_()
+		, frameData_()
+{
+	const int fd = open(filePath.c_str(), O_RDONLY);
+	if (fd == -1) {
+		THROW_EXCEPTION(VTMParameterFileException, "Could not open the file " << filePath << '.');
+	}
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size <= 0) {
+		close(fd);
+		THROW_EXCEPTION(VTMParameterFileException, "Invalid file: " << filePath << '.');
+	}
+	size_ = st.st_size;
+	data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping remains valid
+	if (data_ == MAP_FAILED) {
+		THROW_EXCEPTION(VTMParameterFileException, "Could not map the file " << filePath << '.');
+	}
+	madvise(data_, size_, MADV_SEQUENTIAL);
+
+	try {
+		parseHeader(filePath);
+	} catch (...) {
+		munmap(data_, size_);
+		throw;
+	}
+}
+
+MappedVTMParameterFile::~MappedVTMParameterFile()
+{
+	munmap(data_, size_);
+}
+
+void
+MappedVTMParameterFile::parseHeader(const std::string& filePath)
+{
+	const char* begin = static_cast<const char*>(data_);
+	const char* end = begin + size_;
+	const char* p = begin;
+
+	if (size_ < BINARY_MAGIC_SIZE || std::memcmp(p, BINARY_MAGIC, BINARY_MAGIC_SIZE) != 0) {
+		THROW_EXCEPTION(VTMParameterFileException, "The file " << filePath << " is not a binary VTM parameter file.");
+	}
+	p += BINARY_MAGIC_SIZE;
+
+	std::uint32_t byteOrderMark, version, numParam, reserved;
+	std::uint64_t dataOffset, numFrames;
+	if (!readValue(p, end, byteOrderMark) || !readValue(p, end, version)) {
+		THROW_EXCEPTION(VTMParameterFileException, "Truncated header in the file " << filePath << '.');
+	}
+	if (byteOrderMark != BINARY_BYTE_ORDER_MARK) {
+		THROW_EXCEPTION(VTMParameterFileException, "Unsupported byte order in the file " << filePath << '.');
+	}
+	if (version != BINARY_VERSION) {
+		THROW_EXCEPTION(VTMParameterFileException, "Unsupported version (" << version << ") of the file " << filePath << '.');
+	}
+	if (!readValue(p, end, dataOffset) || !readValue(p, end, controlRate_) ||
+			!readValue(p, end, numParam) || !readValue(p, end, reserved) ||
+			!readValue(p, end, numFrames)) {
+		THROW_EXCEPTION(VTMParameterFileException, "Truncated header in the file " << filePath << '.');
+	}
+	// Each name has at least its size field.
+	if (numParam > static_cast<std::size_t>(end - p) / sizeof(std::uint32_t)) {
+		THROW_EXCEPTION(VTMParameterFileException, "Invalid number of parameters in the file " << filePath << '.');
+	}
+	paramNameList_.resize(numParam);
+	for (auto& name : paramNameList_) {
+		std::uint32_t nameSize;
+		if (!readValue(p, end, nameSize) || static_cast<std::size_t>(end - p) < nameSize) {
+			THROW_EXCEPTION(VTMParameterFileException, "Truncated header in the file " << filePath << '.');
+		}
+		name.assign(p, nameSize);
+		p += nameSize;
+	}
+
+	if (dataOffset < static_cast<std::uint64_t>(p - begin) || dataOffset % BINARY_DATA_ALIGNMENT != 0 ||
+			dataOffset > size_) {
+		THROW_EXCEPTION(VTMParameterFileException, "Invalid data offset in the file " << filePath << '.');
+	}
+	const std::uint64_t available = (size_ - dataOffset) / sizeof(float);
+	if (numParam > 0 && numFrames > available / numParam) {
+		THROW_EXCEPTION(VTMParameterFileException, "Truncated data in the file " << filePath << '.');
+	}
+	numberOfFrames_ = numFrames;
+	frameData_ = reinterpret_cast<const float*>(begin + dataOffset);
+}
+
+} // namespace GS
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef VTM_PARAMETER_FILE_H
+#define VTM_PARAMETER_FILE_H
+
+#include <cstddef> /* std::size_t */
+#include <string>
+#include <vector>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+namespace VTMControlModel {
+class Model;
+}
+
+struct VTMParameterFileException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Binary format (native byte order):
+//   char[8]  magic: "GSVTMPAR"
+//   uint32   byte order mark: 0x01020304
+//   uint32   version: 1
+//   uint64   offset of the frames (bytes, multiple of 16)
+//   float64  control rate (Hz)
+//   uint32   number of parameters
+//   uint32   reserved: 0
+//   uint64   number of frames
+//   for each parameter:
+//     uint32 size of the name (bytes)
+//     char[] name
+//   padding (zeros)
+//   float32[number of frames][number of parameters]
+class VTMParameterFile {
+public:
+	// All the frames must have one value per parameter.
+	static void writeBinary(const std::string& filePath, double controlRate,
+				const std::vector<std::string>& paramNameList,
+				const std::vector<std::vector<float>>& paramList);
+	static std::vector<std::string> parameterNameList(const VTMControlModel::Model& model);
+private:
+	VTMParameterFile() = delete;
+	~VTMParameterFile() = delete;
+	VTMParameterFile(const VTMParameterFile&) = delete;
+	VTMParameterFile& operator=(const VTMParameterFile&) = delete;
+	VTMParameterFile(VTMParameterFile&&) = delete;
+	VTMParameterFile& operator=(VTMParameterFile&&) = delete;
+};
+
+// Read-only memory mapping of a binary VTM parameter file.
+// Only the header is parsed.
+class MappedVTMParameterFile {
+public:
+	explicit MappedVTMParameterFile(const std::string& filePath);
+	~MappedVTMParameterFile();
+
+	double controlRate() const { return controlRate_; }
+	const std::vector<std::string>& parameterNameList() const { return paramNameList_; }
+	std::size_t numberOfParameters() const { return paramNameList_.size(); }
+	std::size_t numberOfFrames() const { return numberOfFrames_; }
+	// Points to numberOfParameters() values.
+	const float* frame(std::size_t index) const { return frameData_ + index * paramNameList_.size(); }
+private:
+	MappedVTMParameterFile(const MappedVTMParameterFile&) = delete;
+	MappedVTMParameterFile& operator=(const MappedVTMParameterFile&) = delete;
+	MappedVTMParameterFile(MappedVTMParameterFile&&) = delete;
+	MappedVTMParameterFile& operator=(MappedVTMParameterFile&&) = delete;
+
+	void parseHeader(const std::string& filePath);
+
+	void* data_;
+	std::size_t size_;
+	double controlRate_;
+	std::vector<std::string> paramNameList_;
+	std::size_t numberOfFrames_;
+	const float* frameData_;
+};
+
+} // namespace GS
+
+#endif // VTM_PARAMETER_FILE_H
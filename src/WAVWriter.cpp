@@ -0,0 +1,139 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "WAVWriter.h"
+
+#include <cmath> /* rint */
+#include <limits>
+#include <vector>
+
+
+
+namespace GS {
+
+WAVWriter::WAVWriter(const std::string& filePath, double sampleRate)
+		: filePath_(filePath)
+		, out_(filePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc)
+		, sampleRate_(static_cast<std::uint32_t>(std::rint(sampleRate)))
+		, numSamples_()
+{
+	if (!out_) {
+		THROW_EXCEPTION(WAVWriterException, "Could not open the file " << filePath_ << '.');
+	}
+	writeHeader(); // the sizes will be filled by close()
+}
+
+WAVWriter::~WAVWriter()
+{
+	try {
+		close();
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+void
+WAVWriter::write(const float* samples, std::size_t n)
+{
+	if (!out_.is_open()) {
+		THROW_EXCEPTION(WAVWriterException, "The file " << filePath_ << " is closed.");
+	}
+	if ((numSamples_ + n) * sizeof(std::int16_t) > std::numeric_limits<std::uint32_t>::max() - HEADER_SIZE) {
+		THROW_EXCEPTION(WAVWriterException, "Too many samples for a WAVE file.");
+	}
+
+	std::vector<char> block(n * sizeof(std::int16_t));
+	for (std::size_t i = 0; i < n; ++i) {
+		float s = samples[i];
+		if (s > 1.0f) {
+			s = 1.0f;
+		} else if (s < -1.0f) {
+			s = -1.0f;
+		}
+		const auto value = static_cast<std::uint16_t>(static_cast<std::int16_t>(std::rint(s * 32767.0f)));
+		block[2 * i    ] = static_cast<char>(value & 0xFF);
+		block[2 * i + 1] = static_cast<char>(value >> 8);
+	}
+	out_.write(block.data(), block.size());
+	if (!out_) {
+		THROW_EXCEPTION(WAVWriterException, "Could not write to the file " << filePath_ << '.');
+	}
+	numSamples_ += n;
+}
+
+void
+WAVWriter::close()
+{
+	if (!out_.is_open()) return;
+
+	out_.seekp(0);
+	writeHeader();
+	out_.close();
+	if (!out_) {
+		THROW_EXCEPTION(WAVWriterException, "Could not write to the file " << filePath_ << '.');
+	}
+}
+
+void
+WAVWriter::writeHeader()
+{
+	const std::uint32_t dataSize = numSamples_ * sizeof(std::int16_t);
+
+	out_.write("RIFF", 4);
+	writeUInt32(HEADER_SIZE - 8 + dataSize);
+	out_.write("WAVE", 4);
+
+	out_.write("fmt ", 4);
+	writeUInt32(16);                         // chunk size
+	writeUInt16(1);                          // PCM
+	writeUInt16(1);                          // number of channels
+	writeUInt32(sampleRate_);
+	writeUInt32(sampleRate_ * sizeof(std::int16_t)); // bytes per second
+	writeUInt16(sizeof(std::int16_t));       // block align
+	writeUInt16(16);                         // bits per sample
+
+	out_.write("data", 4);
+	writeUInt32(dataSize);
+
+	if (!out_) {
+		THROW_EXCEPTION(WAVWriterException, "Could not write the header to the file " << filePath_ << '.');
+	}
+}
+
+void
+WAVWriter::writeUInt16(std::uint16_t value)
+{
+	const char b[2] = {
+		static_cast<char>(value & 0xFF),
+		static_cast<char>(value >> 8)
+	};
+	out_.write(b, 2);
+}
+
+void
+WAVWriter::writeUInt32(std::uint32_t value)
+{
+	const char b[4] = {
+		static_cast<char>( value        & 0xFF),
+		static_cast<char>((value >>  8) & 0xFF),
+		static_cast<char>((value >> 16) & 0xFF),
+		static_cast<char>( value >> 24)
+	};
+	out_.write(b, 4);
+}
+
+} // namespace GS
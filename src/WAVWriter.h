@@ -0,0 +1,72 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef WAV_WRITER_H
+#define WAV_WRITER_H
+
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+struct WAVWriterException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Writes a mono 16-bit PCM WAVE file.
+// The samples are written as they arrive, so the whole signal does not need
+// to be in memory. The header is completed by close().
+class WAVWriter {
+public:
+	WAVWriter(const std::string& filePath, double sampleRate);
+	~WAVWriter();
+
+	// The samples must be in the range [-1.0, 1.0]. Values outside
+	// this range are clipped.
+	void write(const float* samples, std::size_t n);
+	void close();
+
+	std::size_t numberOfSamples() const { return numSamples_; }
+private:
+	enum {
+		HEADER_SIZE = 44
+	};
+
+	WAVWriter(const WAVWriter&) = delete;
+	WAVWriter& operator=(const WAVWriter&) = delete;
+	WAVWriter(WAVWriter&&) = delete;
+	WAVWriter& operator=(WAVWriter&&) = delete;
+
+	void writeHeader();
+	void writeUInt16(std::uint16_t value);
+	void writeUInt32(std::uint32_t value);
+
+	std::string filePath_;
+	std::ofstream out_;
+	std::uint32_t sampleRate_;
+	std::size_t numSamples_;
+};
+
+} // namespace GS
+
+#endif // WAV_WRITER_H
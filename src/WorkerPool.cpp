@@ -0,0 +1,39 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "WorkerPool.h"
+
+
+
+namespace GS {
+
+WorkerPool::WorkerPool(unsigned int numberOfWorkers)
+		: numWorkers_(effectiveNumberOfWorkers(numberOfWorkers))
+{
+}
+
+unsigned int
+WorkerPool::effectiveNumberOfWorkers(unsigned int numberOfWorkers)
+{
+	if (numberOfWorkers == 0) {
+		numberOfWorkers = std::thread::hardware_concurrency();
+		if (numberOfWorkers == 0) numberOfWorkers = 1;
+	}
+	return numberOfWorkers;
+}
+
+} // namespace GS
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <cstddef> /* std::size_t */
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace GS {
+
+// Runs a loop on a bounded number of threads.
+// The threads are created in each call to run().
+class WorkerPool {
+public:
+	// If numberOfWorkers is 0, the number of hardware threads is used.
+	explicit WorkerPool(unsigned int numberOfWorkers=0);
+	~WorkerPool() = default;
+
+	unsigned int numberOfWorkers() const { return numWorkers_; }
+	// Returns the number of workers that a pool created with numberOfWorkers would have.
+	static unsigned int effectiveNumberOfWorkers(unsigned int numberOfWorkers);
+
+	// Calls f(workerIndex, itemIndex) for itemIndex = 0, 1, ..., numberOfItems - 1.
+	// workerIndex is in [0, numberOfWorkers()) and may be used to access
+	// per-worker data. Blocks until all the calls have returned.
+	// If f throws, the remaining items are skipped and the first exception is rethrown.
+	template<typename F> void run(std::size_t numberOfItems, F f);
+private:
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+	WorkerPool(WorkerPool&&) = delete;
+	WorkerPool& operator=(WorkerPool&&) = delete;
+
+	unsigned int numWorkers_;
+};
+
+template<typename F>
+void
+WorkerPool::run(std::size_t numberOfItems, F f)
+{
+	if (numberOfItems == 0) return;
+
+	std::atomic<std::size_t> nextItem{0};
+	std::atomic_bool failed{false};
+	std::exception_ptr exc;
+	std::mutex excMutex;
+
+	auto work = [&](unsigned int workerIndex) {
+		while (!failed.load(std::memory_order_relaxed)) {
+			const std::size_t item = nextItem.fetch_add(1, std::memory_order_relaxed);
+			if (item >= numberOfItems) break;
+			try {
+				f(workerIndex, item);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(excMutex);
+				if (!exc) exc = std::current_exception();
+				failed = true;
+			}
+		}
+	};
+
+	const unsigned int n = numberOfItems < numWorkers_ ? static_cast<unsigned int>(numberOfItems) : numWorkers_;
+	std::vector<std::thread> threads;
+	threads.reserve(n - 1U);
+	for (unsigned int i = 1; i < n; ++i) {
+		threads.emplace_back(work, i);
+	}
+	work(0); // the calling thread is the worker 0
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	if (exc) std::rethrow_exception(exc);
+}
+
+} // namespace GS
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,238 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "BatchSynthesis.h"
+
+#include <chrono>
+#include <cstdio> /* snprintf */
+#include <exception>
+#include <fstream>
+#include <utility> /* move */
+
+#include <unistd.h> /* sysconf */
+
+#include "AppConfig.h"
+#include "Controller.h"
+#include "Index.h"
+#include "Model.h"
+#include "StreamingSynthesis.h"
+#include "Synthesis.h"
+#include "TextParserService.h"
+#include "WAVWriter.h"
+#include "WorkerPool.h"
+
+
+
+namespace GS {
+
+struct BatchSynthesis::Worker {
+	AppConfig appConfig;
+	std::unique_ptr<VTMControlModel::Model> model;
+	std::unique_ptr<Synthesis> synthesis; // references appConfig
+	std::vector<float> buffer;
+};
+
+BatchSynthesis::BatchSynthesis(const std::string& projectDir, const Configuration& config)
+		: projectDir_(projectDir)
+		, config_(config)
+{
+	Index index{projectDir_};
+	modelFilePath_ = index.entry("artic_file");
+
+	workerList_.resize(WorkerPool::effectiveNumberOfWorkers(config_.numberOfWorkers));
+}
+
+BatchSynthesis::~BatchSynthesis()
+{
+}
+
+unsigned int
+BatchSynthesis::numberOfWorkers() const
+{
+	return workerList_.size();
+}
+
+double
+BatchSynthesis::run(const std::vector<std::string>& utteranceList, std::vector<Result>& resultList)
+{
+	resultList.assign(utteranceList.size(), Result());
+
+	const auto t0 = std::chrono::steady_clock::now();
+
+	WorkerPool pool(workerList_.size());
+	pool.run(utteranceList.size(), [&](unsigned int workerIndex, std::size_t i) {
+		try {
+			synthesize(worker(workerIndex), i, utteranceList[i], resultList[i]);
+		} catch (const std::exception& exc) {
+			resultList[i].error = exc.what();
+		}
+	});
+
+	const auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+double
+BatchSynthesis::runStreaming(const std::string& corpusFilePath, unsigned int numberOfRepetitions,
+				double minAudioDuration, StreamingSink& sink, StreamingResult& result)
+{
+	result = StreamingResult();
+
+	const auto t0 = std::chrono::steady_clock::now();
+
+	Worker& w = worker(0);
+	VTMControlModel::Controller& controller = *w.synthesis->vtmController;
+	StreamingSynthesis streamingSynthesis(controller, sink);
+	const std::size_t minNumberOfSamples = static_cast<std::size_t>(minAudioDuration * controller.outputSampleRate());
+	for (unsigned int rep = 0;
+			rep < numberOfRepetitions || streamingSynthesis.statistics().numberOfSamples < minNumberOfSamples;
+			++rep) {
+		std::ifstream in(corpusFilePath);
+		if (!in) {
+			THROW_EXCEPTION(BatchSynthesisException, "Could not open the file " << corpusFilePath << '.');
+		}
+		std::string line;
+		while (std::getline(in, line)) {
+			const std::string utterance = corpusLine(line);
+			if (utterance.empty()) continue;
+			if (config_.phoneticInput) {
+				streamingSynthesis.write(utterance);
+			} else {
+				streamingSynthesis.write(w.synthesis->textParserService->parse(
+								utterance, controller.vtmControlModelConfiguration()));
+			}
+			++result.numberOfUtterances;
+		}
+		if (result.numberOfUtterances == 0) break;
+		if (rep == 0) {
+			result.firstPassResidentMemory = residentMemory();
+		}
+	}
+	streamingSynthesis.finish();
+	result.finalResidentMemory = residentMemory();
+
+	const StreamingSynthesis::Statistics& stats = streamingSynthesis.statistics();
+	result.numberOfChunks = stats.numberOfChunks;
+	result.maxChunkSize = stats.maxChunkSize;
+	result.audioDuration = stats.numberOfSamples / controller.outputSampleRate();
+
+	const auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+// Returns the current resident set size (KiB), or 0 if it is not available.
+long
+BatchSynthesis::residentMemory()
+{
+	std::ifstream in("/proc/self/statm");
+	long totalPages = 0, residentPages = 0;
+	if (!(in >> totalPages >> residentPages)) return 0;
+	return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Each worker index is used by only one thread at a time.
+BatchSynthesis::Worker&
+BatchSynthesis::worker(unsigned int workerIndex)
+{
+	std::unique_ptr<Worker>& w = workerList_[workerIndex];
+	if (!w) {
+		auto newWorker = std::make_unique<Worker>();
+		newWorker->appConfig.projectDir = QString::fromStdString(projectDir_);
+		newWorker->appConfig.dataFilePath = QString::fromStdString(modelFilePath_);
+		newWorker->model = std::make_unique<VTMControlModel::Model>();
+		newWorker->model->load(modelFilePath_);
+		newWorker->synthesis = std::make_unique<Synthesis>(newWorker->appConfig);
+		newWorker->synthesis->setup(newWorker->model.get());
+		w = std::move(newWorker);
+	}
+	return *w;
+}
+
+void
+BatchSynthesis::synthesize(Worker& worker, std::size_t index, const std::string& utterance, Result& result)
+{
+	VTMControlModel::Controller& controller = *worker.synthesis->vtmController;
+
+	const auto t0 = std::chrono::steady_clock::now();
+
+	std::string phoneticString;
+	if (config_.phoneticInput) {
+		phoneticString = utterance;
+	} else {
+		phoneticString = worker.synthesis->textParserService->parse(utterance, controller.vtmControlModelConfiguration());
+	}
+	std::string vtmParamFilePath;
+	if (!config_.outputDir.empty() && config_.saveVTMParam) {
+		vtmParamFilePath = outputFilePath(index, "_vtm_param.txt");
+	}
+	worker.buffer.clear();
+	controller.synthesizePhoneticStringToBuffer(phoneticString,
+							vtmParamFilePath.empty() ? nullptr : vtmParamFilePath.c_str(),
+							worker.buffer);
+
+	const auto t1 = std::chrono::steady_clock::now();
+
+	const double sampleRate = controller.outputSampleRate();
+	result.synthesisTime = std::chrono::duration<double>(t1 - t0).count();
+	result.audioDuration = worker.buffer.size() / sampleRate;
+
+	if (config_.outputDir.empty()) return;
+
+	result.wavFilePath = outputFilePath(index, ".wav");
+	WAVWriter writer(result.wavFilePath, sampleRate);
+	writer.write(worker.buffer.data(), worker.buffer.size());
+	writer.close();
+}
+
+std::string
+BatchSynthesis::outputFilePath(std::size_t index, const char* suffix) const
+{
+	char number[32];
+	std::snprintf(number, sizeof number, "%04zu", index + 1U);
+	return config_.outputDir + '/' + config_.filePrefix + number + suffix;
+}
+
+void
+BatchSynthesis::readCorpus(const std::string& filePath, std::vector<std::string>& utteranceList)
+{
+	std::ifstream in(filePath);
+	if (!in) {
+		THROW_EXCEPTION(BatchSynthesisException, "Could not open the file " << filePath << '.');
+	}
+
+	utteranceList.clear();
+	std::string line;
+	while (std::getline(in, line)) {
+		std::string utterance = corpusLine(line);
+		if (utterance.empty()) continue;
+		utteranceList.push_back(std::move(utterance));
+	}
+}
+
+// Returns an empty string if the line must be ignored.
+std::string
+BatchSynthesis::corpusLine(std::string line)
+{
+	if (!line.empty() && line.back() == '\r') {
+		line.pop_back();
+	}
+	const std::size_t pos = line.find_first_not_of(" \t");
+	if (pos == std::string::npos || line[pos] == '#') return std::string();
+	return line.substr(pos);
+}
+
+} // namespace GS
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef BATCH_SYNTHESIS_H
+#define BATCH_SYNTHESIS_H
+
+#include <cstddef> /* std::size_t */
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Exception.h"
+
+
+
+namespace GS {
+
+class StreamingSink;
+
+struct BatchSynthesisException : std::runtime_error {
+	using std::runtime_error::runtime_error;
+};
+
+// Synthesizes a list of utterances in parallel, without GUI.
+// Each worker has its own model and controller.
+class BatchSynthesis {
+public:
+	struct Configuration {
+		unsigned int numberOfWorkers; // 0: use the number of hardware threads
+		bool phoneticInput;           // the utterances are phonetic strings
+		bool saveVTMParam;
+		std::string outputDir;        // if empty, the files will not be written
+		std::string filePrefix;
+
+		Configuration()
+			: numberOfWorkers()
+			, phoneticInput()
+			, saveVTMParam()
+			, filePrefix("utt_")
+		{
+		}
+	};
+
+	struct Result {
+		std::string wavFilePath;
+		double audioDuration; // s
+		double synthesisTime; // s
+		std::string error;    // empty if there was no error
+
+		double realTimeFactor() const { return audioDuration > 0.0 ? synthesisTime / audioDuration : 0.0; }
+	};
+
+	struct StreamingResult {
+		std::size_t numberOfUtterances;
+		std::size_t numberOfChunks;
+		std::size_t maxChunkSize;       // bytes of phonetic string
+		double audioDuration;           // s
+		long firstPassResidentMemory;   // KiB - after the first pass through the corpus
+		long finalResidentMemory;       // KiB
+	};
+
+	BatchSynthesis(const std::string& projectDir, const Configuration& config);
+	~BatchSynthesis();
+
+	// resultList[i] corresponds to utteranceList[i].
+	// Returns the total elapsed time (s).
+	double run(const std::vector<std::string>& utteranceList, std::vector<Result>& resultList);
+
+	// Synthesizes the corpus as a single stream. The corpus is repeated
+	// numberOfRepetitions times, and then until the audio duration reaches
+	// minAudioDuration (s). The file is read incrementally. Uses only one worker.
+	// Returns the total elapsed time (s).
+	double runStreaming(const std::string& corpusFilePath, unsigned int numberOfRepetitions,
+				double minAudioDuration, StreamingSink& sink, StreamingResult& result);
+
+	unsigned int numberOfWorkers() const;
+
+	// Reads one utterance per line. Empty lines and lines starting with '#' are ignored.
+	static void readCorpus(const std::string& filePath, std::vector<std::string>& utteranceList);
+private:
+	struct Worker;
+
+	BatchSynthesis(const BatchSynthesis&) = delete;
+	BatchSynthesis& operator=(const BatchSynthesis&) = delete;
+	BatchSynthesis(BatchSynthesis&&) = delete;
+	BatchSynthesis& operator=(BatchSynthesis&&) = delete;
+
+	Worker& worker(unsigned int workerIndex);
+	void synthesize(Worker& worker, std::size_t index, const std::string& utterance, Result& result);
+	std::string outputFilePath(std::size_t index, const char* suffix) const;
+	static std::string corpusLine(std::string line);
+	static long residentMemory();
+
+	const std::string projectDir_;
+	const Configuration config_;
+	std::string modelFilePath_;
+	std::vector<std::unique_ptr<Worker>> workerList_;
+};
+
+} // namespace GS
+
+#endif // BATCH_SYNTHESIS_H
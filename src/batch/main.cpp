@@ -0,0 +1,231 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include <xmmintrin.h> /* SSE */
+#include <pmmintrin.h> /* SSE3 */
+
+#include <sys/resource.h> /* getrusage */
+
+#include <cstdlib> /* EXIT_SUCCESS, EXIT_FAILURE */
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BatchSynthesis.h"
+#include "Index.h"
+#include "JackConfig.h"
+#include "Log.h"
+#include "StreamingSink.h"
+
+
+
+namespace {
+
+void
+showUsage(const char* programName)
+{
+	std::cout << "\nUsage:\n\n"
+		<< programName << " [-p] [-s] [-j num_workers] [-o output_dir] project_dir corpus_file\n"
+		<< programName << " -S [-p] [-s] [-r repetitions] [-d duration] [-m max_growth] [-J | -o output_dir] project_dir corpus_file\n\n"
+		<< "  -p : the corpus contains phonetic strings (default: text)\n"
+		<< "  -s : save the VTM parameters\n"
+		<< "  -j : number of worker threads (default: number of hardware threads)\n"
+		<< "  -o : directory of the output files (default: the files are not written)\n"
+		<< "  -v : verbose\n"
+		<< "  -S : streaming mode - the corpus is synthesized as a single stream with bounded memory\n"
+		<< "  -r : number of repetitions of the corpus in streaming mode (default: 1)\n"
+		<< "  -d : minimum audio duration in streaming mode (s) - the corpus is repeated until it is reached\n"
+		<< "  -m : maximum growth of the resident memory after the first pass in streaming mode (KiB)\n"
+		<< "       - if it is exceeded, the exit status indicates failure\n"
+		<< "  -J : play the stream using JACK\n\n"
+		<< "The corpus file contains one utterance per line.\n"
+		<< "Empty lines and lines starting with '#' are ignored.\n\n"
+		<< "Example - check that one hour of streaming synthesis runs with bounded memory:\n\n"
+		<< programName << " -S -d 3600 -m 16384 project_dir corpus_file\n" << std::endl;
+}
+
+// KiB.
+long
+peakMemoryUsage()
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	return usage.ru_maxrss;
+}
+
+int
+runStreaming(const char* projectDir, const char* corpusFile, const GS::BatchSynthesis::Configuration& config,
+		unsigned int numberOfRepetitions, double minAudioDuration, long maxMemoryGrowth, bool useJack)
+{
+	std::unique_ptr<GS::StreamingSink> sink;
+	if (useJack) {
+		GS::Index index{projectDir};
+		GS::JackConfig::setupFromFile(index.entry("jack_file").c_str());
+		sink = std::make_unique<GS::JackStreamingSink>();
+	} else if (!config.outputDir.empty()) {
+		const std::string prefix = config.outputDir + '/' + config.filePrefix + "stream";
+		sink = std::make_unique<GS::WAVStreamingSink>(prefix + ".wav",
+					config.saveVTMParam ? prefix + "_vtm_param.txt" : std::string());
+	} else {
+		sink = std::make_unique<GS::NullStreamingSink>();
+	}
+
+	GS::BatchSynthesis batch(projectDir, config);
+	GS::BatchSynthesis::StreamingResult result;
+	const double elapsedTime = batch.runStreaming(corpusFile, numberOfRepetitions, minAudioDuration, *sink, result);
+	const long memoryGrowth = result.finalResidentMemory - result.firstPassResidentMemory;
+
+	std::cout << std::fixed << std::setprecision(4)
+		<< "Utterances: " << result.numberOfUtterances
+		<< "\nChunks: " << result.numberOfChunks
+		<< "\nLongest chunk: " << result.maxChunkSize << " bytes"
+		<< "\nAudio duration: " << result.audioDuration << " s"
+		<< "\nElapsed time: " << elapsedTime << " s";
+	if (result.audioDuration > 0.0) {
+		std::cout << "\nRTF: " << elapsedTime / result.audioDuration;
+	}
+	std::cout << "\nPeak memory usage: " << peakMemoryUsage() << " KiB"
+		<< "\nResident memory after the first pass: " << result.firstPassResidentMemory << " KiB"
+		<< "\nResident memory at the end: " << result.finalResidentMemory << " KiB" << std::endl;
+
+	if (result.audioDuration < minAudioDuration) {
+		std::cerr << "The audio duration is shorter than " << minAudioDuration << " s." << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (maxMemoryGrowth >= 0 && memoryGrowth > maxMemoryGrowth) {
+		std::cerr << "The resident memory grew by " << memoryGrowth << " KiB after the first pass (maximum: "
+			<< maxMemoryGrowth << " KiB)." << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+	// Disable denormals.
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);         // requires xmmintrin.h
+	_MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON); // requires pmmintrin.h
+
+	std::locale::global(std::locale::classic());
+
+	GS::BatchSynthesis::Configuration config;
+	const char* projectDir = nullptr;
+	const char* corpusFile = nullptr;
+	bool streaming = false;
+	bool useJack = false;
+	unsigned int numberOfRepetitions = 1;
+	double minAudioDuration = 0.0;
+	long maxMemoryGrowth = -1; // disabled
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-p") == 0) {
+			config.phoneticInput = true;
+		} else if (std::strcmp(argv[i], "-s") == 0) {
+			config.saveVTMParam = true;
+		} else if (std::strcmp(argv[i], "-v") == 0) {
+			GS::Log::debugEnabled = true;
+		} else if (std::strcmp(argv[i], "-S") == 0) {
+			streaming = true;
+		} else if (std::strcmp(argv[i], "-J") == 0) {
+			useJack = true;
+		} else if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			numberOfRepetitions = std::strtoul(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+			minAudioDuration = std::strtod(argv[++i], nullptr);
+		} else if (std::strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+			maxMemoryGrowth = std::strtol(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			config.numberOfWorkers = std::strtoul(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			config.outputDir = argv[++i];
+		} else if (argv[i][0] == '-') {
+			showUsage(argv[0]);
+			return EXIT_FAILURE;
+		} else if (!projectDir) {
+			projectDir = argv[i];
+		} else if (!corpusFile) {
+			corpusFile = argv[i];
+		} else {
+			showUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (!projectDir || !corpusFile || (useJack && !streaming)) {
+		showUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try {
+		if (streaming) {
+			return runStreaming(projectDir, corpusFile, config, numberOfRepetitions, minAudioDuration,
+						maxMemoryGrowth, useJack);
+		}
+
+		std::vector<std::string> utteranceList;
+		GS::BatchSynthesis::readCorpus(corpusFile, utteranceList);
+
+		GS::BatchSynthesis batch(projectDir, config);
+		std::vector<GS::BatchSynthesis::Result> resultList;
+		const double elapsedTime = batch.run(utteranceList, resultList);
+
+		double totalAudioDuration = 0.0;
+		double totalSynthesisTime = 0.0;
+		unsigned int numErrors = 0;
+		std::cout << std::fixed << std::setprecision(4);
+		for (std::size_t i = 0; i < resultList.size(); ++i) {
+			const GS::BatchSynthesis::Result& result = resultList[i];
+			if (!result.error.empty()) {
+				std::cerr << "Utterance " << i + 1U << ": " << result.error << std::endl;
+				++numErrors;
+				continue;
+			}
+			std::cout << "Utterance " << i + 1U
+				<< " duration: " << result.audioDuration
+				<< " s synthesis time: " << result.synthesisTime
+				<< " s RTF: " << result.realTimeFactor() << '\n';
+			totalAudioDuration += result.audioDuration;
+			totalSynthesisTime += result.synthesisTime;
+		}
+
+		std::cout << "\nWorkers: " << batch.numberOfWorkers()
+			<< "\nUtterances: " << resultList.size() - numErrors << " (errors: " << numErrors << ')'
+			<< "\nAudio duration: " << totalAudioDuration << " s"
+			<< "\nSynthesis time (sum): " << totalSynthesisTime << " s"
+			<< "\nElapsed time: " << elapsedTime << " s";
+		if (totalAudioDuration > 0.0) {
+			std::cout << "\nRTF (per core): " << totalSynthesisTime / totalAudioDuration
+				<< "\nRTF (overall): " << elapsedTime / totalAudioDuration;
+		}
+		std::cout << std::endl;
+
+		return numErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	} catch (std::exception& e) {
+		std::cerr << "Caught exception: " << e.what() << '.' << std::endl;
+	} catch (...) {
+		std::cerr << "Caught unexpected exception." << std::endl;
+	}
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include "SynthesisBenchmark.h"
+
+#include <algorithm> /* sort */
+#include <chrono>
+#include <cstdio> /* snprintf */
+
+#include "AppConfig.h"
+#include "Controller.h"
+#include "EventList.h"
+#include "Index.h"
+#include "Model.h"
+#include "OfflineRenderer.h"
+#include "Synthesis.h"
+#include "TextParserService.h"
+#include "VTMUtil.h"
+
+#ifndef GAMATTS_EDITOR_COMMIT
+# define GAMATTS_EDITOR_COMMIT "unknown"
+#endif
+#ifndef GAMATTS_COMMIT
+# define GAMATTS_COMMIT "unknown"
+#endif
+
+
+
+namespace {
+
+const char* stageNames[] = {
+	"text_parser",
+	"controller",
+	"event_list_preparation",
+	"controller_from_event_list",
+	"vtm",
+	"output_scaling"
+};
+
+std::string
+jsonString(const std::string& s)
+{
+	std::string out = "\"";
+	for (char c : s) {
+		switch (c) {
+		case '"':  out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buf[8];
+				std::snprintf(buf, sizeof buf, "\\u%04x", static_cast<unsigned int>(c));
+				out += buf;
+			} else {
+				out += c;
+			}
+		}
+	}
+	out += '"';
+	return out;
+}
+
+double
+elapsed(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+} // namespace
+
+namespace GS {
+
+SynthesisBenchmark::SynthesisBenchmark(const std::string& projectDir, const Configuration& config)
+		: projectDir_(projectDir)
+		, config_(config)
+		, appConfig_(std::make_unique<AppConfig>())
+		, numberOfUtterances_()
+		, audioDuration_()
+{
+	Index index{projectDir_};
+	appConfig_->projectDir = QString::fromStdString(projectDir_);
+	appConfig_->dataFilePath = QString::fromStdString(index.entry("artic_file"));
+
+	model_ = std::make_unique<VTMControlModel::Model>();
+	model_->load(appConfig_->dataFilePath.toStdString());
+	synthesis_ = std::make_unique<Synthesis>(*appConfig_);
+	synthesis_->setup(model_.get());
+}
+
+SynthesisBenchmark::~SynthesisBenchmark()
+{
+}
+
+void
+SynthesisBenchmark::run(const std::vector<std::string>& utteranceList)
+{
+	numberOfUtterances_ = utteranceList.size();
+	audioDuration_ = 0.0;
+	for (auto& timeList : stageTimeList_) {
+		timeList.clear();
+	}
+
+	for (unsigned int rep = 0; rep < config_.warmUpRepetitions + config_.repetitions; ++rep) {
+		double stageTime[NUM_STAGES] = {};
+		for (const std::string& utterance : utteranceList) {
+			const double duration = runUtterance(utterance, stageTime);
+			if (rep == config_.warmUpRepetitions) {
+				audioDuration_ += duration;
+			}
+		}
+		if (rep < config_.warmUpRepetitions) continue;
+
+		for (int i = 0; i < NUM_STAGES; ++i) {
+			stageTimeList_[i].push_back(stageTime[i]);
+		}
+	}
+}
+
+double
+SynthesisBenchmark::runUtterance(const std::string& utterance, double* stageTime)
+{
+	VTMControlModel::Controller& controller = *synthesis_->vtmController;
+	std::vector<float> buffer;
+	std::vector<float> vtmOutput;
+	OfflineRenderer renderer(controller.vtmConfigData(), controller.vtmControlModelConfiguration().controlRate);
+
+	const auto t0 = std::chrono::steady_clock::now();
+
+	std::string phoneticString;
+	if (config_.phoneticInput) {
+		phoneticString = utterance;
+	} else {
+		phoneticString = synthesis_->textParserService->parse(utterance, controller.vtmControlModelConfiguration());
+	}
+
+	const auto t1 = std::chrono::steady_clock::now();
+
+	controller.synthesizePhoneticStringToBuffer(phoneticString, nullptr, buffer);
+
+	const auto t2 = std::chrono::steady_clock::now();
+
+	// Same steps as the synthesis from the event list in the editor.
+	auto& eventList = controller.eventList();
+	eventList.clearMacroIntonation();
+	eventList.prepareMacroIntonationInterpolation();
+
+	const auto t3 = std::chrono::steady_clock::now();
+
+	buffer.clear();
+	controller.synthesizeFromEventListToBuffer(nullptr, buffer);
+
+	const auto t4 = std::chrono::steady_clock::now();
+
+	renderer.renderSerial(controller.vtmParameterList(), vtmOutput);
+
+	const auto t5 = std::chrono::steady_clock::now();
+
+	const float scale = VTM::Util::calculateOutputScale(VTM::Util::maximumAbsoluteValue(vtmOutput));
+	for (float& sample : vtmOutput) {
+		sample *= scale;
+	}
+
+	const auto t6 = std::chrono::steady_clock::now();
+
+	stageTime[STAGE_TEXT_PARSER]                += elapsed(t0, t1);
+	stageTime[STAGE_CONTROLLER]                 += elapsed(t1, t2);
+	stageTime[STAGE_EVENT_LIST_PREPARATION]     += elapsed(t2, t3);
+	stageTime[STAGE_CONTROLLER_FROM_EVENT_LIST] += elapsed(t3, t4);
+	stageTime[STAGE_VTM]                        += elapsed(t4, t5);
+	stageTime[STAGE_OUTPUT_SCALING]             += elapsed(t5, t6);
+
+	return buffer.size() / controller.outputSampleRate();
+}
+
+void
+SynthesisBenchmark::writeJSON(std::ostream& out) const
+{
+	out.precision(9);
+	out << "{\n"
+		<< "  \"project_dir\": " << jsonString(projectDir_) << ",\n"
+		<< "  \"editor_commit\": " << jsonString(GAMATTS_EDITOR_COMMIT) << ",\n"
+		<< "  \"gamatts_commit\": " << jsonString(GAMATTS_COMMIT) << ",\n"
+		<< "  \"utterances\": " << numberOfUtterances_ << ",\n"
+		<< "  \"audio_duration\": " << audioDuration_ << ",\n"
+		<< "  \"warm_up_repetitions\": " << config_.warmUpRepetitions << ",\n"
+		<< "  \"repetitions\": " << config_.repetitions << ",\n"
+		<< "  \"stages\": {\n";
+
+	for (int i = 0; i < NUM_STAGES; ++i) {
+		if (i > 0) out << ",\n";
+		writeStatistics(out, stageNames[i], stageTimeList_[i]);
+	}
+	out << "\n  }\n}\n";
+}
+
+void
+SynthesisBenchmark::writeStatistics(std::ostream& out, const char* name, std::vector<double> valueList)
+{
+	double min = 0.0, max = 0.0, mean = 0.0, median = 0.0;
+	if (!valueList.empty()) {
+		std::sort(valueList.begin(), valueList.end());
+		const std::size_t n = valueList.size();
+		min = valueList.front();
+		max = valueList.back();
+		for (double v : valueList) mean += v;
+		mean /= n;
+		median = (n % 2U == 1U) ? valueList[n / 2U] : 0.5 * (valueList[n / 2U - 1U] + valueList[n / 2U]);
+	}
+	out << "    " << jsonString(name) << ": {"
+		<< "\"min\": " << min
+		<< ", \"median\": " << median
+		<< ", \"mean\": " << mean
+		<< ", \"max\": " << max
+		<< '}';
+}
+
+} // namespace GS
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#ifndef SYNTHESIS_BENCHMARK_H
+#define SYNTHESIS_BENCHMARK_H
+
+#include <cstddef> /* std::size_t */
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+
+namespace GS {
+
+struct AppConfig;
+struct Synthesis;
+namespace VTMControlModel {
+class Model;
+}
+
+// Measures the time spent in each stage of the synthesis pipeline.
+//
+// Each stage is timed directly, with the same calls that the editor uses.
+// The Controller does not expose the rules and the parameter interpolation
+// separately, so they are only measured as part of the controller stages.
+class SynthesisBenchmark {
+public:
+	struct Configuration {
+		unsigned int warmUpRepetitions;
+		unsigned int repetitions;
+		bool phoneticInput; // the corpus contains phonetic strings
+
+		Configuration()
+			: warmUpRepetitions(1)
+			, repetitions(5)
+			, phoneticInput()
+		{
+		}
+	};
+
+	SynthesisBenchmark(const std::string& projectDir, const Configuration& config);
+	~SynthesisBenchmark();
+
+	void run(const std::vector<std::string>& utteranceList);
+	void writeJSON(std::ostream& out) const;
+private:
+	enum Stage {
+		STAGE_TEXT_PARSER,
+		STAGE_CONTROLLER,              // phonetic string -> audio
+		STAGE_EVENT_LIST_PREPARATION,  // macro intonation
+		STAGE_CONTROLLER_FROM_EVENT_LIST,
+		STAGE_VTM,
+		STAGE_OUTPUT_SCALING,
+		NUM_STAGES
+	};
+
+	SynthesisBenchmark(const SynthesisBenchmark&) = delete;
+	SynthesisBenchmark& operator=(const SynthesisBenchmark&) = delete;
+	SynthesisBenchmark(SynthesisBenchmark&&) = delete;
+	SynthesisBenchmark& operator=(SynthesisBenchmark&&) = delete;
+
+	// Adds the time of each stage to stageTime. Returns the audio duration (s).
+	double runUtterance(const std::string& utterance, double* stageTime);
+	static void writeStatistics(std::ostream& out, const char* name, std::vector<double> valueList);
+
+	const std::string projectDir_;
+	const Configuration config_;
+	std::unique_ptr<AppConfig> appConfig_;
+	std::unique_ptr<VTMControlModel::Model> model_;
+	std::unique_ptr<Synthesis> synthesis_;
+	std::size_t numberOfUtterances_;
+	double audioDuration_; // s, whole corpus
+	std::vector<double> stageTimeList_[NUM_STAGES]; // one value per repetition
+};
+
+} // namespace GS
+
+#endif // SYNTHESIS_BENCHMARK_H
@@ -0,0 +1,124 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+// Measures the paint time of Figure2DWidget as a function of the number of points.
+//
+// Usage: QT_QPA_PLATFORM=offscreen gama_tts_figure_benchmark [-r repetitions]
+
+#include <algorithm> /* sort */
+#include <chrono>
+#include <cmath> /* sin */
+#include <cstdlib> /* EXIT_SUCCESS, EXIT_FAILURE, strtoul */
+#include <cstring>
+#include <iostream>
+#include <iterator> /* size */
+#include <random>
+#include <vector>
+
+#include <QApplication>
+#include <QImage>
+
+#include "Figure2DWidget.h"
+
+#define WIDGET_WIDTH 1024
+#define WIDGET_HEIGHT 400
+
+
+
+namespace {
+
+const std::size_t numberOfPointsList[] = {
+	1000,
+	4000,
+	16000,
+	32769,
+	128000,
+	512000,
+	2048000
+};
+
+// Returns the median paint time (ms).
+double
+measurePaintTime(Lab::Figure2DWidget& widget, QImage& image, unsigned int repetitions)
+{
+	std::vector<double> timeList;
+	widget.render(&image); // warm-up
+	for (unsigned int i = 0; i < repetitions; ++i) {
+		const auto t0 = std::chrono::steady_clock::now();
+		widget.render(&image);
+		const auto t1 = std::chrono::steady_clock::now();
+		timeList.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+	}
+	std::sort(timeList.begin(), timeList.end());
+	return timeList[timeList.size() / 2U];
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+	QApplication app(argc, argv);
+
+	unsigned int repetitions = 10;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			repetitions = std::strtoul(argv[++i], nullptr, 10);
+		} else {
+			std::cout << "\nUsage:\n\n" << argv[0] << " [-r repetitions]\n" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (repetitions == 0) {
+		return EXIT_FAILURE;
+	}
+
+	Lab::Figure2DWidget widget;
+	widget.resize(WIDGET_WIDTH, WIDGET_HEIGHT);
+	QImage image(widget.size(), QImage::Format_ARGB32_Premultiplied);
+
+	std::mt19937 generator(1);
+	std::normal_distribution<float> noise(0.0f, 0.1f);
+
+	std::cout << "{\n"
+		<< "  \"width\": " << WIDGET_WIDTH << ",\n"
+		<< "  \"height\": " << WIDGET_HEIGHT << ",\n"
+		<< "  \"repetitions\": " << repetitions << ",\n"
+		<< "  \"results\": [\n";
+	for (std::size_t n = 0; n < std::size(numberOfPointsList); ++n) {
+		const std::size_t numberOfPoints = numberOfPointsList[n];
+		std::vector<float> x(numberOfPoints), y(numberOfPoints);
+		for (std::size_t i = 0; i < numberOfPoints; ++i) {
+			x[i] = i;
+			y[i] = std::sin(i * (50.0 / numberOfPoints)) + noise(generator);
+		}
+		widget.updateData(x, y);
+
+		widget.setDecimation(false);
+		const double fullTime = measurePaintTime(widget, image, repetitions);
+		widget.setDecimation(true);
+		const double decimatedTime = measurePaintTime(widget, image, repetitions);
+
+		std::cout << "    {\"points\": " << numberOfPoints
+			<< ", \"paint_ms\": " << fullTime
+			<< ", \"decimated_paint_ms\": " << decimatedTime << '}'
+			<< (n + 1U < std::size(numberOfPointsList) ? ",\n" : "\n");
+	}
+	std::cout << "  ]\n}" << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+#include <xmmintrin.h> /* SSE */
+#include <pmmintrin.h> /* SSE3 */
+
+#include <cstdlib> /* EXIT_SUCCESS, EXIT_FAILURE */
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <string>
+#include <vector>
+
+#include "BatchSynthesis.h"
+#include "SynthesisBenchmark.h"
+
+
+
+namespace {
+
+void
+showUsage(const char* programName)
+{
+	std::cout << "\nUsage:\n\n"
+		<< programName << " [-p] [-w warm_up_repetitions] [-r repetitions] [-o output_file] project_dir corpus_file\n\n"
+		<< "  -p : the corpus contains phonetic strings (default: text)\n"
+		<< "  -w : number of warm-up repetitions (default: 1)\n"
+		<< "  -r : number of measured repetitions (default: 5)\n"
+		<< "  -o : JSON output file (default: standard output)\n\n"
+		<< "The corpus file contains one utterance per line.\n"
+		<< "Empty lines and lines starting with '#' are ignored.\n" << std::endl;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+	// Disable denormals.
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);         // requires xmmintrin.h
+	_MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON); // requires pmmintrin.h
+
+	std::locale::global(std::locale::classic());
+
+	GS::SynthesisBenchmark::Configuration config;
+	const char* outputFile = nullptr;
+	const char* projectDir = nullptr;
+	const char* corpusFile = nullptr;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-p") == 0) {
+			config.phoneticInput = true;
+		} else if (std::strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			config.warmUpRepetitions = std::strtoul(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			config.repetitions = std::strtoul(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			outputFile = argv[++i];
+		} else if (argv[i][0] == '-') {
+			showUsage(argv[0]);
+			return EXIT_FAILURE;
+		} else if (!projectDir) {
+			projectDir = argv[i];
+		} else if (!corpusFile) {
+			corpusFile = argv[i];
+		} else {
+			showUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (!projectDir || !corpusFile || config.repetitions == 0) {
+		showUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try {
+		std::vector<std::string> utteranceList;
+		GS::BatchSynthesis::readCorpus(corpusFile, utteranceList);
+
+		GS::SynthesisBenchmark benchmark(projectDir, config);
+		benchmark.run(utteranceList);
+
+		if (outputFile) {
+			std::ofstream out(outputFile);
+			if (!out) {
+				std::cerr << "Could not open the file " << outputFile << '.' << std::endl;
+				return EXIT_FAILURE;
+			}
+			benchmark.writeJSON(out);
+		} else {
+			benchmark.writeJSON(std::cout);
+		}
+
+		return EXIT_SUCCESS;
+
+	} catch (std::exception& e) {
+		std::cerr << "Caught exception: " << e.what() << '.' << std::endl;
+	} catch (...) {
+		std::cerr << "Caught unexpected exception." << std::endl;
+	}
+
+	return EXIT_FAILURE;
+}
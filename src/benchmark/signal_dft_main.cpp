@@ -0,0 +1,152 @@
+/***************************************************************************
+ *  Copyright 2026 Marcelo Y. Matuda                                       *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation, either version 3 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have received a copy of the GNU General Public License      *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+// Measures the refresh cost of the spectrum in AnalysisWindow as a function
+// of the window size, with a fixed DFT size and with a DFT size that follows
+// the window size.
+//
+// Usage: gama_tts_signal_dft_benchmark [-r repetitions] [-z zero_padding_factor]
+
+#include <algorithm> /* copy, max, sort */
+#include <chrono>
+#include <cmath> /* abs, cos, sin */
+#include <cstdlib> /* EXIT_SUCCESS, EXIT_FAILURE, strtoul */
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "SignalDFT.h"
+
+#define FFT_SIZE 65536 /* size of the analysis ring buffer */
+#define MIN_WINDOW_SIZE 32
+
+
+
+namespace {
+
+using namespace GS;
+
+void
+normalize(std::vector<float>& signal, std::size_t size)
+{
+	float maxValue = 0.0;
+	for (std::size_t i = 0; i < size; ++i) {
+		maxValue = std::max(maxValue, std::abs(signal[i]));
+	}
+	if (maxValue > 0.0f) {
+		const float normCoef = 1.0f / maxValue;
+		for (std::size_t i = 0; i < size; ++i) {
+			signal[i] *= normCoef;
+		}
+	}
+}
+
+// Returns the median time (ms).
+template<typename F>
+double
+measureTime(F f, unsigned int repetitions)
+{
+	std::vector<double> timeList;
+	f(); // warm-up
+	for (unsigned int i = 0; i < repetitions; ++i) {
+		const auto t0 = std::chrono::steady_clock::now();
+		f();
+		const auto t1 = std::chrono::steady_clock::now();
+		timeList.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+	}
+	std::sort(timeList.begin(), timeList.end());
+	return timeList[timeList.size() / 2U];
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+	unsigned int repetitions = 20;
+	unsigned int zeroPaddingFactor = 4;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			repetitions = std::strtoul(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "-z") == 0 && i + 1 < argc) {
+			zeroPaddingFactor = std::strtoul(argv[++i], nullptr, 10);
+		} else {
+			std::cout << "\nUsage:\n\n" << argv[0] << " [-r repetitions] [-z zero_padding_factor]\n" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (repetitions == 0 || zeroPaddingFactor == 0 || (zeroPaddingFactor & (zeroPaddingFactor - 1U)) != 0) {
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 generator(1);
+	std::normal_distribution<float> noise(0.0f, 0.1f);
+	std::vector<float> input(FFT_SIZE);
+	for (std::size_t i = 0; i < input.size(); ++i) {
+		input[i] = 0.5f * std::sin(i * 0.05) + noise(generator);
+	}
+	std::vector<float> signal(FFT_SIZE * zeroPaddingFactor);
+	std::vector<float> output(FFT_SIZE * zeroPaddingFactor / 2 + 1);
+
+	SignalDFT fixedDFT(FFT_SIZE);
+	SignalDFT matchedDFT(FFT_SIZE * zeroPaddingFactor);
+
+	std::cout << "{\n"
+		<< "  \"fixed_fft_size\": " << FFT_SIZE << ",\n"
+		<< "  \"zero_padding_factor\": " << zeroPaddingFactor << ",\n"
+		<< "  \"repetitions\": " << repetitions << ",\n"
+		<< "  \"results\": [\n";
+	for (unsigned int windowSize = MIN_WINDOW_SIZE; windowSize <= FFT_SIZE; windowSize *= 2) {
+		std::vector<double> window(windowSize);
+		const double coef = 2.0 * M_PI / (windowSize - 1);
+		for (unsigned int i = 0; i < windowSize; ++i) {
+			window[i] = 0.5 * (1.0 - std::cos(coef * i)); // Hann
+		}
+
+		// Whole ring buffer normalized, windowed and padded in place, then copied to the DFT.
+		const double fixedTime = measureTime([&]() {
+			std::copy(input.begin(), input.end(), signal.begin());
+			normalize(signal, FFT_SIZE);
+			for (unsigned int i = 0; i < windowSize; ++i) {
+				signal[i] *= window[i];
+			}
+			for (unsigned int i = windowSize; i < FFT_SIZE; ++i) {
+				signal[i] = 0.0;
+			}
+			fixedDFT.execute(signal.data(), output.data());
+		}, repetitions);
+
+		// Only the window is read and normalized. The window is applied during the copy to the DFT.
+		const double matchedTime = measureTime([&]() {
+			std::copy(input.begin(), input.begin() + windowSize, signal.begin());
+			normalize(signal, windowSize);
+			matchedDFT.setSize(windowSize * zeroPaddingFactor);
+			matchedDFT.execute(signal.data(), window.data(), windowSize, output.data());
+		}, repetitions);
+
+		std::cout << "    {\"window_size\": " << windowSize
+			<< ", \"fft_size\": " << windowSize * zeroPaddingFactor
+			<< ", \"fixed_refresh_ms\": " << fixedTime
+			<< ", \"matched_refresh_ms\": " << matchedTime << '}'
+			<< (windowSize < FFT_SIZE ? ",\n" : "\n");
+	}
+	std::cout << "  ],\n"
+		<< "  \"cached_plans\": " << matchedDFT.numberOfCachedPlans() << "\n}" << std::endl;
+
+	return EXIT_SUCCESS;
+}
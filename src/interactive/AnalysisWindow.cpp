@@ -18,7 +18,7 @@
 #include "AnalysisWindow.h"
 
 #include <cassert>
-#include <cmath> /* abs, cos, log10, sqrt */
+#include <cmath> /* abs, cos, log10 */
 #include <cstddef> /* std::size_t */
 
 #include <QStringList>
@@ -26,6 +26,7 @@
 
 #include "JackRingbuffer.h"
 #include "SignalDFT.h"
+#include "Trace.h"
 #include "ui_AnalysisWindow.h"
 
 #define TIMER_INTERVAL_MS 500
@@ -50,7 +51,9 @@ constexpr int MAX_DB = -20;
 constexpr int MIN_DB = -120;
 constexpr int DB_STEP = 10;
 constexpr unsigned int MIN_WINDOW_SIZE = 32;
-constexpr unsigned int FFT_SIZE = 65536;
+constexpr unsigned int FFT_SIZE = 65536; // size of the analysis ring buffer
+constexpr unsigned int MAX_ZERO_PADDING_FACTOR = 16;
+constexpr unsigned int DEFAULT_ZERO_PADDING_FACTOR = 4;
 
 } /* namespace */
 
@@ -64,7 +67,10 @@ AnalysisWindow::AnalysisWindow(QWidget *parent)
 		, analysisRingbufferNumSamples_()
 		, timer_(new QTimer(this))
 		, state_(State::stopped)
-		, signalDFT_(std::make_unique<SignalDFT>(FFT_SIZE))
+		, plotXStep_()
+		, plotYIndex_()
+		, signalDFT_(std::make_unique<SignalDFT>(FFT_SIZE * DEFAULT_ZERO_PADDING_FACTOR))
+		, windowSum_()
 {
 	ui_->setupUi(this);
 
@@ -91,6 +97,11 @@ AnalysisWindow::AnalysisWindow(QWidget *parent)
 	ui_->windowTypeComboBox->addItem(tr("Blackman")   , WINDOW_BLACKMAN);
 	ui_->windowTypeComboBox->setCurrentIndex(ui_->windowTypeComboBox->count() - 1);
 
+	for (unsigned int factor = 1; factor <= MAX_ZERO_PADDING_FACTOR; factor *= 2) {
+		ui_->zeroPaddingComboBox->addItem(QString("x%1").arg(factor), factor);
+	}
+	ui_->zeroPaddingComboBox->setCurrentIndex(ui_->zeroPaddingComboBox->findData(DEFAULT_ZERO_PADDING_FACTOR));
+
 	ui_->spectrumPlot->setReduceYRange(true);
 
 	connect(ui_->viewComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [&](int /*index*/) {
@@ -104,6 +115,9 @@ AnalysisWindow::AnalysisWindow(QWidget *parent)
 		setupWindow();
 		ui_->spectrumPlot->setReduceYRange(true);
 	});
+	connect(ui_->zeroPaddingComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [&](int /*index*/) {
+		ui_->spectrumPlot->setReduceYRange(true);
+	});
 	connect(ui_->maxFreqComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [&](int /*index*/) {
 		ui_->spectrumPlot->setReduceYRange(true);
 	});
@@ -134,8 +148,7 @@ AnalysisWindow::setData(unsigned int sampleRate, JackRingbuffer* analysisRingbuf
 	ui_->sampleRateLabel->setText(QString::number(sampleRate_));
 
 	signal_.resize(analysisRingbufferNumSamples_);
-	plotX_.reserve(analysisRingbufferNumSamples_);
-	plotY_.reserve(analysisRingbufferNumSamples_);
+	plotX_.reset();
 
 	ui_->windowSizeComboBox->clear();
 	if (analysisRingbufferNumSamples_ > 0) {
@@ -188,6 +201,8 @@ AnalysisWindow::on_startStopButton_clicked()
 void
 AnalysisWindow::showData()
 {
+	TraceSpan span("AnalysisWindow::showData", "gui");
+
 	if (sampleRate_ == 0 || !analysisRingbuffer_) {
 		stop();
 		return;
@@ -206,6 +221,11 @@ AnalysisWindow::showData()
 	}
 	const unsigned int windowSize = ui_->windowSizeComboBox->itemData(ui_->windowSizeComboBox->currentIndex()).toUInt();
 
+	if (ui_->zeroPaddingComboBox->currentIndex() < 0) {
+		return;
+	}
+	const unsigned int zeroPaddingFactor = ui_->zeroPaddingComboBox->itemData(ui_->zeroPaddingComboBox->currentIndex()).toUInt();
+
 	if (ui_->maxFreqComboBox->currentIndex() < 0) {
 		return;
 	}
@@ -220,78 +240,89 @@ AnalysisWindow::showData()
 	const bool spectrumView = (ui_->viewComboBox->currentIndex() == 0);
 
 	// Read data from JACK ringbuffer.
-	size_t bytesRead = analysisRingbuffer_->peek(reinterpret_cast<char*>(&signal_[0]), bufferSize);
-	assert(bytesRead == bufferSize);
-	analysisRingbuffer_->advanceRead(bytesRead);
+	// Only the samples in the window are used.
+	const size_t windowBufferSize = windowSize * sizeof(jack_default_audio_sample_t);
+	size_t bytesRead = analysisRingbuffer_->peek(reinterpret_cast<char*>(&signal_[0]), windowBufferSize);
+	assert(bytesRead == windowBufferSize);
+	analysisRingbuffer_->advanceRead(bufferSize);
 
 	// Normalize.
+	const auto windowEnd = signal_.begin() + windowSize;
 	jack_default_audio_sample_t maxValue = 0.0;
-	for (const auto& sample : signal_) {
-		const jack_default_audio_sample_t absValue = std::abs(sample);
+	for (auto iter = signal_.begin(); iter != windowEnd; ++iter) {
+		const jack_default_audio_sample_t absValue = std::abs(*iter);
 		if (absValue > maxValue) maxValue = absValue;
 	}
 	if (maxValue > 0.0) {
 		const jack_default_audio_sample_t normCoef = 1.0 / maxValue;
-		for (auto& sample : signal_) {
-			sample *= normCoef;
+		for (auto iter = signal_.begin(); iter != windowEnd; ++iter) {
+			*iter *= normCoef;
 		}
 	}
 
+	// Each frame is written to a buffer that is not used by the displayed series.
+	plotYIndex_ ^= 1U;
+	std::shared_ptr<std::vector<float>>& plotYBuffer = plotY_[plotYIndex_];
+	if (!plotYBuffer || plotYBuffer.use_count() > 1) {
+		// The series that uses the buffer is still alive.
+		plotYBuffer = std::make_shared<std::vector<float>>();
+	}
+
+	float yMin, yMax; // range of the plotted values
 	if (spectrumView) {
 		assert(signalDFT_);
 		assert(window_.size() == windowSize);
 
-		for (unsigned int i = 0; i < windowSize; ++i) {
-			signal_[i] *= window_[i];
-		}
-		for (unsigned int i = windowSize; i < FFT_SIZE; ++i) { // padding
-			signal_[i] = 0.0;
-		}
+		// The transform size follows the window size. The plans are cached.
+		signalDFT_->setSize(windowSize * zeroPaddingFactor);
 
 		const unsigned int spectrumSize = signalDFT_->outputSize();
-		plotX_.resize(spectrumSize);
-		plotY_.resize(spectrumSize);
+		const double freqCoef = static_cast<double>(sampleRate_) / signalDFT_->size();
+		updatePlotX(spectrumSize, freqCoef);
+		plotYBuffer->resize(spectrumSize);
+		std::vector<float>& plotY = *plotYBuffer;
 
-		signalDFT_->execute(&signal_[0], plotY_.data());
+		signalDFT_->execute(&signal_[0], window_.data(), windowSize, plotY.data());
 
-		const double freqCoef = static_cast<double>(sampleRate_) / signalDFT_->size();
-		const double dftCoef = std::sqrt(1.0 / signalDFT_->size());
+		// Normalized by the sum of the window, so the level does not depend on
+		// the zero padding, and a full-scale signal stays at or below 0 dB.
+		const double dftCoef = windowSum_ > 0.0 ? 1.0 / windowSum_ : 0.0;
 		if (logYAxis) {
 			for (unsigned int i = 0; i < spectrumSize; ++i) {
-				plotX_[i] = i * freqCoef;
-				plotY_[i] = 20.0 * std::log10(plotY_[i] * dftCoef);
-				if (plotY_[i] < minDecibelLevel) {
-					plotY_[i] = minDecibelLevel;
+				plotY[i] = 20.0 * std::log10(plotY[i] * dftCoef);
+				if (plotY[i] < minDecibelLevel) {
+					plotY[i] = minDecibelLevel;
 				}
 			}
+			yMin = minDecibelLevel;
+			yMax = 0.0;
 		} else {
 			for (unsigned int i = 0; i < spectrumSize; ++i) {
-				plotX_[i] = i * freqCoef;
-				plotY_[i] *= dftCoef;
+				plotY[i] *= dftCoef;
 			}
+			yMin = 0.0;
+			yMax = 1.0;
 		}
 	} else {
-		plotX_.resize(windowSize);
-		plotY_.resize(windowSize);
-
-		for (unsigned int i = 0; i < windowSize; ++i) {
-			plotX_[i] = i;
-			plotY_[i] = signal_[i];
-		}
+		updatePlotX(windowSize, 1.0);
+		plotYBuffer->assign(signal_.begin(), signal_.begin() + windowSize);
+		yMin = -1.0;
+		yMax = 1.0;
 	}
 
+	std::size_t maxSize = plotX_->size();
 	if (spectrumView) {
-		std::size_t maxSize = plotX_.size();
-		for (std::size_t i = 0; i < plotX_.size(); ++i) {
-			if (plotX_[i] > maxFreq) {
+		const std::vector<float>& plotX = *plotX_;
+		for (std::size_t i = 0; i < plotX.size(); ++i) {
+			if (plotX[i] > maxFreq) {
 				maxSize = i;
 				break;
 			}
 		}
-		ui_->spectrumPlot->updateData(plotX_, plotY_, maxSize);
-	} else {
-		ui_->spectrumPlot->updateData(plotX_, plotY_);
 	}
+	if (maxSize < 2U) maxSize = plotX_->size();
+	// The figure is not reset if the x buffer, the size and the range are unchanged.
+	ui_->spectrumPlot->setData(Lab::Figure2DSeries::create(plotX_, plotYBuffer, maxSize, yMin, yMax));
 	//if (spectrumView && logYAxis) {
 	//	ui_->spectrumPlot->graph(0)->valueAxis()->setRange(minDecibelLevel, 0.0);
 	//}
@@ -299,11 +330,26 @@ AnalysisWindow::showData()
 	ui_->spectrumPlot->setReduceYRange(false);
 }
 
+// Creates a new x buffer only if the size or the step has changed.
+void
+AnalysisWindow::updatePlotX(std::size_t size, double step)
+{
+	if (plotX_ && plotX_->size() == size && plotXStep_ == step) return;
+
+	auto plotX = std::make_shared<std::vector<float>>(size);
+	for (std::size_t i = 0; i < size; ++i) {
+		(*plotX)[i] = i * step;
+	}
+	plotX_ = std::move(plotX);
+	plotXStep_ = step;
+}
+
 void
 AnalysisWindow::setupWindow()
 {
 	if (ui_->windowSizeComboBox->currentIndex() < 0) {
 		window_.clear();
+		windowSum_ = 0.0;
 		return;
 	}
 	const unsigned int windowSize = ui_->windowSizeComboBox->itemData(ui_->windowSizeComboBox->currentIndex()).toUInt();
@@ -358,6 +404,11 @@ AnalysisWindow::setupWindow()
 	default:
 		qDebug("[AnalysisWindow::setupWindow] Invalid window type: %d", windowType);
 	}
+
+	windowSum_ = 0.0;
+	for (double w : window_) {
+		windowSum_ += w;
+	}
 }
 
 } /* namespace GS */
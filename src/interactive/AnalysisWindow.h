@@ -18,6 +18,7 @@
 #ifndef ANALYSIS_WINDOW_H
 #define ANALYSIS_WINDOW_H
 
+#include <cstddef> /* std::size_t */
 #include <memory>
 #include <vector>
 
@@ -26,6 +27,8 @@
 
 #include <jack/jack.h>
 
+#include "Figure2DWidget.h"
+
 
 
 class QTimer;
@@ -61,6 +64,7 @@ private:
 	AnalysisWindow(AnalysisWindow&&) = delete;
 	AnalysisWindow& operator=(AnalysisWindow&&) = delete;
 
+	void updatePlotX(std::size_t size, double step);
 	void setupWindow();
 
 	std::unique_ptr<Ui::AnalysisWindow> ui_;
@@ -70,10 +74,13 @@ private:
 	QTimer* timer_;
 	State state_;
 	std::vector<jack_default_audio_sample_t> signal_;
-	std::vector<double> plotX_;
-	std::vector<double> plotY_;
+	Lab::Figure2DSeries::Buffer plotX_;
+	double plotXStep_;
+	std::shared_ptr<std::vector<float>> plotY_[2]; // alternated, the buffer of the displayed series is not modified
+	unsigned int plotYIndex_;
 	std::unique_ptr<SignalDFT> signalDFT_;
 	std::vector<double> window_;
+	double windowSum_;
 };
 
 } /* namespace GS */
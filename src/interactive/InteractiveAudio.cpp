@@ -29,6 +29,7 @@
 #include "JackConfig.h"
 #include "Log.h"
 #include "InteractiveVTMConfiguration.h"
+#include "Trace.h"
 #include "VocalTractModelParameterValue.h"
 #include "VTMUtil.h"
 
@@ -49,6 +50,7 @@ extern "C" {
 int
 interactive_jack_process_callback(jack_nframes_t nframes, void* arg)
 {
+	TraceSpan span("interactive_jack_process", "jack");
 	try {
 		InteractiveAudio::Processor* p = static_cast<InteractiveAudio::Processor*>(arg);
 		return p->process(nframes);
@@ -21,28 +21,50 @@
 
 namespace GS {
 
-SignalDFT::SignalDFT(unsigned int n)
-		: n_(n)
-		, outputN_(n / 2 + 1)
-		, in_(nullptr)
-		, out_(nullptr)
+SignalDFT::Transform::Transform(unsigned int size)
+		: n(size)
+		, outputN(size / 2 + 1)
+		, in(nullptr)
+		, out(nullptr)
 {
-	in_ = FFTW::alloc_real<float>(n_ * sizeof(float));
-	out_ = FFTW::alloc_complex<float>(outputN_ * sizeof(fftwf_complex));
+	in = FFTW::alloc_real<float>(n);
+	out = FFTW::alloc_complex<float>(outputN);
 	{
 		FFTW fftw;
-		dftPlan_ = fftw.plan_dft_r2c_1d(n_, in_, out_, FFTW_ESTIMATE);
+		dftPlan = fftw.plan_dft_r2c_1d(n, in, out, FFTW_ESTIMATE);
 	}
 }
 
-SignalDFT::~SignalDFT()
+SignalDFT::Transform::~Transform()
 {
 	{
 		FFTW fftw;
-		fftw.destroy_plan(dftPlan_);
+		fftw.destroy_plan(dftPlan);
+	}
+	FFTW::free(out);
+	FFTW::free(in);
+}
+
+SignalDFT::SignalDFT(unsigned int n)
+		: transform_(nullptr)
+{
+	setSize(n);
+}
+
+SignalDFT::~SignalDFT()
+{
+}
+
+void
+SignalDFT::setSize(unsigned int n)
+{
+	if (transform_ && transform_->n == n) return;
+
+	std::unique_ptr<Transform>& transform = transformMap_[n];
+	if (!transform) {
+		transform = std::make_unique<Transform>(n);
 	}
-	FFTW::free(out_);
-	FFTW::free(in_);
+	transform_ = transform.get();
 }
 
 } /* namespace GS */
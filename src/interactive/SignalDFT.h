@@ -19,6 +19,9 @@
 #define SIGNAL_DFT_H
 
 #include <cmath>
+#include <cstddef> /* std::size_t */
+#include <map>
+#include <memory>
 
 #include "FFTW.h"
 
@@ -26,43 +29,93 @@
 
 namespace GS {
 
+// The plans and the buffers are cached by transform size, so the size can
+// be changed without creating new plans.
 class SignalDFT {
 public:
 	// size is expected to be a power of two.
 	explicit SignalDFT(unsigned int n);
 	~SignalDFT();
 
+	// Selects the transform size. n is expected to be a power of two.
+	void setSize(unsigned int n);
+
 	// Returns the absolute value of the spectrum.
 	// input must point to an array of size n (or bigger).
 	// output must point to an array of size n/2 + 1 (or bigger).
 	template<typename T, typename U> void execute(const T* input, U* output);
+	// Multiplies the input by the window and pads it with zeros.
+	// input and window must point to arrays of size inputSize (inputSize <= n).
+	// output must point to an array of size n/2 + 1 (or bigger).
+	template<typename T, typename W, typename U> void execute(const T* input, const W* window,
+									unsigned int inputSize, U* output);
 
-	unsigned int size() const { return n_; }
-	unsigned int outputSize() const { return outputN_; }
+	unsigned int size() const { return transform_->n; }
+	unsigned int outputSize() const { return transform_->outputN; }
+	std::size_t numberOfCachedPlans() const { return transformMap_.size(); }
 private:
+	struct Transform {
+		unsigned int n;
+		unsigned int outputN;
+		float* in;
+		fftwf_complex* out;
+		FFTWPlan dftPlan;
+
+		explicit Transform(unsigned int size);
+		~Transform();
+		Transform(const Transform&) = delete;
+		Transform& operator=(const Transform&) = delete;
+		Transform(Transform&&) = delete;
+		Transform& operator=(Transform&&) = delete;
+	};
+
 	SignalDFT(const SignalDFT&) = delete;
 	SignalDFT& operator=(const SignalDFT&) = delete;
 	SignalDFT(SignalDFT&&) = delete;
 	SignalDFT& operator=(SignalDFT&&) = delete;
 
-	unsigned int n_;
-	unsigned int outputN_;
-	float* in_;
-	fftwf_complex* out_;
-	FFTWPlan dftPlan_;
+	template<typename U> void calcAbsSpectrum(U* output);
+
+	std::map<unsigned int, std::unique_ptr<Transform>> transformMap_;
+	Transform* transform_; // current
 };
 
 template<typename T, typename U>
 void
 SignalDFT::execute(const T* input, U* output)
 {
-	for (unsigned int i = 0; i < n_; ++i) {
-		in_[i] = input[i];
+	float* in = transform_->in;
+	for (unsigned int i = 0, n = transform_->n; i < n; ++i) {
+		in[i] = input[i];
 	}
-	FFTW::execute(dftPlan_);
-	for (unsigned int i = 0; i < outputN_; ++i) {
-		const U rVal = out_[i][FFTW::REAL];
-		const U iVal = out_[i][FFTW::IMAG];
+	calcAbsSpectrum(output);
+}
+
+template<typename T, typename W, typename U>
+void
+SignalDFT::execute(const T* input, const W* window, unsigned int inputSize, U* output)
+{
+	float* in = transform_->in;
+	const unsigned int n = transform_->n;
+	if (inputSize > n) inputSize = n;
+	for (unsigned int i = 0; i < inputSize; ++i) {
+		in[i] = input[i] * window[i];
+	}
+	for (unsigned int i = inputSize; i < n; ++i) { // padding
+		in[i] = 0.0f;
+	}
+	calcAbsSpectrum(output);
+}
+
+template<typename U>
+void
+SignalDFT::calcAbsSpectrum(U* output)
+{
+	FFTW::execute(transform_->dftPlan);
+	const fftwf_complex* out = transform_->out;
+	for (unsigned int i = 0, size = transform_->outputN; i < size; ++i) {
+		const U rVal = out[i][FFTW::REAL];
+		const U iVal = out[i][FFTW::IMAG];
 		output[i] = std::sqrt(rVal * rVal + iVal * iVal);
 	}
 }
@@ -27,6 +27,7 @@
 
 #include "Log.h"
 #include "MainWindow.h"
+#include "Trace.h"
 
 
 
@@ -51,10 +52,15 @@ main(int argc, char* argv[])
 		QLocale::setDefault(QLocale::c());
 		std::locale::global(std::locale::classic());
 
+		GS::Trace::startFromEnvironment();
+		GS::Trace::setThreadName("gui");
+
 		GS::MainWindow w;
 		w.show();
 		app.exec();
 
+		GS::Trace::stop();
+
 		return EXIT_SUCCESS;
 
 	} catch (std::exception& e) {